@@ -0,0 +1,79 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "skutils/containers/concurrent_hash_map.h"
+
+using namespace sk::utils::dts;
+
+constexpr int OPS = 1 << 21;
+
+// 参数: 线程数, key 的个数. key 少 = 热点 key 上的高竞争
+template <typename Fn>
+static void RunThreads(int threads, int keys, Fn&& add) {
+  std::vector<std::thread> ts;
+  for (int t = 0; t < threads; t++) {
+    ts.emplace_back([&, t] {
+      std::uint64_t x = t + 1;
+      for (int i = 0; i < OPS / threads; i++) {
+        x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+        add(static_cast<int>((x >> 33) % keys));
+      }
+    });
+  }
+  for (auto& t : ts) {
+    t.join();
+  }
+}
+
+// 基线: 一把锁保护一个 unordered_map
+static void BM_MutexMap(benchmark::State& state) {
+  for (auto _ : state) {
+    std::mutex mtx;
+    std::unordered_map<int, long long> m;
+    RunThreads(state.range(0), state.range(1), [&](int k) {
+      std::lock_guard<std::mutex> lock(mtx);
+      m[k]++;
+    });
+    benchmark::DoNotOptimize(m.size());
+  }
+  state.SetItemsProcessed(state.iterations() * OPS);
+}
+
+static void BM_ConcurrentHashMap(benchmark::State& state) {
+  for (auto _ : state) {
+    concurrent_hash_map<int, long long> m;
+    RunThreads(state.range(0), state.range(1), [&](int k) { m.upsert(k, [](long long& v) { v++; }); });
+    benchmark::DoNotOptimize(m.size());
+  }
+  state.SetItemsProcessed(state.iterations() * OPS);
+}
+
+// 计入最后 merged() 的开销
+static void BM_HashAccumulator(benchmark::State& state) {
+  for (auto _ : state) {
+    concurrent_hash_accumulator<int, long long> acc;
+    RunThreads(state.range(0), state.range(1), [&](int k) { acc.add(k, 1LL); });
+    benchmark::DoNotOptimize(acc.merged().size());
+  }
+  state.SetItemsProcessed(state.iterations() * OPS);
+}
+
+static void ContentionArgs(benchmark::internal::Benchmark* b) {
+  for (int threads : {1, 4, 16}) {
+    for (int keys : {64, 1 << 20}) {
+      b->Args({threads, keys});
+    }
+  }
+  b->Unit(benchmark::kMillisecond)->UseRealTime();
+}
+
+BENCHMARK(BM_MutexMap)->Apply(ContentionArgs);
+BENCHMARK(BM_ConcurrentHashMap)->Apply(ContentionArgs);
+BENCHMARK(BM_HashAccumulator)->Apply(ContentionArgs);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,123 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "skutils/containers/flat_hash_map.h"
+
+using sk::utils::dts::flat_hash_map;
+
+template <typename K>
+K MakeKey(std::uint64_t x);
+
+template <>
+int MakeKey<int>(std::uint64_t x) {
+  return static_cast<int>(x);
+}
+
+// 长度 > SSO 的 key, 比较与哈希都要走堆内存
+template <>
+std::string MakeKey<std::string>(std::uint64_t x) {
+  return "moderntools/release/" + std::to_string(x);
+}
+
+// 乱序的 n 个不同 key, 以及另外 n 个一定查不到的 key
+template <typename K>
+static const std::vector<K>& Keys(int n, bool miss = false) {
+  static std::vector<K> keys[2];
+  auto& out = keys[miss];
+  if (static_cast<int>(out.size()) != n) {
+    out.resize(n);
+    for (int i = 0; i < n; i++) {
+      std::uint64_t x = static_cast<std::uint64_t>(i) * 2 + miss;
+      out[i] = MakeKey<K>((x * 0x9E3779B97F4A7C15ULL) >> 20);
+    }
+  }
+  return out;
+}
+
+template <typename Map>
+static void BM_Insert(benchmark::State& state) {
+  const auto& keys = Keys<typename Map::key_type>(state.range(0));
+  for (auto _ : state) {
+    Map m;
+    for (const auto& k : keys) {
+      m.emplace(k, 1);
+    }
+    benchmark::DoNotOptimize(m.size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Map>
+static void BM_FindHit(benchmark::State& state) {
+  const auto& keys = Keys<typename Map::key_type>(state.range(0));
+  Map m;
+  for (const auto& k : keys) {
+    m.emplace(k, 1);
+  }
+  for (auto _ : state) {
+    long long sum = 0;
+    for (const auto& k : keys) {
+      sum += m.find(k)->second;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+template <typename Map>
+static void BM_FindMiss(benchmark::State& state) {
+  const auto& keys = Keys<typename Map::key_type>(state.range(0));
+  const auto& misses = Keys<typename Map::key_type>(state.range(0), true);
+  Map m;
+  for (const auto& k : keys) {
+    m.emplace(k, 1);
+  }
+  for (auto _ : state) {
+    long long found = 0;
+    for (const auto& k : misses) {
+      found += m.find(k) != m.end();
+    }
+    benchmark::DoNotOptimize(found);
+  }
+  state.SetItemsProcessed(state.iterations() * misses.size());
+}
+
+template <typename Map>
+static void BM_Erase(benchmark::State& state) {
+  const auto& keys = Keys<typename Map::key_type>(state.range(0));
+  for (auto _ : state) {
+    state.PauseTiming();
+    Map m;
+    for (const auto& k : keys) {
+      m.emplace(k, 1);
+    }
+    state.ResumeTiming();
+    for (const auto& k : keys) {
+      m.erase(k);
+    }
+    benchmark::DoNotOptimize(m.size());
+  }
+  state.SetItemsProcessed(state.iterations() * keys.size());
+}
+
+using StdInt = std::unordered_map<int, int>;
+using FlatInt = flat_hash_map<int, int>;
+using StdStr = std::unordered_map<std::string, int>;
+using FlatStr = flat_hash_map<std::string, int>;
+
+#define SK_HASH_BENCH(fn, n)                                              \
+  BENCHMARK_TEMPLATE(fn, StdInt)->Arg(n)->Unit(benchmark::kMillisecond);  \
+  BENCHMARK_TEMPLATE(fn, FlatInt)->Arg(n)->Unit(benchmark::kMillisecond); \
+  BENCHMARK_TEMPLATE(fn, StdStr)->Arg(n)->Unit(benchmark::kMillisecond);  \
+  BENCHMARK_TEMPLATE(fn, FlatStr)->Arg(n)->Unit(benchmark::kMillisecond)
+
+SK_HASH_BENCH(BM_Insert, 1 << 20);
+SK_HASH_BENCH(BM_FindHit, 1 << 20);
+SK_HASH_BENCH(BM_FindMiss, 1 << 20);
+SK_HASH_BENCH(BM_Erase, 1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,251 @@
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <queue>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "skutils/containers/graph_algorithms.h"
+#include "skutils/containers/graph_generators.h"
+#include "skutils/random.h"
+
+#if __has_include(<boost/graph/adjacency_list.hpp>)
+#include <boost/graph/adjacency_list.hpp>
+#include <boost/graph/breadth_first_search.hpp>
+#include <boost/graph/connected_components.hpp>
+#include <boost/graph/dijkstra_shortest_paths.hpp>
+#define SK_BENCH_HAS_BGL 1
+#endif
+
+using sk::utils::dts::CsrGraph;
+
+static sk::utils::ThreadPool& Pool() {
+  static sk::utils::ThreadPool pool(std::max(1U, std::thread::hardware_concurrency()));
+  return pool;
+}
+
+// RMAT 图 (Graph500 参数), 2^scale 个点, 每点平均 16 条边, 权重 1..255
+static const CsrGraph<int>& Rmat(int scale) {
+  static std::map<int, CsrGraph<int>> cache;
+  auto it = cache.find(scale);
+  if (it != cache.end()) {
+    return it->second;
+  }
+  auto edges = sk::utils::dts::rmatEdges(scale, 16, scale, &Pool());
+  sk::utils::dts::randomizeWeights(edges, 1, 255, scale, &Pool());
+  return cache.emplace(scale, CsrGraph<int>::fromEdges(1 << scale, edges, false, &Pool())).first->second;
+}
+
+static sk::utils::ThreadPool* PoolArg(const benchmark::State& state) {
+  return state.range(1) ? &Pool() : nullptr;
+}
+
+static void BM_QueueBfs(benchmark::State& state) {
+  const auto& g = Rmat(state.range(0));
+  for (auto _ : state) {
+    std::vector<int> depth(g.size(), -1);
+    std::queue<int> q;
+    depth[0] = 0;
+    q.push(0);
+    while (!q.empty()) {
+      int u = q.front();
+      q.pop();
+      for (auto v : g.neighbors(u)) {
+        if (depth[v] < 0) {
+          depth[v] = depth[u] + 1;
+          q.push(v);
+        }
+      }
+    }
+    benchmark::DoNotOptimize(depth);
+  }
+  state.SetItemsProcessed(state.iterations() * g.edgeCount());
+}
+
+static void BM_Bfs(benchmark::State& state) {
+  const auto& g = Rmat(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sk::utils::dts::bfs(g, 0, PoolArg(state)));
+  }
+  state.SetItemsProcessed(state.iterations() * g.edgeCount());
+}
+
+static void BM_Dijkstra(benchmark::State& state) {
+  const auto& g = Rmat(state.range(0));
+  using Item = std::pair<std::int64_t, int>;
+  for (auto _ : state) {
+    std::vector<std::int64_t> dist(g.size(), sk::utils::dts::graphConst::infDistance);
+    std::priority_queue<Item, std::vector<Item>, std::greater<>> pq;
+    dist[0] = 0;
+    pq.push({0, 0});
+    while (!pq.empty()) {
+      auto [d, u] = pq.top();
+      pq.pop();
+      if (d != dist[u]) {
+        continue;
+      }
+      g.forEachNeighbor(u, [&](int v, int w) {
+        if (d + w < dist[v]) {
+          dist[v] = d + w;
+          pq.push({dist[v], v});
+        }
+      });
+    }
+    benchmark::DoNotOptimize(dist);
+  }
+  state.SetItemsProcessed(state.iterations() * g.edgeCount());
+}
+
+static void BM_DeltaStepping(benchmark::State& state) {
+  const auto& g = Rmat(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sk::utils::dts::deltaStepping(g, 0, PoolArg(state)));
+  }
+  state.SetItemsProcessed(state.iterations() * g.edgeCount());
+}
+
+static void BM_ConnectedComponents(benchmark::State& state) {
+  const auto& g = Rmat(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sk::utils::dts::connectedComponents(g, PoolArg(state)));
+  }
+  state.SetItemsProcessed(state.iterations() * g.edgeCount());
+}
+
+static void BM_PageRank(benchmark::State& state) {
+  const auto& g = Rmat(state.range(0));
+  for (auto _ : state) {
+    // 固定 20 轮, 便于比较
+    benchmark::DoNotOptimize(sk::utils::dts::pageRank(g, PoolArg(state), 0.85, 20, 0.0));
+  }
+  state.SetItemsProcessed(state.iterations() * g.edgeCount() * 20);
+}
+
+// range(0): scale, range(1): 是否使用线程池
+BENCHMARK(BM_QueueBfs)->Args({18, 0})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Bfs)->Args({18, 0})->Args({18, 1})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Dijkstra)->Args({18, 0})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_DeltaStepping)->Args({18, 0})->Args({18, 1})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ConnectedComponents)->Args({18, 0})->Args({18, 1})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PageRank)->Args({18, 0})->Args({18, 1})->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// 生成器吞吐: range(0) scale, range(1) 是否使用线程池
+static void BM_RmatEdges(benchmark::State& state) {
+  std::vector<sk::utils::dts::Edge> edges(size_t{16} << state.range(0));
+  for (auto _ : state) {
+    sk::utils::dts::fillRmatEdges(edges, state.range(0), 42, PoolArg(state));
+    benchmark::DoNotOptimize(edges.data());
+  }
+  state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+static void BM_ErdosRenyiEdges(benchmark::State& state) {
+  std::vector<sk::utils::dts::Edge> edges(size_t{16} << state.range(0));
+  for (auto _ : state) {
+    sk::utils::dts::fillErdosRenyiEdges(edges, 1 << state.range(0), 42, PoolArg(state));
+    benchmark::DoNotOptimize(edges.data());
+  }
+  state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+static void BM_BarabasiAlbertEdges(benchmark::State& state) {
+  std::vector<sk::utils::dts::Edge> edges(size_t{16} << state.range(0));
+  for (auto _ : state) {
+    sk::utils::dts::fillBarabasiAlbertEdges(edges, 16, 42, PoolArg(state));
+    benchmark::DoNotOptimize(edges.data());
+  }
+  state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+static void BM_CsrFromEdges(benchmark::State& state) {
+  auto edges = sk::utils::dts::rmatEdges(state.range(0), 16, 42, &Pool());
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(CsrGraph<int>::fromEdges(1 << state.range(0), edges, false, PoolArg(state)));
+  }
+  state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+// Graph 是 n*n 邻接矩阵, 只能跑很小的 n
+static void BM_BuildRandomGraphMatrix(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sk::utils::dts::buildRandomGraph(state.range(0)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 3);
+}
+
+static void BM_BuildRandomGraphCsr(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sk::utils::dts::buildRandomGraph<CsrGraph<int>>(state.range(0)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0) * 3);
+}
+
+BENCHMARK(BM_RmatEdges)->Args({22, 0})->Args({22, 1})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ErdosRenyiEdges)->Args({22, 0})->Args({22, 1})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BarabasiAlbertEdges)->Args({22, 0})->Args({22, 1})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_CsrFromEdges)->Args({20, 0})->Args({20, 1})->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BuildRandomGraphMatrix)->Arg(4096)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BuildRandomGraphCsr)->Arg(4096)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+#ifdef SK_BENCH_HAS_BGL
+// 同一张图的 boost::adjacency_list 版本, 作为对照 (example/boost/demo_boost_graph.cpp)
+using BglGraph = boost::adjacency_list<boost::vecS, boost::vecS, boost::undirectedS, boost::no_property,
+                                       boost::property<boost::edge_weight_t, int>>;
+
+static const BglGraph& Bgl(int scale) {
+  static std::map<int, BglGraph> cache;
+  auto it = cache.find(scale);
+  if (it != cache.end()) {
+    return it->second;
+  }
+  const auto& g = Rmat(scale);
+  BglGraph bg(g.size());
+  for (int u = 0; u < g.size(); ++u) {
+    g.forEachNeighbor(u, [&](int v, int w) {
+      if (v <= u) {
+        boost::add_edge(u, v, w, bg);
+      }
+    });
+  }
+  return cache.emplace(scale, std::move(bg)).first->second;
+}
+
+static void BM_BglBfs(benchmark::State& state) {
+  const auto& g = Bgl(state.range(0));
+  for (auto _ : state) {
+    std::vector<int> depth(boost::num_vertices(g), 0);
+    boost::breadth_first_search(
+      g, 0, boost::visitor(boost::make_bfs_visitor(boost::record_distances(depth.data(), boost::on_tree_edge()))));
+    benchmark::DoNotOptimize(depth);
+  }
+  state.SetItemsProcessed(state.iterations() * Rmat(state.range(0)).edgeCount());
+}
+
+static void BM_BglDijkstra(benchmark::State& state) {
+  const auto& g = Bgl(state.range(0));
+  for (auto _ : state) {
+    std::vector<std::int64_t> dist(boost::num_vertices(g));
+    boost::dijkstra_shortest_paths(g, 0, boost::distance_map(dist.data()));
+    benchmark::DoNotOptimize(dist);
+  }
+  state.SetItemsProcessed(state.iterations() * Rmat(state.range(0)).edgeCount());
+}
+
+static void BM_BglConnectedComponents(benchmark::State& state) {
+  const auto& g = Bgl(state.range(0));
+  for (auto _ : state) {
+    std::vector<int> comp(boost::num_vertices(g));
+    benchmark::DoNotOptimize(boost::connected_components(g, comp.data()));
+  }
+  state.SetItemsProcessed(state.iterations() * Rmat(state.range(0)).edgeCount());
+}
+
+BENCHMARK(BM_BglBfs)->Args({18, 0})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BglDijkstra)->Args({18, 0})->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_BglConnectedComponents)->Args({18, 0})->Unit(benchmark::kMillisecond);
+#endif
+
+BENCHMARK_MAIN();
@@ -0,0 +1,141 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <vector>
+
+#include "skutils/containers/heap.h"
+#include "skutils/random.h"
+
+namespace dts = sk::utils::dts;
+
+// 先全部 push 再全部 pop
+static void BM_PriorityQueuePushPop(benchmark::State& state) {
+  auto vals = RANDTOOL.getRandomIntVector(state.range(0), 0, INT32_MAX);
+  for (auto _ : state) {
+    std::priority_queue<int, std::vector<int>, std::greater<int>> pq;
+    for (auto v : vals) {
+      pq.push(v);
+    }
+    while (!pq.empty()) {
+      benchmark::DoNotOptimize(pq.top());
+      pq.pop();
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+template <size_t Arity>
+static void BM_HeapPushPop(benchmark::State& state) {
+  auto vals = RANDTOOL.getRandomIntVector(state.range(0), 0, INT32_MAX);
+  for (auto _ : state) {
+    dts::Heap<int, std::greater<int>, Arity> heap;
+    for (auto v : vals) {
+      heap.push(v);
+    }
+    while (!heap.empty()) {
+      benchmark::DoNotOptimize(heap.pop());
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// 在随机图上跑 Dijkstra: priority_queue 懒删除 vs IndexedHeap::decrease_key
+struct Edge {
+  int to;
+  int w;
+};
+
+static std::vector<std::vector<Edge>> MakeGraph(int n, int degree) {
+  std::vector<std::vector<Edge>> g(n);
+  for (int u = 0; u < n; ++u) {
+    for (int i = 0; i < degree; ++i) {
+      g[u].push_back({RANDTOOL.getRandomInt(0, n - 1), RANDTOOL.getRandomInt(1, 1000)});
+    }
+  }
+  return g;
+}
+
+static void BM_DijkstraPriorityQueue(benchmark::State& state) {
+  auto g = MakeGraph(state.range(0), 8);
+  for (auto _ : state) {
+    std::vector<long> dist(g.size(), INT64_MAX);
+    std::priority_queue<std::pair<long, int>, std::vector<std::pair<long, int>>, std::greater<>> pq;
+    dist[0] = 0;
+    pq.emplace(0, 0);
+    while (!pq.empty()) {
+      auto [d, u] = pq.top();
+      pq.pop();
+      if (d != dist[u]) {
+        continue;
+      }
+      for (auto e : g[u]) {
+        if (d + e.w < dist[e.to]) {
+          dist[e.to] = d + e.w;
+          pq.emplace(dist[e.to], e.to);
+        }
+      }
+    }
+    benchmark::DoNotOptimize(dist.data());
+  }
+}
+
+static void BM_DijkstraIndexedHeap(benchmark::State& state) {
+  using Heap = dts::IndexedHeap<std::pair<long, int>>;
+  auto g = MakeGraph(state.range(0), 8);
+  for (auto _ : state) {
+    std::vector<long> dist(g.size(), INT64_MAX);
+    std::vector<Heap::Handle> handle(g.size(), Heap::npos);
+    Heap heap;
+    dist[0] = 0;
+    handle[0] = heap.push({0, 0});
+    while (!heap.empty()) {
+      auto [d, u] = heap.pop();
+      handle[u] = Heap::npos;
+      for (auto e : g[u]) {
+        if (d + e.w < dist[e.to]) {
+          dist[e.to] = d + e.w;
+          if (handle[e.to] != Heap::npos) {
+            heap.decrease_key(handle[e.to], {dist[e.to], e.to});
+          } else {
+            handle[e.to] = heap.push({dist[e.to], e.to});
+          }
+        }
+      }
+    }
+    benchmark::DoNotOptimize(dist.data());
+  }
+}
+
+static void BM_StdSortHeap(benchmark::State& state) {
+  auto vals = RANDTOOL.getRandomIntVector(state.range(0), 0, INT32_MAX);
+  for (auto _ : state) {
+    auto vc = vals;
+    std::make_heap(vc.begin(), vc.end());
+    std::sort_heap(vc.begin(), vc.end());
+    benchmark::DoNotOptimize(vc.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_HeapSort(benchmark::State& state) {
+  auto vals = RANDTOOL.getRandomIntVector(state.range(0), 0, INT32_MAX);
+  for (auto _ : state) {
+    auto vc = vals;
+    dts::Heap<int>::sort(vc);
+    benchmark::DoNotOptimize(vc.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_PriorityQueuePushPop)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_HeapPushPop, 2)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_HeapPushPop, 4)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK_TEMPLATE(BM_HeapPushPop, 8)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_DijkstraPriorityQueue)->Arg(1 << 16);
+BENCHMARK(BM_DijkstraIndexedHeap)->Arg(1 << 16);
+BENCHMARK(BM_StdSortHeap)->Arg(1 << 20);
+BENCHMARK(BM_HeapSort)->Arg(1 << 20);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,93 @@
+#include <benchmark/benchmark.h>
+
+#include <optional>
+#include <vector>
+
+#include "skutils/containers/lc.h"
+
+using namespace sk::utils::dts::lc;
+
+static const std::vector<int>& Values(int n) {
+  static std::vector<int> vals;
+  if (static_cast<int>(vals.size()) != n) {
+    vals.resize(n);
+    for (int i = 0; i < n; i++) {
+      vals[i] = i;
+    }
+  }
+  return vals;
+}
+
+// 完全二叉树的层序表示
+static const std::vector<std::optional<int>>& Levels(int n) {
+  static std::vector<std::optional<int>> vals;
+  if (static_cast<int>(vals.size()) != n) {
+    vals.assign(n, std::nullopt);
+    for (int i = 0; i < n; i++) {
+      vals[i] = i;
+    }
+  }
+  return vals;
+}
+
+// 构造 + 遍历 + 释放
+static void BM_HeapList(benchmark::State& state) {
+  const auto& vals = Values(state.range(0));
+  for (auto _ : state) {
+    auto* head = vector2List(vals);
+    long long sum = 0;
+    for (auto* p = head; p != nullptr; p = p->next) {
+      sum += p->val;
+    }
+    benchmark::DoNotOptimize(sum);
+    delete head;
+  }
+  state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+static void BM_PoolList(benchmark::State& state) {
+  const auto& vals = Values(state.range(0));
+  NodePool pool;
+  for (auto _ : state) {
+    auto* head = vector2List(vals, pool);
+    long long sum = 0;
+    for (auto* p = head; p != nullptr; p = p->next) {
+      sum += p->val;
+    }
+    benchmark::DoNotOptimize(sum);
+    pool.reset();
+  }
+  state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+static void BM_HeapTree(benchmark::State& state) {
+  const auto& vals = Levels(state.range(0));
+  for (auto _ : state) {
+    auto* root = vector2Tree(vals);
+    long long sum = 0;
+    inorderTraverse(root, [&](TreeNode* node) { sum += node->val; });
+    benchmark::DoNotOptimize(sum);
+    delete root;
+  }
+  state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+static void BM_PoolTree(benchmark::State& state) {
+  const auto& vals = Levels(state.range(0));
+  NodePool pool;
+  for (auto _ : state) {
+    auto* root = vector2Tree(vals, pool);
+    long long sum = 0;
+    inorderTraverse(root, [&](TreeNode* node) { sum += node->val; });
+    benchmark::DoNotOptimize(sum);
+    pool.reset();
+  }
+  state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+BENCHMARK(BM_HeapList)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PoolList)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_HeapTree)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_PoolTree)->Arg(1 << 20)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+#include "skutils/containers/lru_cache.h"
+
+using namespace sk::utils::dts;
+
+constexpr int KEYS = 1 << 20;
+constexpr int CAPACITY = 1 << 14;
+
+// 访问序列: 对数均匀分布的热点 key, 每 8 次访问混入一段不会重复的顺序扫描
+static const std::vector<int>& Trace() {
+  static std::vector<int> trace;
+  if (trace.empty()) {
+    trace.resize(1 << 21);
+    std::uint64_t x = 1;
+    int scan = KEYS;
+    for (auto& k : trace) {
+      x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+      double u = static_cast<double>(x >> 11) / static_cast<double>(1ULL << 53);
+      k = (x & 7) == 0 ? scan++ : static_cast<int>(std::pow(static_cast<double>(KEYS), u)) - 1;
+    }
+  }
+  return trace;
+}
+
+// 基线: std::list + std::unordered_map 的教科书 LRU
+class ListLru {
+  public:
+  explicit ListLru(size_t cap) : cap_(cap) {}
+
+  const int* get(int k) {
+    auto it = pos_.find(k);
+    if (it == pos_.end()) {
+      return nullptr;
+    }
+    order_.splice(order_.begin(), order_, it->second);
+    return &it->second->second;
+  }
+
+  void put(int k, int v) {
+    order_.emplace_front(k, v);
+    pos_[k] = order_.begin();
+    if (order_.size() > cap_) {
+      pos_.erase(order_.back().first);
+      order_.pop_back();
+    }
+  }
+
+  private:
+  size_t cap_;
+  std::list<std::pair<int, int>> order_;
+  std::unordered_map<int, std::list<std::pair<int, int>>::iterator> pos_;
+};
+
+template <typename Cache>
+static void BM_CacheTrace(benchmark::State& state) {
+  const auto& trace = Trace();
+  double hits = 0;
+  for (auto _ : state) {
+    Cache cache(CAPACITY);
+    size_t hit = 0;
+    for (int k : trace) {
+      if (cache.get(k)) {
+        hit++;
+      } else {
+        cache.put(k, k);
+      }
+    }
+    hits = static_cast<double>(hit) / trace.size();
+  }
+  state.counters["hit_rate"] = hits;
+  state.SetItemsProcessed(state.iterations() * trace.size());
+}
+
+BENCHMARK_TEMPLATE(BM_CacheTrace, ListLru)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CacheTrace, LruCache<int, int>)->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_CacheTrace, ArcCache<int, int>)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
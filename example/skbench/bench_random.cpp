@@ -0,0 +1,101 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "skutils/random.h"
+#include "skutils/threadpool.h"
+
+// 逐元素 mt19937 + distribution, 作为对照组
+static void BM_Mt19937IntVector(benchmark::State& state) {
+  std::mt19937 gen(42);
+  std::uniform_int_distribution<int> dist(0, 1000);
+  std::vector<int> out(state.range(0));
+  for (auto _ : state) {
+    for (auto& v : out) {
+      v = dist(gen);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_FillInt(benchmark::State& state) {
+  std::vector<int> out(state.range(0));
+  for (auto _ : state) {
+    RANDTOOL.fill(out, 0, 1000);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_Mt19937DoubleVector(benchmark::State& state) {
+  std::mt19937 gen(42);
+  std::uniform_real_distribution<double> dist(0.0, 1.0);
+  std::vector<double> out(state.range(0));
+  for (auto _ : state) {
+    for (auto& v : out) {
+      v = dist(gen);
+    }
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_FillDouble(benchmark::State& state) {
+  std::vector<double> out(state.range(0));
+  for (auto _ : state) {
+    RANDTOOL.fill(out, 0.0, 1.0);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_FillDoubleSeededParallel(benchmark::State& state) {
+  sk::utils::ThreadPool pool(std::thread::hardware_concurrency());
+  std::vector<double> out(state.range(0));
+  for (auto _ : state) {
+    RANDTOOL.fill(out, 0.0, 1.0, 42, &pool);
+    benchmark::DoNotOptimize(out.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// 逐字符取下标, 与之前的 getRandomString 一致
+static void BM_PerCharString(benchmark::State& state) {
+  const std::string charset = CHARSET_UPPER + CHARSET_LOWER + CHARSET_NUMBER;
+  for (auto _ : state) {
+    std::string ret;
+    for (int64_t i = 0; i < state.range(0); ++i) {
+      ret += charset[RANDTOOL.getRandomInt(0, static_cast<int>(charset.size()) - 1)];
+    }
+    benchmark::DoNotOptimize(ret);
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_GetRandomString(benchmark::State& state) {
+  const std::string charset = CHARSET_UPPER + CHARSET_LOWER + CHARSET_NUMBER;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(RANDTOOL.getRandomString(state.range(0), charset));
+  }
+  state.SetBytesProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_GetRandomName(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(RANDTOOL.getRandomName());
+  }
+}
+
+BENCHMARK(BM_Mt19937IntVector)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_FillInt)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_Mt19937DoubleVector)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_FillDouble)->Arg(1 << 10)->Arg(1 << 20);
+BENCHMARK(BM_FillDoubleSeededParallel)->Arg(1 << 22);
+BENCHMARK(BM_PerCharString)->Arg(16)->Arg(1 << 12);
+BENCHMARK(BM_GetRandomString)->Arg(16)->Arg(1 << 12);
+BENCHMARK(BM_GetRandomName);
+
+BENCHMARK_MAIN();
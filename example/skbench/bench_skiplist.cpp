@@ -0,0 +1,245 @@
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+
+#include "skutils/containers/concurrent_skiplist.h"
+#include "skutils/containers/skiplist.h"
+#include "skutils/random.h"
+
+using sk::utils::dts::ConcurrentSkipList;
+
+constexpr int KEY_RANGE = 1 << 18;
+
+// 读写锁保护的 std::map, 作为对照组
+class LockedMap {
+  public:
+  bool insert(int k, int v) {
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+    return mp_.emplace(k, v).second;
+  }
+
+  bool erase(int k) {
+    std::unique_lock<std::shared_mutex> lock(mtx_);
+    return mp_.erase(k) == 1;
+  }
+
+  bool contains(int k) const {
+    std::shared_lock<std::shared_mutex> lock(mtx_);
+    return mp_.count(k) == 1;
+  }
+
+  private:
+  mutable std::shared_mutex mtx_;
+  std::map<int, int> mp_;
+};
+
+// 混合负载: 读占 range(0)%, 其余写操作一半插入一半删除
+template <typename Map>
+static void MixedWorkload(benchmark::State& state) {
+  static std::unique_ptr<Map> mp;
+  if (state.thread_index() == 0) {
+    mp = std::make_unique<Map>();
+    for (int i = 0; i < KEY_RANGE; i += 2) {
+      mp->insert(i, i);
+    }
+  }
+  const auto readPercent = static_cast<int>(state.range(0));
+  std::vector<int> keys(1 << 12);
+  RANDTOOL.fill(keys, 0, KEY_RANGE - 1);
+  std::vector<int> ops(keys.size());
+  RANDTOOL.fill(ops, 0, 99);
+  size_t i = 0;
+  for (auto _ : state) {
+    auto k = keys[i & (keys.size() - 1)];
+    auto op = ops[i & (ops.size() - 1)];
+    ++i;
+    if (op < readPercent) {
+      benchmark::DoNotOptimize(mp->contains(k));
+    } else if ((op & 1) == 0) {
+      benchmark::DoNotOptimize(mp->insert(k, k));
+    } else {
+      benchmark::DoNotOptimize(mp->erase(k));
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  if (state.thread_index() == 0) {
+    mp.reset();
+  }
+}
+
+static void BM_LockedMapMixed(benchmark::State& state) {
+  MixedWorkload<LockedMap>(state);
+}
+
+static void BM_ConcurrentSkipListMixed(benchmark::State& state) {
+  MixedWorkload<ConcurrentSkipList<int, int>>(state);
+}
+
+template <typename Map>
+static void FillMap(Map& mp, int n) {
+  std::vector<int> keys(n);
+  RANDTOOL.fill(keys, 0, INT32_MAX);
+  for (auto k : keys) {
+    mp.insert({k, k});
+  }
+}
+
+static void BM_StdMapFind(benchmark::State& state) {
+  std::map<int, int> mp;
+  FillMap(mp, state.range(0));
+  auto keys = RANDTOOL.getRandomIntVector(1 << 12, 0, INT32_MAX);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(mp.find(keys[i++ & (keys.size() - 1)]));
+  }
+}
+
+static void BM_SkipListFind(benchmark::State& state) {
+  sk::utils::dts::SkipList<int, int> sl;
+  std::vector<int> keys(state.range(0));
+  RANDTOOL.fill(keys, 0, INT32_MAX);
+  for (auto k : keys) {
+    sl.insert(k, k);
+  }
+  keys = RANDTOOL.getRandomIntVector(1 << 12, 0, INT32_MAX);
+  size_t i = 0;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sl.find(keys[i++ & (keys.size() - 1)]));
+  }
+}
+
+// 从随机起点开始顺序扫描 range(1) 个元素
+static void BM_StdMapScan(benchmark::State& state) {
+  std::map<int, int> mp;
+  FillMap(mp, state.range(0));
+  auto keys = RANDTOOL.getRandomIntVector(1 << 12, 0, INT32_MAX);
+  size_t i = 0;
+  for (auto _ : state) {
+    long sum = 0;
+    auto it = mp.lower_bound(keys[i++ & (keys.size() - 1)]);
+    for (int n = 0; n < state.range(1) && it != mp.end(); ++n, ++it) {
+      sum += it->second;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+
+static void BM_SkipListScan(benchmark::State& state) {
+  sk::utils::dts::SkipList<int, int> sl;
+  std::vector<int> keys(state.range(0));
+  RANDTOOL.fill(keys, 0, INT32_MAX);
+  for (auto k : keys) {
+    sl.insert(k, k);
+  }
+  keys = RANDTOOL.getRandomIntVector(1 << 12, 0, INT32_MAX);
+  size_t i = 0;
+  for (auto _ : state) {
+    long sum = 0;
+    auto it = sl.lower_bound(keys[i++ & (keys.size() - 1)]);
+    for (int n = 0; n < state.range(1) && it != sl.end(); ++n, ++it) {
+      sum += it->val;
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+}
+
+static void BM_SkipListInsertSorted(benchmark::State& state) {
+  for (auto _ : state) {
+    sk::utils::dts::SkipList<int, int> sl;
+    for (int i = 0; i < state.range(0); ++i) {
+      sl.insert(i, i);
+    }
+    benchmark::DoNotOptimize(sl.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_SkipListBulkLoad(benchmark::State& state) {
+  std::vector<std::pair<int, int>> items(state.range(0));
+  for (int i = 0; i < state.range(0); ++i) {
+    items[i] = {i, i};
+  }
+  for (auto _ : state) {
+    sk::utils::dts::SkipList<int, int> sl;
+    sl.bulk_load(items);
+    benchmark::DoNotOptimize(sl.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_SkipListInsertRandom(benchmark::State& state) {
+  std::vector<int> keys(state.range(0));
+  RANDTOOL.fill(keys, 0, INT32_MAX);
+  for (auto _ : state) {
+    sk::utils::dts::SkipList<int, int> sl;
+    for (auto k : keys) {
+      sl.insert(k, k);
+    }
+    benchmark::DoNotOptimize(sl.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_SkipListInsertBatch(benchmark::State& state) {
+  std::vector<int> keys(state.range(0));
+  RANDTOOL.fill(keys, 0, INT32_MAX);
+  std::vector<std::pair<int, int>> items;
+  for (auto k : keys) {
+    items.emplace_back(k, k);
+  }
+  for (auto _ : state) {
+    sk::utils::dts::SkipList<int, int> sl;
+    sl.insert_batch(items);
+    benchmark::DoNotOptimize(sl.size());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+// 在 1M 元素的表中查找 range(0) 个随机 key
+static void BM_SkipListFindLoop(benchmark::State& state) {
+  sk::utils::dts::SkipList<int, int> sl;
+  std::vector<int> keys(1 << 20);
+  RANDTOOL.fill(keys, 0, INT32_MAX);
+  for (auto k : keys) {
+    sl.insert(k, k);
+  }
+  auto queries = RANDTOOL.getRandomIntVector(state.range(0), 0, INT32_MAX);
+  for (auto _ : state) {
+    for (auto q : queries) {
+      benchmark::DoNotOptimize(sl.find(q));
+    }
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+static void BM_SkipListFindBatch(benchmark::State& state) {
+  sk::utils::dts::SkipList<int, int> sl;
+  std::vector<int> keys(1 << 20);
+  RANDTOOL.fill(keys, 0, INT32_MAX);
+  for (auto k : keys) {
+    sl.insert(k, k);
+  }
+  auto queries = RANDTOOL.getRandomIntVector(state.range(0), 0, INT32_MAX);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(sl.find_batch(queries));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+
+BENCHMARK(BM_SkipListInsertSorted)->Arg(1 << 20);
+BENCHMARK(BM_SkipListBulkLoad)->Arg(1 << 20);
+BENCHMARK(BM_SkipListInsertRandom)->Arg(1 << 20);
+BENCHMARK(BM_SkipListInsertBatch)->Arg(1 << 20);
+BENCHMARK(BM_SkipListFindLoop)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_SkipListFindBatch)->Arg(1 << 10)->Arg(1 << 16);
+BENCHMARK(BM_StdMapFind)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(BM_SkipListFind)->Arg(1 << 16)->Arg(1 << 20);
+BENCHMARK(BM_StdMapScan)->Args({1 << 20, 100});
+BENCHMARK(BM_SkipListScan)->Args({1 << 20, 100});
+BENCHMARK(BM_LockedMapMixed)->Arg(90)->Arg(50)->ThreadRange(1, 16)->UseRealTime();
+BENCHMARK(BM_ConcurrentSkipListMixed)->Arg(90)->Arg(50)->ThreadRange(1, 16)->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,135 @@
+#include <benchmark/benchmark.h>
+
+#include <regex>
+#include <string>
+
+#include "skutils/random.h"
+#include "skutils/string_search.h"
+#include "skutils/string_utils.h"
+
+namespace str = sk::utils::str;
+
+// 与 replace_all/trim 引入之前的实现保持一致，作为对照组
+std::string LegacyReplace(const std::string& s, const std::string& pattern, const std::string& replacer) {
+  std::regex re(pattern);
+  return std::regex_replace(s, re, replacer);
+}
+
+std::string LegacyTrim(const std::string& s, const std::string& trimer = " ") {
+  return LegacyReplace(s, trimer, "");
+}
+
+std::string MakeInput(size_t len) {
+  auto s = RANDTOOL.getRandomString(len, CHARSET_LOWER + "  ,/");
+  return "  " + s + "  ";
+}
+
+static void BM_LegacyReplace(benchmark::State& state) {
+  auto input = MakeInput(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(LegacyReplace(input, ",", ";"));
+  }
+}
+
+static void BM_ReplaceRegexCached(benchmark::State& state) {
+  auto input = MakeInput(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(str::replace_regex(input, ",", ";"));
+  }
+}
+
+static void BM_ReplaceAll(benchmark::State& state) {
+  auto input = MakeInput(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(str::replace_all(input, ",", ";"));
+  }
+}
+
+static void BM_LegacyTrim(benchmark::State& state) {
+  auto input = MakeInput(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(LegacyTrim(input));
+  }
+}
+
+static void BM_Trim(benchmark::State& state) {
+  auto input = MakeInput(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(str::trim(input));
+  }
+}
+
+static void BM_Split(benchmark::State& state) {
+  auto input = MakeInput(state.range(0));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(str::split(input, '/'));
+  }
+}
+
+static void BM_SplitView(benchmark::State& state) {
+  auto input = MakeInput(state.range(0));
+  for (auto _ : state) {
+    size_t n = 0;
+    for (auto token : str::split_view(input, '/')) {
+      n += token.length();
+    }
+    benchmark::DoNotOptimize(n);
+  }
+}
+
+static void BM_StdFind(benchmark::State& state) {
+  auto input = RANDTOOL.getRandomString(state.range(0), CHARSET_LOWER) + "needle";
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(std::string_view(input).find("needle"));
+  }
+}
+
+static void BM_SimdFind(benchmark::State& state) {
+  auto input = RANDTOOL.getRandomString(state.range(0), CHARSET_LOWER) + "needle";
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(str::find(input, "needle"));
+  }
+}
+
+static void BM_SimdIFind(benchmark::State& state) {
+  auto input = RANDTOOL.getRandomString(state.range(0), CHARSET_LOWER) + "NeEdLe";
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(str::ifind(input, "needle"));
+  }
+}
+
+const std::vector<std::string> kKeywords{"error", "warn", "fatal", "panic", "timeout", "refused", "denied", "abort"};
+
+static void BM_FindEachKeyword(benchmark::State& state) {
+  auto input = RANDTOOL.getRandomString(state.range(0), CHARSET_LOWER);
+  for (auto _ : state) {
+    bool hit = false;
+    for (const auto& k : kKeywords) {
+      hit |= std::string_view(input).find(k) != std::string_view::npos;
+    }
+    benchmark::DoNotOptimize(hit);
+  }
+}
+
+static void BM_AhoCorasick(benchmark::State& state) {
+  auto input = RANDTOOL.getRandomString(state.range(0), CHARSET_LOWER);
+  str::AhoCorasick ac(kKeywords);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ac.contains(input));
+  }
+}
+
+BENCHMARK(BM_LegacyReplace)->Arg(32)->Arg(1024);
+BENCHMARK(BM_ReplaceRegexCached)->Arg(32)->Arg(1024);
+BENCHMARK(BM_ReplaceAll)->Arg(32)->Arg(1024);
+BENCHMARK(BM_LegacyTrim)->Arg(32)->Arg(1024);
+BENCHMARK(BM_Trim)->Arg(32)->Arg(1024);
+BENCHMARK(BM_Split)->Arg(32)->Arg(1024);
+BENCHMARK(BM_SplitView)->Arg(32)->Arg(1024);
+BENCHMARK(BM_StdFind)->Arg(1024)->Arg(1 << 16);
+BENCHMARK(BM_SimdFind)->Arg(1024)->Arg(1 << 16);
+BENCHMARK(BM_SimdIFind)->Arg(1024)->Arg(1 << 16);
+BENCHMARK(BM_FindEachKeyword)->Arg(1024)->Arg(1 << 16);
+BENCHMARK(BM_AhoCorasick)->Arg(1024)->Arg(1 << 16);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,141 @@
+#include <benchmark/benchmark.h>
+
+#include <functional>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "skutils/containers/topk_queue.h"
+#include "skutils/random.h"
+#include "skutils/spinlock.h"
+
+// 与分片之前的实现一致: 一把 SpinLock 保护一个 priority_queue, 作为对照组
+class LegacyTopK {
+  public:
+  explicit LegacyTopK(size_t cap) : cap_(cap) {}
+
+  void push(int val) {
+    sk::utils::SpinLockGuard guard{lock_};
+    if (pq_.size() < cap_) {
+      pq_.push(val);
+    } else if (val > pq_.top()) {
+      pq_.push(val);
+      pq_.pop();
+    }
+  }
+
+  size_t size() const { return pq_.size(); }
+
+  private:
+  size_t cap_;
+  std::priority_queue<int, std::vector<int>, std::greater<int>> pq_;
+  sk::utils::SpinLock lock_;
+};
+
+static const std::vector<int>& Values() {
+  static std::vector<int> vals = [] {
+    std::vector<int> v(10'000'000);
+    RANDTOOL.fill(v, 0, INT32_MAX, 42);
+    return v;
+  }();
+  return vals;
+}
+
+// range(0) 个线程各扫描 10M 中的一段, 求 top range(1)
+template <typename Queue>
+static void ScanTopK(benchmark::State& state) {
+  const auto& vals = Values();
+  const auto threads = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    Queue q(state.range(1));
+    std::vector<std::thread> ths;
+    for (size_t t = 0; t < threads; ++t) {
+      ths.emplace_back([&, t] {
+        auto begin = vals.size() * t / threads;
+        auto end = vals.size() * (t + 1) / threads;
+        for (auto i = begin; i < end; ++i) {
+          q.push(vals[i]);
+        }
+      });
+    }
+    for (auto& th : ths) {
+      th.join();
+    }
+    benchmark::DoNotOptimize(q);
+  }
+  state.SetItemsProcessed(state.iterations() * vals.size());
+}
+
+static void BM_LegacyTopK(benchmark::State& state) {
+  ScanTopK<LegacyTopK>(state);
+}
+
+static void BM_ShardedTopK(benchmark::State& state) {
+  ScanTopK<sk::utils::dts::topk_queue<int>>(state);
+}
+
+BENCHMARK(BM_LegacyTopK)
+  ->Args({1, 100})
+  ->Args({32, 100})
+  ->Args({32, 10000})
+  ->UseRealTime()
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ShardedTopK)
+  ->Args({1, 100})
+  ->Args({32, 100})
+  ->Args({32, 10000})
+  ->UseRealTime()
+  ->Unit(benchmark::kMillisecond);
+
+// 排序依据需要解析才能得到 (类似 ducpp 中每次比较都 stat 文件): 比较器每次比较都解析两侧,
+// key 投影每个元素只解析一次
+static const std::vector<std::string>& Records() {
+  static std::vector<std::string> recs = [] {
+    std::vector<std::string> v;
+    v.reserve(1'000'000);
+    for (int i = 0; i < 1'000'000; ++i) {
+      v.push_back("record-" + std::to_string(Values()[i]));
+    }
+    return v;
+  }();
+  return recs;
+}
+
+static long ParseRecord(const std::string& s) {
+  return std::stol(s.substr(s.find('-') + 1));
+}
+
+struct ParsingComp {
+  bool operator()(const std::string& a, const std::string& b) const { return ParseRecord(a) < ParseRecord(b); }
+};
+
+struct ParsingKey {
+  long operator()(const std::string& s) const { return ParseRecord(s); }
+};
+
+template <typename Queue>
+static void ScanRecords(benchmark::State& state) {
+  const auto& recs = Records();
+  for (auto _ : state) {
+    Queue q(state.range(0), 1);
+    for (const auto& r : recs) {
+      q.push(r);
+    }
+    benchmark::DoNotOptimize(q.pop());
+  }
+  state.SetItemsProcessed(state.iterations() * recs.size());
+}
+
+static void BM_ComparatorTopK(benchmark::State& state) {
+  ScanRecords<sk::utils::dts::topk_queue<std::string, std::identity, ParsingComp>>(state);
+}
+
+static void BM_ProjectedTopK(benchmark::State& state) {
+  ScanRecords<sk::utils::dts::topk_queue<std::string, ParsingKey>>(state);
+}
+
+BENCHMARK(BM_ComparatorTopK)->Arg(100)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ProjectedTopK)->Arg(100)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
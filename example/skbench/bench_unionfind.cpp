@@ -0,0 +1,163 @@
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <future>
+#include <numeric>
+#include <span>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "skutils/containers/graph_generators.h"
+#include "skutils/containers/unionfind_set.h"
+
+using sk::utils::dts::Edge;
+
+// 改写之前的实现: 递归完全压缩, 不按秩合并, 作为对照组
+class LegacyUnionFind {
+  public:
+  explicit LegacyUnionFind(int n) : parent_(n) { std::iota(parent_.begin(), parent_.end(), 0); }
+
+  int find(int a) {
+    if (parent_[a] != a) {
+      parent_[a] = find(parent_[a]);
+    }
+    return parent_[a];
+  }
+
+  void connect(int a, int b) {
+    int ra = find(a);
+    int rb = find(b);
+    if (ra != rb) {
+      parent_[rb] = ra;
+    }
+  }
+
+  private:
+  std::vector<int> parent_;
+};
+
+static sk::utils::ThreadPool& Pool() {
+  static sk::utils::ThreadPool pool(std::max(1U, std::thread::hardware_concurrency()));
+  return pool;
+}
+
+// 2^20 个点, 8M 条 RMAT 边
+static const std::vector<Edge>& Edges() {
+  static std::vector<Edge> edges = sk::utils::dts::rmatEdges(20, 8, 42, &Pool());
+  return edges;
+}
+
+static void BM_LegacyUnionFind(benchmark::State& state) {
+  const auto& edges = Edges();
+  for (auto _ : state) {
+    LegacyUnionFind uf(1 << 20);
+    for (const auto& e : edges) {
+      uf.connect(e.from, e.to);
+    }
+    benchmark::DoNotOptimize(uf);
+  }
+  state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+static void BM_UnionFindSet(benchmark::State& state) {
+  const auto& edges = Edges();
+  for (auto _ : state) {
+    sk::utils::dts::UnionFindSet<int> uf(1 << 20);
+    for (const auto& e : edges) {
+      uf.connect(e.from, e.to);
+    }
+    benchmark::DoNotOptimize(uf.count());
+  }
+  state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+// range(0): 线程数
+static void BM_ConcurrentUnionFindSet(benchmark::State& state) {
+  const auto& edges = Edges();
+  const auto threads = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    sk::utils::dts::ConcurrentUnionFindSet uf(1 << 20);
+    std::vector<std::future<void>> fus;
+    for (size_t t = 0; t < threads; t++) {
+      fus.emplace_back(Pool().submit([&, t] {
+        for (size_t i = t * edges.size() / threads; i < (t + 1) * edges.size() / threads; i++) {
+          uf.connect(edges[i].from, edges[i].to);
+        }
+      }));
+    }
+    for (auto& fu : fus) {
+      fu.get();
+    }
+    benchmark::DoNotOptimize(uf.count());
+  }
+  state.SetItemsProcessed(state.iterations() * edges.size());
+}
+
+// 去重规模: 2^26 个点上的 1 亿条 G(n, m) 边, 约 800MB
+constexpr int DEDUP_NODES = 1 << 26;
+
+static const std::vector<std::pair<int, int>>& DedupPairs() {
+  static std::vector<std::pair<int, int>> pairs = [] {
+    auto edges = sk::utils::dts::erdosRenyiEdges(DEDUP_NODES, 100'000'000, 7, &Pool());
+    std::vector<std::pair<int, int>> ret(edges.size());
+    std::transform(edges.begin(), edges.end(), ret.begin(), [](const Edge& e) { return std::pair{e.from, e.to}; });
+    return ret;
+  }();
+  return pairs;
+}
+
+// range(0): 是否使用线程池
+static void BM_ConnectBatch100M(benchmark::State& state) {
+  const auto& pairs = DedupPairs();
+  for (auto _ : state) {
+    sk::utils::dts::UnionFindSet<int> uf(DEDUP_NODES);
+    uf.connectBatch(pairs, state.range(0) ? &Pool() : nullptr);
+    benchmark::DoNotOptimize(uf.count());
+  }
+  state.SetItemsProcessed(state.iterations() * pairs.size());
+}
+
+static void BM_ConcurrentConnectBatch100M(benchmark::State& state) {
+  const auto& pairs = DedupPairs();
+  for (auto _ : state) {
+    sk::utils::dts::ConcurrentUnionFindSet uf(DEDUP_NODES);
+    benchmark::DoNotOptimize(uf.connectBatch(pairs, &Pool()));
+  }
+  state.SetItemsProcessed(state.iterations() * pairs.size());
+}
+
+static void BM_Components100M(benchmark::State& state) {
+  const auto& pairs = DedupPairs();
+  sk::utils::dts::UnionFindSet<int> uf(DEDUP_NODES);
+  uf.connectBatch(pairs);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(uf.components());
+  }
+  state.SetItemsProcessed(state.iterations() * DEDUP_NODES);
+}
+
+static void BM_IsConnectedBatch100M(benchmark::State& state) {
+  const auto& pairs = DedupPairs();
+  sk::utils::dts::UnionFindSet<int> uf(DEDUP_NODES);
+  uf.connectBatch(std::span(pairs).first(pairs.size() / 2));
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(uf.isConnected(pairs, state.range(0) ? &Pool() : nullptr));
+  }
+  state.SetItemsProcessed(state.iterations() * pairs.size());
+}
+
+BENCHMARK(BM_LegacyUnionFind)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_UnionFindSet)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ConcurrentUnionFindSet)
+  ->RangeMultiplier(2)
+  ->Range(1, 8)
+  ->UseRealTime()
+  ->Unit(benchmark::kMillisecond);
+
+BENCHMARK(BM_ConnectBatch100M)->Arg(0)->Arg(1)->Iterations(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_ConcurrentConnectBatch100M)->Iterations(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_Components100M)->Iterations(1)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_IsConnectedBatch100M)->Arg(0)->Arg(1)->Iterations(1)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
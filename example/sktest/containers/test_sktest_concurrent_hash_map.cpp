@@ -0,0 +1,109 @@
+#include <atomic>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "skutils/containers/concurrent_hash_map.h"
+#include "skutils/logger.h"
+#include "skutils/test.h"
+#include "skutils/threadpool.h"
+
+using namespace sk::utils::dts;
+
+int main() {
+  concurrent_hash_map<std::string, int> words(4);
+  ASSERT_EQUAL(size_t{4}, words.shard_count());
+  ASSERT_TRUE(words.upsert("apple", [](int &v) { v += 2; }));
+  ASSERT_TRUE(!words.upsert(std::string_view("apple"), [](int &v) { v += 3; }));
+  ASSERT_EQUAL(5, words.get("apple").value_or(-1));
+  ASSERT_TRUE(!words.get("pear").has_value());
+  // 不存在时插入初值, 存在时才调用 fn
+  ASSERT_TRUE(words.upsert("pear", 10, [](int &v) { v = -1; }));
+  ASSERT_TRUE(!words.upsert("pear", 10, [](int &v) { v *= 2; }));
+  ASSERT_EQUAL(20, *words.get("pear"));
+  ASSERT_TRUE(!words.try_emplace("pear", 0));
+  ASSERT_TRUE(!words.insert_or_assign("pear", 7));
+  ASSERT_TRUE(words.visit(std::string_view("pear"), [](int &v) { v++; }));
+  ASSERT_TRUE(!words.visit("plum", [](int &) {}));
+  ASSERT_EQUAL(size_t{2}, words.size());
+  ASSERT_EQUAL(size_t{1}, words.erase("apple"));
+  ASSERT_TRUE(!words.contains("apple") && words.contains("pear"));
+
+  // 非透明 hash: int 参数转换成 size_t key 查找
+  concurrent_hash_map<size_t, int> sized;
+  sized.try_emplace(size_t{1}, 10);
+  int seen = 0;
+  ASSERT_TRUE(sized.visit(1, [&seen](int &v) { seen = v; }) && seen == 10);
+  ASSERT_TRUE(sized.get(1).has_value() && sized.contains(1));
+  ASSERT_EQUAL(size_t{1}, sized.erase(1));
+  auto snap = words.snapshot();
+  ASSERT_EQUAL(8, snap.at("pear"));
+
+  // 多线程对同一批 key 计数: 总数不丢
+  const int threads = 8;
+  const int perThread = 200'000;
+  const int keys = 1000;
+  concurrent_hash_map<int, long long> counts;
+  concurrent_hash_accumulator<int, long long> acc;
+  std::vector<std::thread> ts;
+  for (int t = 0; t < threads; t++) {
+    ts.emplace_back([&, t] {
+      for (int i = 0; i < perThread; i++) {
+        int k = (i * 7 + t) % keys;
+        counts.upsert(k, [](long long &v) { v++; });
+        acc.add(k, 1LL);
+      }
+    });
+  }
+  // 写的同时读: 读到的计数只增不减
+  bool monotonic = true;
+  for (long long last = 0; last < threads * (perThread / keys);) {
+    long long now = counts.get(0).value_or(0);
+    monotonic &= now >= last;
+    last = now;
+  }
+  for (auto &t : ts) {
+    t.join();
+  }
+  ASSERT_TRUE(monotonic);
+  ASSERT_EQUAL(size_t{keys}, counts.size());
+  long long total = 0;
+  counts.for_each([&](int, long long &v) { total += v; });
+  ASSERT_EQUAL(static_cast<long long>(threads) * perThread, total);
+
+  auto merged = acc.merged();
+  ASSERT_EQUAL(size_t{keys}, merged.size());
+  int bad = 0;
+  counts.for_each([&](int k, long long &v) { bad += merged.at(k) != v; });
+  ASSERT_EQUAL(0, bad);
+
+  // for_each_parallel: 每个分片在不同线程上遍历
+  sk::utils::ThreadPool pool(4);
+  std::atomic<long long> parallelTotal{0};
+  counts.for_each_parallel(pool, [&](int, long long &v) {
+    parallelTotal += v;
+    v = 0;
+  });
+  ASSERT_EQUAL(total, parallelTotal.load());
+  total = 0;
+  counts.for_each([&](int, long long &v) { total += v; });
+  ASSERT_EQUAL(0LL, total);
+
+  counts.clear();
+  acc.clear();
+  ASSERT_TRUE(counts.empty() && acc.merged().empty());
+
+  // 自定义合并: 每个 key 的最大值
+  auto maxOf = [](int a, int b) { return a > b ? a : b; };
+  concurrent_hash_accumulator<std::string, int, decltype(maxOf)> highest(2, maxOf);
+  highest.add("a", 3);
+  highest.add(std::string_view("a"), 9);
+  highest.add("a", 4);
+  highest.add("b", -1);
+  auto best = highest.merged();
+  ASSERT_EQUAL(9, best.at("a"));
+  ASSERT_EQUAL(-1, best.at("b"));
+
+  return ASSERT_ALL_PASSED();
+}
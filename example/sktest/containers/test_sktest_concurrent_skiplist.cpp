@@ -0,0 +1,105 @@
+#include <algorithm>
+#include <atomic>
+#include <map>
+#include <thread>
+#include <vector>
+
+#include "skutils/containers/concurrent_skiplist.h"
+#include "skutils/logger.h"
+#include "skutils/random.h"
+#include "skutils/test.h"
+
+using sk::utils::dts::ConcurrentSkipList;
+
+// 单线程下与 std::map 对拍
+void single_thread_checker() {
+  ConcurrentSkipList<int, int> sl;
+  std::map<int, int> mp;
+  int mismatch = 0;
+  for (int i = 0; i < 20000; i++) {
+    int key = RANDTOOL.getRandomInt(0, 2000);
+    if (RANDTOOL.coinOnce()) {
+      mismatch += mp.emplace(key, i).second != sl.insert(key, i);
+    } else {
+      mismatch += (mp.erase(key) == 1) != sl.erase(key);
+    }
+  }
+  ASSERT_EQUAL(0, mismatch);
+  ASSERT_EQUAL(mp.size(), sl.size());
+  std::vector<std::pair<int, int>> items;
+  sl.forEach([&items](int k, int v) { items.emplace_back(k, v); });
+  ASSERT_TRUE((items == std::vector<std::pair<int, int>>(mp.begin(), mp.end())));
+
+  ASSERT_TRUE(std::all_of(mp.begin(), mp.end(), [&sl](auto kv) { return sl.find(kv.first) == kv.second; }));
+  ASSERT_TRUE(!sl.contains(-1));
+
+  std::vector<int> range;
+  sl.forEachRange(100, 200, [&range](int k, int) { range.push_back(k); });
+  std::vector<int> expected;
+  for (auto it = mp.lower_bound(100); it != mp.end() && it->first < 200; ++it) {
+    expected.push_back(it->first);
+  }
+  ASSERT_TRUE(range == expected);
+}
+
+void concurrent_checker() {
+  constexpr int THREADS = 8;
+  constexpr int PER_THREAD = 20000;
+  ConcurrentSkipList<int, int> sl;
+
+  // 各线程插入互不相交的 key, 之后删除其中的奇数
+  std::vector<std::thread> ths;
+  for (int t = 0; t < THREADS; t++) {
+    ths.emplace_back([&sl, t] {
+      for (int i = 0; i < PER_THREAD; i++) {
+        sl.insert(i * THREADS + t, t);
+      }
+      for (int i = 1; i < PER_THREAD; i += 2) {
+        sl.erase(i * THREADS + t);
+      }
+    });
+  }
+  for (auto& th : ths) {
+    th.join();
+  }
+  ASSERT_EQUAL(size_t(THREADS * PER_THREAD / 2), sl.size());
+
+  // 所有线程争抢同一批 key
+  std::atomic<int> inserted{0};
+  std::atomic<int> erased{0};
+  ths.clear();
+  for (int t = 0; t < THREADS; t++) {
+    ths.emplace_back([&] {
+      for (int i = 0; i < 50000; i++) {
+        int key = -RANDTOOL.getRandomInt(1, 256);
+        if (RANDTOOL.coinOnce()) {
+          inserted += sl.insert(key, key);
+        } else {
+          erased += sl.erase(key);
+        }
+        sl.contains(key);
+      }
+    });
+  }
+  for (auto& th : ths) {
+    th.join();
+  }
+
+  size_t cnt = 0;
+  int prev = INT32_MIN;
+  bool sorted = true;
+  sl.forEach([&](int k, int) {
+    sorted = sorted && prev < k;
+    prev = k;
+    ++cnt;
+  });
+  ASSERT_TRUE(sorted);
+  ASSERT_EQUAL(cnt, sl.size());
+  ASSERT_EQUAL(size_t(THREADS * PER_THREAD / 2 + inserted - erased), cnt);
+}
+
+int main() {
+  single_thread_checker();
+  concurrent_checker();
+  return ASSERT_ALL_PASSED();
+}
@@ -0,0 +1,157 @@
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "skutils/containers/flat_hash_map.h"
+#include "skutils/logger.h"
+#include "skutils/printer.h"
+#include "skutils/test.h"
+
+using namespace sk::utils::dts;
+
+// 计数析构次数, 检查 erase / clear / rehash 不泄漏也不重复析构
+struct Tracked {
+  static inline int alive = 0;
+  int v;
+
+  explicit Tracked(int x = 0) : v(x) { alive++; }
+
+  Tracked(const Tracked &o) : v(o.v) { alive++; }
+
+  Tracked(Tracked &&o) noexcept : v(o.v) { alive++; }
+
+  Tracked &operator=(const Tracked &) = default;
+
+  ~Tracked() { alive--; }
+};
+
+int main() {
+  flat_hash_map<std::string, int> m{{"one", 1}, {"two", 2}};
+  m["three"] = 3;
+  ASSERT_EQUAL(size_t{3}, m.size());
+  ASSERT_EQUAL(2, m.at("two"));
+  // 异构查找: string_view / const char* 不构造 std::string
+  ASSERT_TRUE(m.contains(std::string_view("three")));
+  ASSERT_TRUE(m.find("four") == m.end());
+  ASSERT_TRUE(!m.try_emplace("one", 100).second);
+  ASSERT_EQUAL(1, m["one"]);
+  m.insert_or_assign("one", 100);
+  ASSERT_EQUAL(100, m["one"]);
+  ASSERT_EQUAL(size_t{1}, m.erase(std::string_view("two")));
+  ASSERT_EQUAL(size_t{0}, m.count("two"));
+  bool thrown = false;
+  try {
+    m.at("two");
+  } catch (const std::out_of_range &) {
+    thrown = true;
+  }
+  ASSERT_TRUE(thrown);
+  // string key 按迭代器删除, 不会被当成异构 key
+  auto next = m.erase(m.find("one"));
+  ASSERT_TRUE(next == m.end() || next->first == "three");
+  ASSERT_EQUAL(size_t{1}, m.size());
+  m.erase(m.begin());
+  ASSERT_TRUE(m.empty());
+
+  // 非透明 hash: 可以转换成 key_type 的参数走 const key_type & 重载
+  flat_hash_map<size_t, int> sized{{1, 10}, {2, 20}};
+  ASSERT_TRUE(sized.find(1) != sized.end());
+  ASSERT_TRUE(sized.contains(1) && !sized.contains(3));
+  ASSERT_EQUAL(size_t{1}, sized.count(2));
+  ASSERT_EQUAL(20, sized.at(2));
+  ASSERT_EQUAL(size_t{1}, sized.erase(1));
+  const auto &constSized = sized;
+  ASSERT_TRUE(constSized.find(2) != constSized.end());
+  flat_hash_set<size_t> sizedSet{5};
+  ASSERT_TRUE(sizedSet.contains(5) && sizedSet.find(5) != sizedSet.end());
+
+  // 通过 sk::utils::toString 打印
+  flat_hash_map<int, int> single{{7, 49}};
+  ASSERT_STR_EQUAL(std::string{"[{7,49}]"}, sk::utils::toString(single));
+  flat_hash_set<std::string> words{"hi"};
+  ASSERT_STR_EQUAL(std::string{"[hi]"}, sk::utils::toString(words));
+  ASSERT_STR_EQUAL(std::string{"[]"}, sk::utils::toString(flat_hash_set<int>()));
+
+  // 随机增删查, 与 std::unordered_map 对拍
+  flat_hash_map<int, int> f;
+  std::unordered_map<int, int> u;
+  std::uint64_t x = 1;
+  int bad = 0;
+  for (int i = 0; i < 1'000'000; i++) {
+    x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+    int k = static_cast<int>((x >> 33) % 50'000);
+    switch ((x >> 20) % 3) {
+      case 0:
+        f[k] = i;
+        u[k] = i;
+        break;
+      case 1:
+        bad += f.erase(k) != u.erase(k);
+        break;
+      default: {
+        auto a = f.find(k);
+        auto b = u.find(k);
+        bad += (a == f.end()) != (b == u.end());
+        bad += a != f.end() && b != u.end() && a->second != b->second;
+      }
+    }
+  }
+  ASSERT_EQUAL(0, bad);
+  ASSERT_EQUAL(u.size(), f.size());
+  ASSERT_TRUE(f.load_factor() <= 0.875);
+  size_t visited = 0;
+  for (const auto &[k, v] : f) {
+    visited++;
+    bad += u.at(k) != v;
+  }
+  ASSERT_EQUAL(u.size(), visited);
+  ASSERT_EQUAL(0, bad);
+
+  // 拷贝, 移动, 按迭代器删除
+  auto copy = f;
+  ASSERT_TRUE(copy == f);
+  auto moved = std::move(copy);
+  ASSERT_TRUE(moved == f && copy.empty());
+  for (auto it = moved.begin(); it != moved.end();) {
+    it = it->first % 2 != 0 ? moved.erase(it) : std::next(it);
+  }
+  for (const auto &[k, v] : moved) {
+    bad += k % 2;
+  }
+  ASSERT_EQUAL(0, bad);
+
+  // reserve 之后插入不再扩容
+  flat_hash_set<int> reserved;
+  reserved.reserve(10'000);
+  auto cap = reserved.capacity();
+  for (int i = 0; i < 10'000; i++) {
+    reserved.insert(i);
+  }
+  ASSERT_EQUAL(cap, reserved.capacity());
+  ASSERT_TRUE(reserved.contains(9'999) && !reserved.contains(10'000));
+  reserved.clear();
+  reserved.rehash(0);
+  ASSERT_EQUAL(size_t{0}, reserved.capacity());
+
+  // 反复插入删除同一批 key: 墓碑被回收, 容量不会一直增长
+  flat_hash_map<int, Tracked> churn;
+  for (int round = 0; round < 100; round++) {
+    for (int i = 0; i < 1000; i++) {
+      churn.try_emplace(round * 1000 + i, i);
+    }
+    for (int i = 0; i < 1000; i++) {
+      churn.erase(round * 1000 + i);
+    }
+  }
+  ASSERT_TRUE(churn.capacity() <= 4096);
+  for (int i = 0; i < 100; i++) {
+    churn.try_emplace(i, i);
+  }
+  ASSERT_EQUAL(100, Tracked::alive);
+  churn.clear();
+  ASSERT_EQUAL(0, Tracked::alive);
+
+  return ASSERT_ALL_PASSED();
+}
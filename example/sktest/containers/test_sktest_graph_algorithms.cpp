@@ -0,0 +1,121 @@
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <utility>
+#include <vector>
+
+#include "skutils/containers/graph_algorithms.h"
+#include "skutils/containers/unionfind_set.h"
+#include "skutils/logger.h"
+#include "skutils/test.h"
+
+using namespace sk::utils::dts;
+
+std::vector<int> refBfs(const CsrGraph<int> &g, int s) {
+  std::vector<int> depth(g.size(), graphConst::unreachable);
+  std::queue<int> q;
+  depth[s] = 0;
+  q.push(s);
+  while (!q.empty()) {
+    int u = q.front();
+    q.pop();
+    for (auto v : g.neighbors(u)) {
+      if (depth[v] == graphConst::unreachable) {
+        depth[v] = depth[u] + 1;
+        q.push(v);
+      }
+    }
+  }
+  return depth;
+}
+
+std::vector<std::int64_t> refDijkstra(const CsrGraph<int> &g, int s) {
+  std::vector<std::int64_t> dist(g.size(), graphConst::infDistance);
+  using Item = std::pair<std::int64_t, int>;
+  std::priority_queue<Item, std::vector<Item>, std::greater<>> pq;
+  dist[s] = 0;
+  pq.push({0, s});
+  while (!pq.empty()) {
+    auto [d, u] = pq.top();
+    pq.pop();
+    if (d != dist[u]) {
+      continue;
+    }
+    g.forEachNeighbor(u, [&](int v, int w) {
+      if (d + w < dist[v]) {
+        dist[v] = d + w;
+        pq.push({dist[v], v});
+      }
+    });
+  }
+  return dist;
+}
+
+int main() {
+  sk::utils::ThreadPool pool(4);
+
+  // 小图: 0-1-2 连通, 3 孤立, 4->5 有向
+  CsrGraph<int>::Builder b(6, true);
+  b.addEdge(0, 1, 4).addEdge(1, 2, 1).addEdge(0, 2, 7).addEdge(4, 5, 2);
+  auto small = std::move(b).build();
+  ASSERT_STR_EQUAL((std::vector<int>{0, 1, 1, -1, -1, -1}), bfs(small, 0));
+  auto smallDist = deltaStepping(small, 0);
+  ASSERT_STR_EQUAL((std::vector<std::int64_t>{0, 4, 5}),
+                   std::vector<std::int64_t>(smallDist.begin(), smallDist.begin() + 3));
+  ASSERT_EQUAL(graphConst::infDistance, smallDist[3]);
+  ASSERT_STR_EQUAL((std::vector<int>{0, 0, 0, 3, 4, 4}), connectedComponents(small));
+  ASSERT_EQUAL(3, componentCount(connectedComponents(small, &pool)));
+
+  // delta 远小于边权: 只为非空的桶分配, 不会按 最大距离 / delta 个桶分配
+  CsrGraph<int>::Builder heavyBuilder(4, true);
+  heavyBuilder.addEdge(0, 1, 1'000'000'000).addEdge(1, 2, 1'000'000'000).addEdge(0, 3, 2'100'000'000);
+  heavyBuilder.addEdge(2, 3, 1);
+  auto heavy = std::move(heavyBuilder).build();
+  ASSERT_STR_EQUAL((std::vector<std::int64_t>{0, 1'000'000'000, 2'000'000'000, 2'000'000'001}),
+                   deltaStepping(heavy, 0, &pool, 1));
+
+  // 随机稀疏图: 并行结果与串行参考实现一致
+  for (bool directed : {false, true}) {
+    auto g = buildRandomGraph<CsrGraph<int>>(50'000, directed, false, 1, 100);
+    int mismatch = 0;
+    for (int src : {0, 12345}) {
+      auto ref = refBfs(g, src);
+      mismatch += bfs(g, src) != ref;
+      mismatch += bfs(g, src, &pool) != ref;
+      auto refDist = refDijkstra(g, src);
+      mismatch += deltaStepping(g, src, &pool) != refDist;
+      mismatch += deltaStepping(g, src, &pool, 1) != refDist;
+      mismatch += deltaStepping(g, src, nullptr, 1'000'000) != refDist;
+    }
+    ASSERT_EQUAL(0, mismatch);
+
+    auto labels = connectedComponents(g, &pool);
+    ASSERT_EQUAL(UnionFindSet<int>(g).count(), componentCount(labels));
+    ASSERT_TRUE(labels == connectedComponents(g));
+
+    auto pr = pageRank(g, &pool);
+    double sum = 0;
+    for (auto x : pr) {
+      sum += x;
+    }
+    ASSERT_TRUE(std::abs(sum - 1.0) < 1e-6);
+    auto prSerial = pageRank(g);
+    double diff = 0;
+    for (size_t i = 0; i < pr.size(); i++) {
+      diff += std::abs(pr[i] - prSerial[i]);
+    }
+    ASSERT_TRUE(diff < 1e-9);
+  }
+
+  // 星形有向图: 所有点指向 0, 0 的 PageRank 最大
+  CsrGraph<int>::Builder sb(100, true);
+  for (int i = 1; i < 100; i++) {
+    sb.addEdge(i, 0);
+  }
+  auto star = std::move(sb).build();
+  auto spr = pageRank(star, &pool);
+  ASSERT_TRUE(std::max_element(spr.begin(), spr.end()) - spr.begin() == 0);
+
+  return ASSERT_ALL_PASSED();
+}
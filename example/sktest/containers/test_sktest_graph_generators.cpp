@@ -0,0 +1,108 @@
+#include <algorithm>
+#include <vector>
+
+#include "skutils/containers/graph_generators.h"
+#include "skutils/containers/sparse_graph.h"
+#include "skutils/logger.h"
+#include "skutils/test.h"
+
+using namespace sk::utils::dts;
+
+bool sameEdges(const std::vector<Edge> &a, const std::vector<Edge> &b) {
+  return std::equal(a.begin(), a.end(), b.begin(), b.end(), [](const Edge &x, const Edge &y) {
+    return x.from == y.from && x.to == y.to && x.weight == y.weight;
+  });
+}
+
+bool sameGraph(const CsrGraph<int> &a, const CsrGraph<int> &b) {
+  if (a.size() != b.size() || a.edgeCount() != b.edgeCount()) {
+    return false;
+  }
+  for (int u = 0; u < a.size(); u++) {
+    auto na = a.neighbors(u);
+    auto nb = b.neighbors(u);
+    auto wa = a.weightsOf(u);
+    auto wb = b.weightsOf(u);
+    if (!std::equal(na.begin(), na.end(), nb.begin(), nb.end()) ||
+        !std::equal(wa.begin(), wa.end(), wb.begin(), wb.end())) {
+      return false;
+    }
+  }
+  return true;
+}
+
+int main() {
+  sk::utils::ThreadPool pool(4);
+
+  // 同一个 seed, 串行与线程池结果完全一致 (跨多个 chunk)
+  const int scale = 16;
+  auto rmat = rmatEdges(scale, 8, 7);
+  ASSERT_EQUAL(size_t{8} << scale, rmat.size());
+  ASSERT_TRUE(sameEdges(rmat, rmatEdges(scale, 8, 7, &pool)));
+  ASSERT_TRUE(!sameEdges(rmat, rmatEdges(scale, 8, 8)));
+  ASSERT_TRUE(std::all_of(rmat.begin(), rmat.end(), [](const Edge &e) {
+    return e.from >= 0 && e.from < (1 << scale) && e.to >= 0 && e.to < (1 << scale);
+  }));
+  // RMAT 度数偏斜: 最大度远大于平均度
+  auto rg = CsrGraph<int>::fromEdges(1 << scale, rmat, true, &pool);
+  int maxDegree = 0;
+  for (int u = 0; u < rg.size(); u++) {
+    maxDegree = std::max(maxDegree, rg.degree(u));
+  }
+  ASSERT_TRUE(maxDegree > 8 * 20);
+
+  auto er = erdosRenyiEdges(1000, 300'000, 3);
+  ASSERT_TRUE(sameEdges(er, erdosRenyiEdges(1000, 300'000, 3, &pool)));
+  ASSERT_TRUE(std::all_of(er.begin(), er.end(),
+                          [](const Edge &e) { return e.from != e.to && e.from < 1000 && e.to < 1000; }));
+  ASSERT_TRUE(erdosRenyiEdges(1, 10, 3).back().to == 0);
+
+  // BA: 第 i 条边从 i / k 出发, 指向不晚于自己的点
+  const int k = 4;
+  auto ba = barabasiAlbertEdges(50'000, k, 11);
+  ASSERT_EQUAL(size_t{50'000} * k, ba.size());
+  ASSERT_TRUE(sameEdges(ba, barabasiAlbertEdges(50'000, k, 11, &pool)));
+  bool baOk = true;
+  for (size_t i = 0; i < ba.size(); i++) {
+    baOk &= ba[i].from == static_cast<int>(i / k) && ba[i].to >= 0 && ba[i].to <= ba[i].from;
+  }
+  ASSERT_TRUE(baOk);
+  // 偏好连接: 早期的点度数更高
+  auto bg = CsrGraph<int>::fromEdges(50'000, ba);
+  ASSERT_TRUE(bg.degree(1) > 10 * bg.degree(49'999));
+
+  randomizeWeights(er, -5, 5, 9, &pool);
+  ASSERT_TRUE(std::all_of(er.begin(), er.end(), [](const Edge &e) { return e.weight >= -5 && e.weight <= 5; }));
+  ASSERT_TRUE(std::any_of(er.begin(), er.end(), [](const Edge &e) { return e.weight == -5; }));
+
+  // fromEdges 与 Builder 构造出相同的图, 包括自环
+  er.push_back({7, 7, 2});
+  for (bool directed : {false, true}) {
+    CsrGraph<int>::Builder b(1000, directed);
+    for (const auto &e : er) {
+      b.addEdge(e.from, e.to, e.weight);
+    }
+    auto built = std::move(b).build();
+    ASSERT_TRUE(sameGraph(built, CsrGraph<int>::fromEdges(1000, er, directed)));
+    ASSERT_TRUE(sameGraph(built, CsrGraph<int>::fromEdges(1000, er, directed, &pool)));
+  }
+  ASSERT_TRUE(!CsrGraph<int>::fromEdges(10, std::vector<Edge>{{1, 2}}).isWeighted());
+  bool thrown = false;
+  try {
+    CsrGraph<int>::fromEdges(10, std::vector<Edge>{{1, 10}});
+  } catch (const std::out_of_range&) {
+    thrown = true;
+  }
+  ASSERT_TRUE(thrown);
+
+  // 稀疏表示的 buildRandomGraph 可以跑百万级点
+  auto big = buildRandomGraph<CsrGraph<int>>(1'000'000, false, false);
+  ASSERT_EQUAL(1'000'000, big.size());
+  // 无向图每条边存两份, 自环只存一份
+  ASSERT_TRUE(big.edgeCount() <= 6'000'000 && big.edgeCount() > 5'999'900);
+  ASSERT_TRUE(big.isWeighted());
+  auto small = buildRandomGraph(200, false, false, 1, 9);
+  ASSERT_EQUAL(200, small.size());
+
+  return ASSERT_ALL_PASSED();
+}
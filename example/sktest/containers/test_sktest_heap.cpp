@@ -0,0 +1,107 @@
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <string>
+#include <vector>
+
+#include "skutils/containers/heap.h"
+#include "skutils/logger.h"
+#include "skutils/random.h"
+#include "skutils/test.h"
+
+namespace dts = sk::utils::dts;
+
+void heap_checker() {
+  auto vals = RANDTOOL.getRandomIntVector(5000, -1000, 1000);
+
+  // 默认 std::greater, 与 std::priority_queue 约定一致: 小顶堆
+  dts::Heap<int> minHeap(vals);
+  dts::Heap<int, std::less<int>, 2> maxHeap;
+  std::priority_queue<int, std::vector<int>, std::greater<int>> pqMin(vals.begin(), vals.end());
+  std::priority_queue<int> pqMax;
+  for (auto v : vals) {
+    maxHeap.push(v);
+    pqMax.push(v);
+  }
+  int mismatch = 0;
+  while (!pqMin.empty()) {
+    mismatch += minHeap.top() != pqMin.top();
+    mismatch += minHeap.pop() != pqMin.top();
+    mismatch += maxHeap.pop() != pqMax.top();
+    pqMin.pop();
+    pqMax.pop();
+  }
+  ASSERT_EQUAL(0, mismatch);
+  ASSERT_TRUE(minHeap.empty() && maxHeap.empty());
+
+  dts::Heap<std::string> strs;
+  strs.emplace(3, 'b');
+  strs.emplace("aa");
+  ASSERT_EQUAL(std::string("aa"), strs.pop());
+  ASSERT_EQUAL(std::string("bbb"), strs.pop());
+
+  auto sorted = vals;
+  dts::Heap<int>::sort(sorted);
+  ASSERT_TRUE(std::is_sorted(sorted.begin(), sorted.end()));
+  dts::Heap<int, std::less<int>, 8>::sort(sorted);
+  ASSERT_TRUE(std::is_sorted(sorted.begin(), sorted.end(), std::greater<int>()));
+}
+
+void indexed_heap_checker() {
+  dts::IndexedHeap<int> heap;
+  std::vector<int> cur(2000);
+  std::vector<dts::IndexedHeap<int>::Handle> handles(cur.size());
+  for (size_t i = 0; i < cur.size(); i++) {
+    cur[i] = RANDTOOL.getRandomInt(0, 100000);
+    handles[i] = heap.push(cur[i]);
+  }
+  // 随机 decrease_key / update / erase
+  std::vector<bool> alive(cur.size(), true);
+  for (int i = 0; i < 3000; i++) {
+    auto idx = RANDTOOL.getRandomInt(0, static_cast<int>(cur.size()) - 1);
+    if (!alive[idx]) {
+      continue;
+    }
+    switch (RANDTOOL.getRandomInt(0, 2)) {
+      case 0:
+        cur[idx] -= RANDTOOL.getRandomInt(0, 1000);
+        heap.decrease_key(handles[idx], cur[idx]);
+        break;
+      case 1:
+        cur[idx] = RANDTOOL.getRandomInt(0, 100000);
+        heap.update(handles[idx], cur[idx]);
+        break;
+      default:
+        alive[idx] = false;
+        heap.erase(handles[idx]);
+    }
+  }
+  std::vector<int> expected;
+  int mismatch = 0;
+  for (size_t i = 0; i < cur.size(); i++) {
+    if (alive[i]) {
+      expected.push_back(cur[i]);
+      mismatch += !heap.contains(handles[i]) || heap.get(handles[i]) != cur[i];
+    }
+  }
+  ASSERT_EQUAL(0, mismatch);
+  std::sort(expected.begin(), expected.end());
+  ASSERT_EQUAL(static_cast<int>(expected.size()), heap.size());
+  std::vector<int> popped;
+  while (!heap.empty()) {
+    popped.push_back(heap.pop());
+  }
+  ASSERT_TRUE(popped == expected);
+
+  // 句柄复用
+  auto h = heap.push(1);
+  ASSERT_TRUE(heap.contains(h));
+  ASSERT_TRUE(heap.erase(h));
+  ASSERT_TRUE(!heap.erase(h));
+}
+
+int main() {
+  heap_checker();
+  indexed_heap_checker();
+  return ASSERT_ALL_PASSED();
+}
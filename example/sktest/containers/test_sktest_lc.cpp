@@ -0,0 +1,76 @@
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "skutils/containers/lc.h"
+#include "skutils/logger.h"
+#include "skutils/test.h"
+
+using namespace sk::utils::dts::lc;
+
+int main() {
+  auto *list = vector2List({1, 2, 3, 4});
+  ASSERT_STR_EQUAL(std::string{"[1,2,3,4]"}, list->toString());
+  reverseList(&list);
+  ASSERT_STR_EQUAL(std::string{"[4,3,2,1]"}, list->toString());
+  delete list;
+  ASSERT_TRUE(vector2List({}) == nullptr);
+
+  // 1 -> (nullptr, 2), 2 -> (3, nullptr)
+  auto *tree = vector2Tree({1, std::nullopt, 2, 3});
+  ASSERT_STR_EQUAL(std::string{"(Pre)[1,2,3],(In)[1,3,2]"}, tree->toString());
+  delete tree;
+  auto *full = vector2Tree({4, 2, 6, 1, 3, 5, 7});
+  ASSERT_STR_EQUAL(std::string{"(Pre)[4,2,1,3,6,5,7],(In)[1,2,3,4,5,6,7]"}, full->toString());
+  delete full;
+  ASSERT_TRUE(vector2Tree({std::nullopt}) == nullptr);
+
+  // 百万节点: 析构与遍历都是迭代的, 不会爆栈
+  const int N = 1'000'000;
+  std::vector<int> vals(N);
+  for (int i = 0; i < N; i++) {
+    vals[i] = i;
+  }
+  auto *longList = vector2List(vals);
+  delete longList;
+
+  // 一条向左的长链: 层序表示为 0, 1, null, 2, null, ...
+  std::vector<std::optional<int>> chain{0};
+  for (int i = 1; i < N; i++) {
+    chain.emplace_back(i);
+    chain.emplace_back(std::nullopt);
+  }
+  auto *deep = vector2Tree(chain);
+  long long sum = 0;
+  int last = N;
+  bool descending = true;
+  inorderTraverse(deep, [&](TreeNode *node) {
+    descending &= node->val == last - 1;
+    last = node->val;
+    sum += node->val;
+  });
+  ASSERT_TRUE(descending);
+  ASSERT_EQUAL(static_cast<long long>(N) * (N - 1) / 2, sum);
+  delete deep;
+
+  // 内存池: 节点连续分配, 整体释放
+  NodePool pool;
+  auto *pooled = vector2List(vals, pool);
+  ASSERT_TRUE(pooled->next == pooled + 1);
+  int count = 0;
+  for (auto *p = pooled; p != nullptr; p = p->next) {
+    count++;
+  }
+  ASSERT_EQUAL(N, count);
+  auto *pooledTree = vector2Tree(chain, pool);
+  int preCount = 0;
+  preorderTraverse(pooledTree, [&](TreeNode *) { preCount++; });
+  ASSERT_EQUAL(N, preCount);
+  ASSERT_TRUE(pool.bytesUsed() >= N * (sizeof(ListNode) + sizeof(TreeNode)));
+  pool.reset();
+  ASSERT_EQUAL(size_t{0}, pool.bytesUsed());
+  auto *small = pool.tree(2, pool.tree(1), pool.tree(3));
+  ASSERT_STR_EQUAL(std::string{"(Pre)[2,1,3],(In)[1,2,3]"}, small->toString());
+
+  return ASSERT_ALL_PASSED();
+}
@@ -0,0 +1,240 @@
+#include <chrono>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include "skutils/containers/lru_cache.h"
+#include "skutils/logger.h"
+#include "skutils/test.h"
+
+using namespace sk::utils::dts;
+using namespace std::chrono_literals;
+
+int main() {
+  LruCache<std::string, int> lru(3);
+  lru.put("a", 1);
+  lru.put("b", 2);
+  lru.put("c", 3);
+  ASSERT_EQUAL(1, lru.get(std::string_view("a")).value_or(-1));
+  lru.put("d", 4);  // b 最久未使用
+  ASSERT_TRUE(!lru.contains("b"));
+  ASSERT_TRUE(lru.contains("a") && lru.contains("c") && lru.contains("d"));
+  lru.put("c", 30);
+  ASSERT_EQUAL(30, *lru.get("c"));
+  ASSERT_TRUE(!lru.get("b").has_value());
+  ASSERT_EQUAL(size_t{2}, lru.stats().hits);
+  ASSERT_EQUAL(size_t{1}, lru.stats().misses);
+  ASSERT_EQUAL(size_t{1}, lru.stats().evictions);
+  ASSERT_TRUE(lru.erase("a") && !lru.erase("a"));
+  ASSERT_EQUAL(size_t{2}, lru.size());
+
+  // 非透明 hash: int 参数转换成 size_t key 查找
+  LruCache<size_t, int> sizedLru(4);
+  ArcCache<size_t, int> sizedArc(4);
+  ConcurrentCache<LruCache<size_t, int>> sizedShared(4, 2);
+  sizedLru.put(size_t{1}, 1);
+  sizedArc.put(size_t{1}, 1);
+  sizedShared.put(size_t{1}, 1);
+  ASSERT_TRUE(sizedLru.get(1).has_value() && sizedLru.contains(1) && sizedLru.erase(1));
+  ASSERT_TRUE(sizedArc.get(1).has_value() && sizedArc.contains(1) && sizedArc.erase(1));
+  ASSERT_TRUE(sizedShared.get(1).has_value() && sizedShared.contains(1) && sizedShared.erase(1));
+
+  // 按权重淘汰: 权重为字符串长度
+  LruCache<int, std::string> bytes(10, 0s, [](const int &, const std::string &s) { return s.size(); });
+  bytes.put(1, std::string(4, 'x'));
+  bytes.put(2, std::string(4, 'y'));
+  bytes.put(3, std::string(4, 'z'));
+  ASSERT_TRUE(!bytes.contains(1) && bytes.contains(2) && bytes.contains(3));
+  ASSERT_EQUAL(size_t{8}, bytes.weight());
+  bytes.put(4, std::string(11, 'w'));  // 比整个容量还大, 不保留
+  ASSERT_TRUE(!bytes.contains(4));
+  ASSERT_EQUAL(size_t{8}, bytes.weight());
+
+  // TTL
+  LruCache<int, int> timed(10, 100ms);
+  timed.put(1, 1);
+  timed.put(2, 2, 0s);  // 单独指定: 永不过期
+  timed.put(3, 3);
+  ASSERT_TRUE(timed.contains(1));
+  std::this_thread::sleep_for(200ms);
+  ASSERT_TRUE(!timed.get(1).has_value());
+  ASSERT_EQUAL(2, timed.get(2).value_or(-1));
+  ASSERT_EQUAL(size_t{1}, timed.purgeExpired());
+  ASSERT_EQUAL(size_t{2}, timed.stats().expirations);
+  ASSERT_EQUAL(size_t{1}, timed.size());
+
+  // 随机操作, 与 std::list + unordered_map 的朴素 LRU 对拍
+  {
+    const size_t cap = 64;
+    LruCache<int, int> fast(cap);
+    std::list<std::pair<int, int>> order;
+    std::unordered_map<int, std::list<std::pair<int, int>>::iterator> pos;
+    std::uint64_t x = 7;
+    int bad = 0;
+    for (int i = 0; i < 200'000; i++) {
+      x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+      int k = static_cast<int>((x >> 33) % 200);
+      if ((x >> 20) % 2 == 0) {
+        fast.put(k, i);
+        if (auto it = pos.find(k); it != pos.end()) {
+          order.erase(it->second);
+        }
+        order.emplace_front(k, i);
+        pos[k] = order.begin();
+        if (order.size() > cap) {
+          pos.erase(order.back().first);
+          order.pop_back();
+        }
+      } else {
+        auto got = fast.get(k);
+        auto it = pos.find(k);
+        bad += got.has_value() != (it != pos.end());
+        if (it != pos.end()) {
+          bad += got.value_or(-1) != it->second->second;
+          order.splice(order.begin(), order, it->second);
+        }
+      }
+    }
+    ASSERT_EQUAL(0, bad);
+    ASSERT_EQUAL(order.size(), fast.size());
+  }
+
+  // ARC 抗扫描: 访问过两次的热点 key 不会被一次性的顺序扫描冲掉
+  {
+    const int cap = 100;
+    const int hot = 50;
+    ArcCache<int, int> arc(cap);
+    LruCache<int, int> plain(cap);
+    for (int round = 0; round < 2; round++) {
+      for (int k = 0; k < hot; k++) {
+        if (!arc.get(k)) {
+          arc.put(k, k);
+        }
+        if (!plain.get(k)) {
+          plain.put(k, k);
+        }
+      }
+    }
+    for (int k = 1000; k < 3000; k++) {
+      arc.put(k, k);
+      plain.put(k, k);
+    }
+    int arcHot = 0;
+    int lruHot = 0;
+    for (int k = 0; k < hot; k++) {
+      arcHot += arc.contains(k);
+      lruHot += plain.contains(k);
+    }
+    ASSERT_EQUAL(hot, arcHot);
+    ASSERT_EQUAL(0, lruHot);
+    ASSERT_TRUE(arc.size() <= static_cast<size_t>(cap));
+  }
+
+  // ARC: 命中 B1 的幽灵 key 让 T1 的目标大小 p 增大
+  {
+    ArcCache<int, int> arc(4);
+    for (int k = 0; k < 4; k++) {
+      arc.put(k, k);
+    }
+    arc.get(0);
+    arc.get(1);  // T2 = {0, 1}, T1 = {2, 3}
+    arc.put(4, 4);
+    arc.put(5, 5);  // 2, 3 依次从 T1 进入幽灵列表 B1
+    ASSERT_EQUAL(size_t{0}, arc.recencyTarget());
+    ASSERT_TRUE(!arc.get(2).has_value());
+    arc.put(2, 2);
+    ASSERT_EQUAL(size_t{1}, arc.recencyTarget());
+    ASSERT_TRUE(arc.contains(2) && arc.size() == 4);
+    ASSERT_TRUE(arc.erase(2) && !arc.contains(2));
+  }
+
+  // 随机操作下 ARC 的值永远是最后一次 put 的值, 大小不超过容量
+  {
+    ArcCache<int, int> arc(32);
+    std::unordered_map<int, int> latest;
+    std::uint64_t x = 3;
+    int bad = 0;
+    for (int i = 0; i < 200'000; i++) {
+      x = x * 6364136223846793005ULL + 1442695040888963407ULL;
+      int k = static_cast<int>((x >> 33) % ((x >> 12) % 4 == 0 ? 1000 : 40));
+      if ((x >> 20) % 3 == 0) {
+        arc.put(k, i);
+        latest[k] = i;
+      } else if ((x >> 20) % 3 == 1) {
+        auto got = arc.get(k);
+        bad += got.has_value() && *got != latest[k];
+      } else if ((x >> 24) % 8 == 0) {
+        arc.erase(k);
+      }
+      bad += arc.size() > 32;
+    }
+    ASSERT_EQUAL(0, bad);
+    ASSERT_TRUE(arc.stats().hits > 0 && arc.stats().evictions > 0);
+  }
+
+  // 分片并发缓存
+  {
+    ConcurrentCache<LruCache<int, int>> shared(4096, 8);
+    ASSERT_EQUAL(size_t{8}, shared.shard_count());
+    // 容量小于分片数时减少分片, 每个 key 都能被缓存
+    ConcurrentCache<LruCache<int, int>> tiny(3, 16);
+    ASSERT_EQUAL(size_t{2}, tiny.shard_count());
+    bool cachedAll = true;
+    for (int k = 0; k < 100; k++) {
+      tiny.put(k, k);
+      cachedAll &= tiny.contains(k);
+    }
+    ASSERT_TRUE(cachedAll);
+    std::vector<std::thread> ts;
+    for (int t = 0; t < 4; t++) {
+      ts.emplace_back([&shared, t] {
+        for (int i = 0; i < 50'000; i++) {
+          int k = (i * 31 + t) % 2000;
+          if (auto v = shared.get(k); !v) {
+            shared.put(k, k * 2);
+          }
+        }
+      });
+    }
+    for (auto &t : ts) {
+      t.join();
+    }
+    auto stats = shared.stats();
+    ASSERT_EQUAL(size_t{200'000}, stats.hits + stats.misses);
+    ASSERT_TRUE(stats.hitRate() > 0.9);
+    ASSERT_EQUAL(2000, shared.get(1000).value_or(-1));
+    ASSERT_TRUE(shared.erase(1000) && !shared.contains(1000));
+    ConcurrentCache<ArcCache<std::string, int>> arcShared(64, 2, 1h);
+    arcShared.put("k", 1);
+    ASSERT_EQUAL(1, arcShared.get(std::string_view("k")).value_or(-1));
+  }
+
+  // memoize
+  {
+    int calls = 0;
+    LruCache<int, long long> cache(16);
+    auto square = memoize(
+      [&calls](int n) {
+        calls++;
+        return static_cast<long long>(n) * n;
+      },
+      cache);
+    ASSERT_EQUAL(49LL, square(7));
+    ASSERT_EQUAL(49LL, square(7));
+    ASSERT_EQUAL(64LL, square(8));
+    ASSERT_EQUAL(2, calls);
+    ASSERT_EQUAL(size_t{1}, cache.stats().hits);
+
+    ConcurrentCache<LruCache<std::string, size_t>> lengths(16, 2);
+    auto length = memoize([](const std::string &s) { return s.size(); }, lengths);
+    ASSERT_EQUAL(size_t{5}, length(std::string("hello")));
+    ASSERT_EQUAL(size_t{5}, length(std::string("hello")));
+    ASSERT_EQUAL(size_t{1}, lengths.stats().hits);
+  }
+
+  return ASSERT_ALL_PASSED();
+}
@@ -0,0 +1,189 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "skutils/containers/concurrent_sketch.h"
+#include "skutils/containers/count_min.h"
+#include "skutils/containers/heavy_hitters.h"
+#include "skutils/containers/kll_sketch.h"
+#include "skutils/logger.h"
+#include "skutils/test.h"
+
+using namespace sk::utils::dts;
+
+/// 偏斜流: 0..9 为热点, 其余是长尾
+std::vector<int> skewedStream(int n, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::uniform_int_distribution<int> tail(10, 100000);
+  std::vector<int> ret;
+  ret.reserve(n);
+  for (int i = 0; i < n; i++) {
+    ret.push_back(i % 4 == 0 ? (i / 4) % 10 : tail(gen));
+  }
+  return ret;
+}
+
+int main() {
+  constexpr int N = 200000;
+  auto stream = skewedStream(N, 7);
+  std::vector<int> exact(100001, 0);
+  for (auto x : stream) {
+    exact[x]++;
+  }
+
+  // space saving: 热点全部命中, 且 count - error <= 真实值 <= count
+  space_saving<int> ss(64);
+  for (auto x : stream) {
+    ss.push(x);
+  }
+  ASSERT_EQUAL(ss.total(), static_cast<std::uint64_t>(N));
+  ASSERT_EQUAL(ss.size(), static_cast<size_t>(64));
+  auto ssTop = ss.top(10);
+  std::vector<int> ssItems;
+  int ssBad = 0;
+  for (auto& e : ssTop) {
+    ssItems.push_back(e.item);
+    auto truth = static_cast<std::uint64_t>(exact[e.item]);
+    ssBad += (e.count < truth || e.count - e.error > truth);
+  }
+  std::sort(ssItems.begin(), ssItems.end());
+  ASSERT_STR_EQUAL(ssItems, (std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 8, 9}));
+  ASSERT_EQUAL(ssBad, 0);
+
+  // space saving merge: 两半分别统计再合并
+  space_saving<int> ssA(64), ssB(64);
+  for (int i = 0; i < N; i++) {
+    (i < N / 2 ? ssA : ssB).push(stream[i]);
+  }
+  ssA.merge(ssB);
+  ASSERT_EQUAL(ssA.total(), static_cast<std::uint64_t>(N));
+  int mergeBad = 0;
+  for (int hot = 0; hot < 10; hot++) {
+    mergeBad += ssA.estimate(hot) < static_cast<std::uint64_t>(exact[hot]);
+  }
+  ASSERT_EQUAL(mergeBad, 0);
+  ASSERT_EQUAL(ssA.pop().size(), static_cast<size_t>(64));
+  ASSERT_TRUE(ssA.empty());
+
+  // misra gries: 低估不超过 error_bound
+  misra_gries<int> mg(64);
+  for (auto x : stream) {
+    mg.push(x);
+  }
+  ASSERT_TRUE(mg.error_bound() <= static_cast<std::uint64_t>(N / 65));
+  int mgBad = 0;
+  for (int hot = 0; hot < 10; hot++) {
+    auto est = mg.estimate(hot);
+    auto truth = static_cast<std::uint64_t>(exact[hot]);
+    mgBad += (est > truth || est + mg.error_bound() < truth);
+  }
+  ASSERT_EQUAL(mgBad, 0);
+  misra_gries<int> mgA(64), mgB(64);
+  for (int i = 0; i < N; i++) {
+    (i % 2 ? mgA : mgB).push(stream[i]);
+  }
+  mgA.merge(mgB);
+  ASSERT_TRUE(mgA.size() <= 64);
+  ASSERT_TRUE(mgA.estimate(0) + mgA.error_bound() >= static_cast<std::uint64_t>(exact[0]));
+
+  // count min: 从不低估, 误差在 epsilon * total 内
+  auto cms = count_min_sketch<int>::with_error(0.001, 0.01);
+  for (auto x : stream) {
+    cms.push(x);
+  }
+  int cmsBad = 0;
+  for (int x = 0; x <= 100000; x += 97) {
+    auto est = cms.estimate(x);
+    cmsBad += (est < static_cast<std::uint64_t>(exact[x]) || est > exact[x] + 0.001 * N);
+  }
+  ASSERT_EQUAL(cmsBad, 0);
+  auto cmsHalf = count_min_sketch<int>::with_error(0.001, 0.01);
+  cmsHalf.push(3, 5);
+  cms.merge(cmsHalf);
+  ASSERT_TRUE(cms.estimate(3) >= static_cast<std::uint64_t>(exact[3] + 5));
+  bool thrown = false;
+  try {
+    cms.merge(count_min_sketch<int>(16, 2));
+  } catch (const std::invalid_argument&) {
+    thrown = true;
+  }
+  ASSERT_TRUE(thrown);
+
+  // kll: 分位数的秩误差很小, 内存有界
+  std::vector<double> vals(N);
+  std::mt19937 gen(11);
+  std::normal_distribution<double> norm(0.0, 1.0);
+  for (auto& v : vals) {
+    v = norm(gen);
+  }
+  kll_sketch<double> kll;
+  kll_sketch<double> kllA, kllB;
+  for (int i = 0; i < N; i++) {
+    kll.push(vals[i]);
+    (i < N / 3 ? kllA : kllB).push(vals[i]);
+  }
+  kllA.merge(kllB);
+  auto sorted = vals;
+  std::sort(sorted.begin(), sorted.end());
+  auto trueRank = [&](double x) {
+    return static_cast<double>(std::upper_bound(sorted.begin(), sorted.end(), x) - sorted.begin()) / N;
+  };
+  ASSERT_EQUAL(kll.count(), static_cast<std::uint64_t>(N));
+  ASSERT_TRUE(kll.retained() < 1000);
+  int kllBad = 0;
+  std::vector<double> qs{0.01, 0.1, 0.25, 0.5, 0.75, 0.9, 0.99};
+  auto estA = kllA.quantiles(qs);
+  for (size_t i = 0; i < qs.size(); i++) {
+    kllBad += std::abs(trueRank(kll.quantile(qs[i])) - qs[i]) > 0.02;
+    kllBad += std::abs(trueRank(estA[i]) - qs[i]) > 0.02;
+    kllBad += std::abs(kll.rank(sorted[static_cast<size_t>(qs[i] * N)]) - qs[i]) > 0.02;
+  }
+  ASSERT_EQUAL(kllBad, 0);
+  // pop: 保留的元素有序, 权重之和等于输入个数, 之后为空
+  auto retained = kllA.retained();
+  auto popped = kllA.pop();
+  std::uint64_t weightSum = 0;
+  for (const auto& [x, w] : popped) {
+    weightSum += w;
+  }
+  ASSERT_EQUAL(popped.size(), retained);
+  ASSERT_EQUAL(weightSum, static_cast<std::uint64_t>(N));
+  ASSERT_TRUE(std::is_sorted(popped.begin(), popped.end()));
+  ASSERT_TRUE(kllA.empty() && kllA.retained() == 0);
+  kll.clear();
+  ASSERT_TRUE(kll.empty());
+
+  // 多线程: 每个线程写自己的 shard, 合并结果与单线程一致
+  concurrent_sketch<space_saving<int>> css(space_saving<int>(64), 4);
+  concurrent_sketch<count_min_sketch<int>> ccms(count_min_sketch<int>(4096, 4));
+  concurrent_sketch<kll_sketch<double>> ckll(kll_sketch<double>{});
+  std::vector<std::thread> ths;
+  for (int t = 0; t < 8; t++) {
+    ths.emplace_back([&, t] {
+      for (int i = t; i < N; i += 8) {
+        css.push(stream[i]);
+        ccms.push(stream[i]);
+        ckll.push(vals[i]);
+      }
+    });
+  }
+  for (auto& th : ths) {
+    th.join();
+  }
+  auto cssMerged = css.merged();
+  ASSERT_EQUAL(cssMerged.total(), static_cast<std::uint64_t>(N));
+  int concBad = 0;
+  for (int hot = 0; hot < 10; hot++) {
+    concBad += cssMerged.estimate(hot) < static_cast<std::uint64_t>(exact[hot]);
+    concBad += ccms.merged().estimate(hot) < static_cast<std::uint64_t>(exact[hot]);
+  }
+  ASSERT_EQUAL(concBad, 0);
+  auto ckllMerged = ckll.merged();
+  ASSERT_EQUAL(ckllMerged.count(), static_cast<std::uint64_t>(N));
+  ASSERT_TRUE(std::abs(trueRank(ckllMerged.quantile(0.5)) - 0.5) < 0.02);
+
+  return ASSERT_ALL_PASSED();
+}
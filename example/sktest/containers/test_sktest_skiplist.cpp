@@ -0,0 +1,106 @@
+#include <algorithm>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "skutils/containers/skiplist.h"
+#include "skutils/logger.h"
+#include "skutils/random.h"
+#include "skutils/test.h"
+
+using sk::utils::dts::SkipList;
+
+int main() {
+  SkipList<int, std::string> sl;
+  std::map<int, std::string> mp;
+  int mismatch = 0;
+  for (int i = 0; i < 20000; i++) {
+    int key = RANDTOOL.getRandomInt(0, 3000);
+    if (RANDTOOL.getRandomInt(0, 2) != 0) {
+      mismatch += mp.emplace(key, std::to_string(i)).second != sl.insert(key, std::to_string(i));
+    } else {
+      mismatch += (mp.erase(key) == 1) != sl.erase(key);
+    }
+  }
+  ASSERT_EQUAL(0, mismatch);
+  ASSERT_EQUAL(static_cast<int>(mp.size()), sl.size());
+  ASSERT_TRUE(std::all_of(mp.begin(), mp.end(), [&sl](auto& kv) { return sl[kv.first] == kv.second; }));
+  ASSERT_TRUE(sl.find(-1) == nullptr);
+
+  // 有序遍历
+  std::vector<int> keys;
+  for (auto& node : sl) {
+    keys.push_back(node.key);
+  }
+  std::vector<int> expected;
+  for (auto& [k, v] : mp) {
+    expected.push_back(k);
+  }
+  ASSERT_TRUE(keys == expected);
+
+  // 区间扫描
+  const auto& csl = sl;
+  keys.clear();
+  for (auto it = csl.lower_bound(1000); it != csl.end() && it->key < 2000; ++it) {
+    keys.push_back(it->key);
+  }
+  expected.clear();
+  for (auto it = mp.lower_bound(1000); it != mp.end() && it->first < 2000; ++it) {
+    expected.push_back(it->first);
+  }
+  ASSERT_TRUE(keys == expected);
+  auto ub = sl.upper_bound(mp.begin()->first);
+  ASSERT_EQUAL(std::next(mp.begin())->first, ub->key);
+  ASSERT_TRUE(sl.lower_bound(1 << 20) == sl.end());
+
+  // 删空后层数回落
+  for (auto& [k, v] : mp) {
+    sl.erase(k);
+  }
+  ASSERT_TRUE(sl.empty());
+  ASSERT_EQUAL(1, sl.level());
+  ASSERT_TRUE(sl.begin() == sl.end());
+
+  // 批量构建
+  std::vector<std::pair<int, int>> sorted;
+  for (int i = 0; i < 100000; i++) {
+    sorted.emplace_back(i * 2, i);
+  }
+  sorted.emplace_back(sorted.back());  // 重复 key 被跳过
+  sorted.emplace_back(1, 1);           // 乱序 key 走普通 insert
+  sorted.emplace_back(300000, 3);
+  SkipList<int, int> bulk;
+  ASSERT_EQUAL(size_t(100002), bulk.bulk_load(sorted));
+  ASSERT_EQUAL(100002, bulk.size());
+  ASSERT_TRUE(std::is_sorted(bulk.begin(), bulk.end(), [](auto& a, auto& b) { return a.key < b.key; }));
+  ASSERT_EQUAL(1, bulk[1]);
+  ASSERT_EQUAL(3, bulk[300000]);
+  ASSERT_EQUAL(size_t(2), bulk.bulk_load(std::vector<std::pair<int, int>>{{300002, 0}, {300004, 0}}));
+
+  std::vector<std::pair<int, int>> batch;
+  std::map<int, int> ref;
+  for (auto& node : bulk) {
+    ref.emplace(node.key, node.val);
+  }
+  for (int i = 0; i < 50000; i++) {
+    int key = RANDTOOL.getRandomInt(-1000, 400000);
+    batch.emplace_back(key, i);
+  }
+  size_t expectInserted = 0;
+  for (auto& [k, v] : batch) {
+    expectInserted += ref.emplace(k, v).second;
+  }
+  ASSERT_EQUAL(expectInserted, bulk.insert_batch(batch));
+  ASSERT_EQUAL(static_cast<int>(ref.size()), bulk.size());
+  ASSERT_TRUE(std::all_of(ref.begin(), ref.end(), [&bulk](auto& kv) { return bulk[kv.first] == kv.second; }));
+
+  auto queries = RANDTOOL.getRandomIntVector(20000, -2000, 402000);
+  auto found = bulk.find_batch(queries);
+  mismatch = 0;
+  for (size_t i = 0; i < queries.size(); i++) {
+    mismatch += found[i] != bulk.find(queries[i]);
+  }
+  ASSERT_EQUAL(0, mismatch);
+
+  return ASSERT_ALL_PASSED();
+}
@@ -0,0 +1,92 @@
+#include <string>
+#include <vector>
+
+#include "skutils/containers/sparse_graph.h"
+#include "skutils/containers/unionfind_set.h"
+#include "skutils/logger.h"
+#include "skutils/test.h"
+
+using namespace sk::utils::dts;
+
+template <typename G>
+std::vector<std::vector<int>> rows(const G &g) {
+  std::vector<std::vector<int>> ret(g.size());
+  for (int u = 0; u < g.size(); u++) {
+    g.forEachNeighbor(u, [&](int v, int w) {
+      ret[u].push_back(v);
+      ret[u].push_back(w);
+    });
+  }
+  return ret;
+}
+
+int main() {
+  // 有向带权图: builder 按目标排序, 每行在内存中连续
+  CsrGraph<std::string>::Builder builder(std::vector<std::string>{"A", "B", "C", "D"}, true);
+  builder.addEdge(0, 3, 2).addEdge(0, 1, 5).addEdge(1, 2, 3).addEdge(3, 2, 4);
+  auto csr = std::move(builder).build();
+  ASSERT_EQUAL(4, csr.size());
+  ASSERT_EQUAL(size_t(4), csr.edgeCount());
+  ASSERT_TRUE(csr.isWeighted());
+  ASSERT_STR_EQUAL((std::vector<int>{1, 3}), std::vector<int>(csr.neighbors(0).begin(), csr.neighbors(0).end()));
+  ASSERT_STR_EQUAL((std::vector<int>{5, 2}), std::vector<int>(csr.weightsOf(0).begin(), csr.weightsOf(0).end()));
+  ASSERT_EQUAL(0, csr.degree(2));
+  ASSERT_TRUE(csr.neighbors(0).data() + 2 == csr.neighbors(1).data());
+
+  // 转置: 入边
+  auto rev = csr.transpose();
+  ASSERT_STR_EQUAL((std::vector<int>{1, 3, 3, 4}), rows(rev)[2]);
+
+  // 矩阵 <-> CSR <-> 邻接表 互相转换, 边集不变
+  Graph<std::string> dense = csr.toMatrix();
+  ASSERT_EQUAL(5, dense.edges[0][1]);
+  ASSERT_EQUAL(graphConst::dummyValue, dense.edges[1][0]);
+  CsrGraph<std::string> fromDense(dense);
+  AdjListGraph<std::string> adj(fromDense);
+  CsrGraph<std::string> fromAdj(adj);
+  ASSERT_STR_EQUAL(rows(csr), rows(fromDense));
+  ASSERT_STR_EQUAL(rows(csr), rows(adj));
+  ASSERT_STR_EQUAL(rows(csr), rows(fromAdj));
+  ASSERT_STR_EQUAL(rows(csr), rows(AdjListGraph<std::string>(dense)));
+
+  // 无向无权图: 每条边双向存储, 不保存权重数组
+  CsrGraph<int>::Builder ub(5);
+  ub.addEdge(0, 1).addEdge(1, 2).addEdge(3, 3);
+  auto ucsr = std::move(ub).build();
+  ASSERT_EQUAL(size_t(5), ucsr.edgeCount());
+  ASSERT_TRUE(!ucsr.isWeighted());
+  ASSERT_STR_EQUAL((std::vector<int>{0, 1, 2, 3, 4}), ucsr.nodes);
+  ASSERT_STR_EQUAL((std::vector<int>{0, 1, 2, 1}), rows(ucsr)[1]);
+  auto udense = ucsr.toMatrix();
+  ASSERT_EQUAL(1, udense.edges[2][1]);
+  ASSERT_STR_EQUAL(rows(ucsr), rows(CsrGraph<int>(udense)));
+
+  // 邻接表动态增长
+  AdjListGraph<int> grow;
+  grow.addNode(10).addNode(20).addNode(30);
+  grow.addEdge(0, 2, 7);
+  ASSERT_EQUAL(size_t(2), grow.edgeCount());
+  ASSERT_EQUAL(7, grow.neighbors(2)[0].weight);
+
+  // 并查集接受各种表示, 结果与矩阵一致
+  ASSERT_EQUAL(3, UnionFindSet<int>(ucsr).count());
+  ASSERT_EQUAL(3, UnionFindSet<int>(AdjListGraph<int>(ucsr)).count());
+  ASSERT_EQUAL(3, UnionFindSet<int>(udense).count());
+  ASSERT_EQUAL(1, UnionFindSet<std::string>(csr).count());
+  ASSERT_EQUAL(1, UnionFindSet<std::string>(adj).count());
+  ASSERT_EQUAL(2, UnionFindSet<int>(grow).count());
+
+  // 随机图: 稀疏表示不分配 n*n 矩阵
+  auto big = buildRandomGraph<CsrGraph<int>>(1'000'000);
+  ASSERT_EQUAL(1'000'000, big.size());
+  // 3M 条无向边双向存储, 自环只存一次
+  ASSERT_TRUE(big.edgeCount() <= 6'000'000 && big.edgeCount() > 5'990'000);
+  auto smallCsr = buildRandomGraph<CsrGraph<int>>(50, true, false, 1, 9);
+  auto smallAdj = buildRandomGraph<AdjListGraph<int>>(50, false);
+  auto smallDense = buildRandomGraph<Graph<int>>(50);
+  ASSERT_EQUAL(size_t(150), smallCsr.edgeCount());
+  ASSERT_TRUE(smallAdj.edgeCount() <= 300);
+  ASSERT_EQUAL(UnionFindSet<int>(smallDense).count(), UnionFindSet<int>(CsrGraph<int>(smallDense)).count());
+
+  return ASSERT_ALL_PASSED();
+}
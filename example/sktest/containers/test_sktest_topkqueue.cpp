@@ -1,7 +1,13 @@
+#include <algorithm>
+#include <atomic>
+#include <random>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "skutils/containers/heap.h"
 #include "skutils/containers/topk_queue.h"
+#include "skutils/logger.h"
 #include "skutils/test.h"
 
 int main() {
@@ -22,5 +28,114 @@ int main() {
   ASSERT_STR_EQUAL(correct_top_k, tbq.pop_top());
   ASSERT_STR_EQUAL(correct_bottom_k, tbq.pop_bottom());
 
+  // 被 move 走的队列仍然可用, 只是变空
+  sk::utils::dts::topk_queue<int> mq(3, 2);
+  for (auto x : vc) {
+    mq.push(x);
+  }
+  auto moved = std::move(mq);
+  mq.push(5);
+  mq.push(7);
+  ASSERT_STR_EQUAL((std::vector<int>{7, 5}), mq.pop());
+  ASSERT_STR_EQUAL((std::vector<int>{15, 14, 13}), moved.pop());
+  mq = std::move(moved);
+  moved.push(1);
+  ASSERT_STR_EQUAL((std::vector<int>{1}), moved.pop());
+
+  // 多线程并发 push, 结果与单线程一致
+  constexpr int N = 200000;
+  std::vector<int> vals(N);
+  for (int i = 0; i < N; i++) {
+    vals[i] = i;
+  }
+  std::shuffle(vals.begin(), vals.end(), std::mt19937(42));
+  sk::utils::dts::topbottomk_queue<int> ctbq(10);
+  sk::utils::dts::topk_queue<std::string> stq(3);
+  std::vector<std::thread> ths;
+  for (int t = 0; t < 8; t++) {
+    ths.emplace_back([&, t] {
+      for (int i = t; i < N; i += 8) {
+        ctbq.push(vals[i]);
+        if (i % 1000 == 0) {
+          stq.push(std::to_string(vals[i]));
+        }
+      }
+    });
+  }
+  for (auto& th : ths) {
+    th.join();
+  }
+  std::vector<int> top10;
+  std::vector<int> bottom10;
+  for (int i = 0; i < 10; i++) {
+    top10.push_back(N - 1 - i);
+    bottom10.push_back(i);
+  }
+  ASSERT_STR_EQUAL(top10, ctbq.pop_top());
+  ASSERT_STR_EQUAL(bottom10, ctbq.pop_bottom());
+  ASSERT_TRUE(ctbq.pop_top().empty());
+
+  auto strs = stq.pop();
+  ASSERT_EQUAL(size_t(3), strs.size());
+  ASSERT_TRUE(std::is_sorted(strs.rbegin(), strs.rend()));
+
+  // key 投影: 每个元素只算一次 key, 堆里只比较缓存的 key
+  std::atomic<int> keyCalls{0};
+  auto byLength = [&keyCalls](const std::string& s) {
+    keyCalls++;
+    return s.size();
+  };
+  sk::utils::dts::topbottomk_queue<std::string, decltype(byLength)> ktbq(2, byLength);
+  std::vector<std::string> words{"ccc", "a", "eeeee", "dddd", "bb", "ffffff"};
+  for (const auto& w : words) {
+    ktbq.push(w);
+  }
+  ASSERT_EQUAL(static_cast<int>(words.size()), keyCalls.load());
+  ASSERT_STR_EQUAL((std::vector<std::string>{"ffffff", "eeeee"}), ktbq.pop_top());
+  auto shortest = ktbq.pop_bottom_with_keys();
+  ASSERT_EQUAL(size_t(2), shortest.size());
+  ASSERT_TRUE(shortest[0].first == 1 && shortest[0].second == "a");
+  ASSERT_TRUE(shortest[1].first == 2 && shortest[1].second == "bb");
+
+  // 带捕获的 lambda 投影不可默认构造, 拷贝和 move 仍然可用
+  size_t bias = 10;
+  auto biased = [bias](const std::string& s) { return s.size() + bias; };
+  sk::utils::dts::topk_queue<std::string, decltype(biased)> bq(2, biased);
+  for (const auto& w : words) {
+    bq.push(w);
+  }
+  auto bqCopy = bq;
+  auto bqMoved = std::move(bq);
+  bq.push("zz");
+  ASSERT_STR_EQUAL((std::vector<std::string>{"zz"}), bq.pop());
+  ASSERT_STR_EQUAL((std::vector<std::string>{"ffffff", "eeeee"}), bqCopy.pop());
+  auto biasedKeys = bqMoved.pop_with_keys();
+  ASSERT_EQUAL(size_t(2), biasedKeys.size());
+  ASSERT_TRUE(biasedKeys[0].first == 16 && biasedKeys[1].first == 15);
+
+  // 并发 push 带 key 的元素, 阈值按 key 类型 (int) 快速拒绝
+  struct Payload {
+    int id;
+    std::string name;
+  };
+  auto byId = [](const Payload& p) { return p.id; };
+  sk::utils::dts::topk_queue<Payload, decltype(byId)> pq(5, byId);
+  ths.clear();
+  for (int t = 0; t < 4; t++) {
+    ths.emplace_back([&, t] {
+      for (int i = t; i < N; i += 4) {
+        pq.push({vals[i], "p"});
+      }
+    });
+  }
+  for (auto& th : ths) {
+    th.join();
+  }
+  std::vector<int> ids;
+  for (auto& p : pq.pop()) {
+    ids.push_back(p.id);
+  }
+  ASSERT_STR_EQUAL((std::vector<int>{N - 1, N - 2, N - 3, N - 4, N - 5}), ids);
+
   return ASSERT_ALL_PASSED();
 }
\ No newline at end of file
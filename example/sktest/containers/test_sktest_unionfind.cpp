@@ -0,0 +1,133 @@
+#include <string>
+#include <vector>
+
+#include "skutils/containers/graph_generators.h"
+#include "skutils/containers/unionfind_set.h"
+#include "skutils/logger.h"
+#include "skutils/test.h"
+
+using namespace sk::utils::dts;
+
+int main() {
+  // 顺序并查集: 一百万长度的链, 迭代查找不会爆栈
+  const int N = 1'000'000;
+  UnionFindSet<int> chain(N);
+  for (int i = 1; i < N; i++) {
+    chain.connect(i - 1, i);
+  }
+  ASSERT_EQUAL(1, chain.count());
+  ASSERT_TRUE(chain.isConnected(0, N - 1));
+  // 按秩合并: 链被压成常数高度
+  int hops = 0;
+  for (int x = N - 1, p = x; (p = chain.find(x)) != x; x = p) {
+    hops++;
+  }
+  ASSERT_TRUE(hops <= 1);
+  ASSERT_EQUAL(N, chain.add());
+  ASSERT_EQUAL(2, chain.count());
+  ASSERT_TRUE(!chain.isConnected(0, N));
+
+  // 泛型版本: 哈希到下标
+  UnionFindSet<std::string> words;
+  words.add("a", "b");
+  words.add("c", "d");
+  words.add("e");
+  ASSERT_EQUAL(3, words.count());
+  words.connect("b", "d");
+  ASSERT_EQUAL(2, words.count());
+  ASSERT_TRUE(words.isConnected("a", "c"));
+  ASSERT_TRUE(words.find("a") == words.find("d"));
+  ASSERT_TRUE(!words.isConnected("a", "e"));
+  bool thrown = false;
+  try {
+    words.find("z");
+  } catch (const std::out_of_range &) {
+    thrown = true;
+  }
+  ASSERT_TRUE(thrown);
+  ASSERT_STR_EQUAL(std::string{"[]"}, UnionFindSet<std::string>().toString());
+
+  // 并发并查集: 多线程合并, 结果与顺序版本一致
+  const int n = 1 << 18;
+  auto edges = rmatEdges(18, 2, 5);
+  sk::utils::ThreadPool pool(4);
+  ConcurrentUnionFindSet cuf(n);
+  std::vector<std::future<void>> fus;
+  const size_t per = edges.size() / 4;
+  for (size_t t = 0; t < 4; t++) {
+    fus.emplace_back(pool.submit([&, t] {
+      for (size_t i = t * per; i < (t + 1) * per; i++) {
+        cuf.connect(edges[i].from, edges[i].to);
+      }
+    }));
+  }
+  for (auto &fu : fus) {
+    fu.get();
+  }
+  UnionFindSet<int> seq(n);
+  for (const auto &e : edges) {
+    seq.connect(e.from, e.to);
+  }
+  ASSERT_EQUAL(seq.count(), cuf.count());
+  int bad = 0;
+  for (int i = 0; i < 1000; i++) {
+    const auto &e = edges[i * 37];
+    bad += !cuf.isConnected(e.from, e.to);
+    bad += cuf.isConnected(e.from, (e.to + 1) % n) != seq.isConnected(e.from, (e.to + 1) % n);
+  }
+  ASSERT_EQUAL(0, bad);
+  auto labels = cuf.components(&pool);
+  for (int v = 0; v < n; v++) {
+    bad += labels[v] > v || labels[labels[v]] != labels[v] || seq.find(v) != seq.find(labels[v]);
+  }
+  ASSERT_EQUAL(0, bad);
+  ASSERT_TRUE(!cuf.connect(edges[0].from, edges[0].to));
+
+  // 批量接口: 串行与线程池结果一致, components 与并发版本的标签一致
+  std::vector<std::pair<int, int>> pairs;
+  pairs.reserve(edges.size());
+  for (const auto &e : edges) {
+    pairs.emplace_back(e.from, e.to);
+  }
+  UnionFindSet<int> batched(n);
+  batched.connectBatch(pairs, &pool);
+  ASSERT_EQUAL(seq.count(), batched.count());
+  ASSERT_TRUE(labels == batched.components());
+  ASSERT_TRUE(labels == seq.components());
+  ConcurrentUnionFindSet cbatched(n);
+  ASSERT_EQUAL(n - seq.count(), cbatched.connectBatch(pairs, &pool));
+  std::vector<std::pair<int, int>> queries;
+  for (int i = 0; i < 100'000; i++) {
+    queries.emplace_back(i, (i * 7919) % n);
+  }
+  auto answers = batched.isConnected(queries, &pool);
+  auto cAnswers = cbatched.isConnected(queries);
+  for (size_t i = 0; i < queries.size(); i++) {
+    bool expect = labels[queries[i].first] == labels[queries[i].second];
+    bad += answers[i] != expect || cAnswers[i] != expect;
+  }
+  ASSERT_EQUAL(0, bad);
+
+  // 并行批量合并后秩仍然有效: 新的单点挂到已有的树下, 而不是反过来
+  std::vector<std::pair<int, int>> path;
+  for (int i = 0; i + 1 < n; i++) {
+    path.emplace_back(i, i + 1);
+  }
+  UnionFindSet<int> linked(n);
+  linked.connectBatch(path, &pool);
+  int single = linked.add();
+  linked.connect(single, n - 1);
+  ASSERT_EQUAL(0, linked.find(single));
+  ASSERT_EQUAL(0, linked.find(n - 1));
+
+  // toString: 每棵树一行, 孩子按下标排列
+  UnionFindSet<int> small(6);
+  small.connect(0, 1).connect(0, 2).connect(3, 1);
+  ASSERT_STR_EQUAL(std::string{"0-(1,2,3)\n4\n5\n"}, small.toString());
+  UnionFindSet<std::string> names;
+  names.add("x", "y");
+  names.add("z");
+  ASSERT_STR_EQUAL(std::string{"x-(y)\nz\n"}, names.toString());
+
+  return ASSERT_ALL_PASSED();
+}
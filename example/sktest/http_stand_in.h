@@ -0,0 +1,129 @@
+#ifndef SK_TEST_HTTP_STAND_IN_H
+#define SK_TEST_HTTP_STAND_IN_H
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+// test_curl_* 共用的本地 HTTP 替身: 每个连接一个线程, 支持 keep-alive,
+// 统计连接数, 请求数和同时在处理的请求数的峰值
+class HttpStandIn {
+  public:
+  // 收到完整请求头后调用, 返回 (状态行之后的额外头, body, 状态码)
+  struct Reply {
+    int status{200};
+    std::string headers;
+    std::string body;
+  };
+
+  using Handler = std::function<Reply(const std::string& request)>;
+
+  std::atomic<int> connections{0};
+  std::atomic<int> requests{0};
+  std::atomic<int> peakInFlight{0};
+  std::atomic<int> delayMs{0};
+
+  explicit HttpStandIn(Handler handler) : handler_(std::move(handler)) {
+    fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    int one = 1;
+    setsockopt(fd_, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    sockaddr_in addr{};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+    socklen_t len = sizeof(addr);
+    getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+    listen(fd_, 64);
+    acceptor_ = std::thread([this] { Accept(); });
+  }
+
+  ~HttpStandIn() {
+    shutdown(fd_, SHUT_RDWR);
+    close(fd_);
+    acceptor_.join();
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      for (int conn : conns_) {
+        shutdown(conn, SHUT_RDWR);
+      }
+    }
+    for (auto& t : workers_) {
+      t.join();
+    }
+    for (int conn : conns_) {
+      close(conn);
+    }
+  }
+
+  std::string Url(const std::string& path) const { return "http://127.0.0.1:" + std::to_string(port_) + path; }
+
+  private:
+  void Accept() {
+    while (true) {
+      int conn = accept(fd_, nullptr, nullptr);
+      if (conn < 0) {
+        return;
+      }
+      connections++;
+      std::lock_guard<std::mutex> lock(mtx_);
+      conns_.push_back(conn);
+      workers_.emplace_back([this, conn] { Serve(conn); });
+    }
+  }
+
+  void Serve(int conn) {
+    std::string buffer;
+    char chunk[4096];
+    while (true) {
+      auto end = buffer.find("\r\n\r\n");
+      if (end == std::string::npos) {
+        auto n = recv(conn, chunk, sizeof(chunk), 0);
+        if (n <= 0) {
+          break;
+        }
+        buffer.append(chunk, n);
+        continue;
+      }
+      std::string request = buffer.substr(0, end + 4);
+      buffer.erase(0, end + 4);
+      requests++;
+      int now = ++inFlight_;
+      for (int peak = peakInFlight; now > peak && !peakInFlight.compare_exchange_weak(peak, now);) {}
+      std::this_thread::sleep_for(std::chrono::milliseconds(delayMs.load()));
+      Reply reply = handler_(request);
+      --inFlight_;
+      std::string response = "HTTP/1.1 " + std::to_string(reply.status) + " X\r\n" + reply.headers +
+                             "Content-Length: " + std::to_string(reply.body.size()) + "\r\n\r\n";
+      // HEAD 只回头部, Content-Length 仍是 GET 时 body 的长度
+      if (request.compare(0, 5, "HEAD ") != 0) {
+        response += reply.body;
+      }
+      if (reply.status == 304) {
+        response = "HTTP/1.1 304 Not Modified\r\n" + reply.headers + "\r\n";
+      }
+      send(conn, response.data(), response.size(), MSG_NOSIGNAL);
+    }
+  }
+
+  Handler handler_;
+  int fd_;
+  int port_;
+  std::atomic<int> inFlight_{0};
+  std::thread acceptor_;
+  std::mutex mtx_;
+  std::vector<int> conns_;
+  std::vector<std::thread> workers_;
+};
+
+#endif  // SK_TEST_HTTP_STAND_IN_H
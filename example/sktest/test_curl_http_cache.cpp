@@ -0,0 +1,114 @@
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <mutex>
+#include <string>
+
+#include "http_stand_in.h"
+#include "skutils/logger.h"
+#include "skutils/net_tools.h"
+#include "skutils/test.h"
+
+// 发布信息的替身: 返回固定 body 和 ETag, If-None-Match 命中时回 304, 可切换成 403 模拟限流
+struct Release {
+  std::mutex mtx;
+  std::string body{R"({"tag_name":"v1.0"})"};
+  std::string etag{"\"v1\""};
+  std::atomic<bool> rateLimited{false};
+  std::atomic<int> notModified{0};
+
+  void Set(std::string b, std::string e) {
+    std::lock_guard<std::mutex> lock(mtx);
+    body = std::move(b);
+    etag = std::move(e);
+  }
+
+  HttpStandIn::Reply Serve(const std::string& request) {
+    std::lock_guard<std::mutex> lock(mtx);
+    if (rateLimited) {
+      return {403, "", "{}"};
+    }
+    if (request.find("If-None-Match: " + etag) != std::string::npos) {
+      notModified++;
+      return {304, "ETag: " + etag + "\r\n", ""};
+    }
+    return {200, "ETag: " + etag + "\r\n", body};
+  }
+};
+
+int main() {
+  using namespace std::chrono_literals;
+  auto dir = fs::temp_directory_path() / ("sk_http_cache_" + std::to_string(getpid()));
+  fs::remove_all(dir);
+  Release release;
+  HttpStandIn server([&release](const std::string& request) { return release.Serve(request); });
+  const auto url = server.Url("/repos/a/b/releases/latest");
+
+  HttpDiskCache cache(dir, 1h);
+  ASSERT_TRUE(!cache.Load("a/b").has_value());
+
+  // 第一次: 真正请求并落盘
+  auto [body, code] = cache.Fetch("a/b", url).get();
+  ASSERT_EQUAL(std::int64_t{200}, code);
+  ASSERT_STR_EQUAL(std::string{R"({"tag_name":"v1.0"})"}, body);
+  ASSERT_EQUAL(1, server.requests.load());
+  auto stored = cache.Load("a/b");
+  ASSERT_TRUE(stored.has_value());
+  ASSERT_STR_EQUAL(std::string{"\"v1\""}, stored->etag);
+  ASSERT_TRUE(cache.PathOf("a/b").parent_path() == dir);
+
+  // TTL 内: 不发请求
+  ASSERT_STR_EQUAL(body, cache.Fetch("a/b", url).get().first);
+  ASSERT_EQUAL(1, server.requests.load());
+
+  // TTL 过期: 带 ETag 的条件请求, 304 时沿用缓存的 body
+  HttpDiskCache stale(dir, 0s);
+  auto revalidated = stale.Fetch("a/b", url).get();
+  ASSERT_EQUAL(std::int64_t{200}, revalidated.second);
+  ASSERT_STR_EQUAL(body, revalidated.first);
+  ASSERT_EQUAL(2, server.requests.load());
+  ASSERT_EQUAL(1, release.notModified.load());
+
+  // 内容变化: 拿到新 body 和新 ETag
+  release.Set(R"({"tag_name":"v2.0"})", "\"v2\"");
+  ASSERT_STR_EQUAL(std::string{R"({"tag_name":"v2.0"})"}, stale.Fetch("a/b", url).get().first);
+  ASSERT_STR_EQUAL(std::string{"\"v2\""}, cache.Load("a/b")->etag);
+
+  // 被限流时返回旧缓存
+  release.rateLimited = true;
+  auto limited = stale.Fetch("a/b", url).get();
+  ASSERT_EQUAL(std::int64_t{200}, limited.second);
+  ASSERT_STR_EQUAL(std::string{R"({"tag_name":"v2.0"})"}, limited.first);
+  // 没有缓存时原样返回错误码
+  ASSERT_EQUAL(std::int64_t{403}, stale.Fetch("c/d", url).get().second);
+  release.rateLimited = false;
+
+  // 离线模式: 从不联网
+  int before = server.requests.load();
+  HttpDiskCache offline(dir, 0s, true);
+  ASSERT_STR_EQUAL(std::string{R"({"tag_name":"v2.0"})"}, offline.Fetch("a/b", url).get().first);
+  ASSERT_EQUAL(AsyncDownloader::OFFLINE_MISS_CODE, offline.Fetch("x/y", url).get().second);
+  ASSERT_EQUAL(before, server.requests.load());
+
+  // 缓存文件损坏时当作没有缓存
+  {
+    std::ofstream broken(cache.PathOf("e/f"));
+    broken << "only-one-line";
+  }
+  ASSERT_TRUE(!cache.Load("e/f").has_value());
+
+  // 只差一个被替换字符的 key 不能共用缓存文件
+  ASSERT_TRUE(cache.PathOf("a/b") != cache.PathOf("a_b"));
+  ASSERT_TRUE(!cache.Load("a_b").has_value());
+  ASSERT_TRUE(cache.Store("a_b", {"other", "\"o\"", 0}));
+  ASSERT_STR_EQUAL(std::string{"\"v2\""}, cache.Load("a/b")->etag);
+  ASSERT_STR_EQUAL(std::string{"other"}, cache.Load("a_b")->body);
+  // 文件里存的 key 与请求的不同时当作没有缓存
+  fs::copy_file(cache.PathOf("a_b"), cache.PathOf("g/h"));
+  ASSERT_TRUE(!cache.Load("g/h").has_value());
+
+  fs::remove_all(dir);
+  return ASSERT_ALL_PASSED();
+}
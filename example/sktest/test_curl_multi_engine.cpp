@@ -0,0 +1,94 @@
+#include <unistd.h>
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <future>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "http_stand_in.h"
+#include "skutils/logger.h"
+#include "skutils/net_tools.h"
+#include "skutils/test.h"
+
+int main() {
+  HttpStandIn server([](const std::string& request) -> HttpStandIn::Reply {
+    if (request.find("If-None-Match: \"same\"") != std::string::npos) {
+      return {304, "ETag: \"same\"\r\n", ""};
+    }
+    auto path = request.substr(4, request.find(' ', 4) - 4);  // "GET <path> HTTP/1.1"
+    return {200, "ETag: \"same\"\r\n", "body of " + path};
+  });
+
+  // 并发上限为 1: 所有请求排队复用同一个连接
+  AsyncDownloader::SetMaxConcurrency(1);
+  std::vector<std::future<std::pair<std::string, std::int64_t>>> fus;
+  for (int i = 0; i < 20; i++) {
+    fus.push_back(AsyncDownloader::FetchAsString(server.Url("/item/" + std::to_string(i))));
+  }
+  int bad = 0;
+  for (int i = 0; i < 20; i++) {
+    auto [body, code] = fus[i].get();
+    bad += code != 200 || body != "body of /item/" + std::to_string(i);
+  }
+  ASSERT_EQUAL(0, bad);
+  ASSERT_EQUAL(20, server.requests.load());
+  ASSERT_EQUAL(1, server.connections.load());
+
+  // 并发上限为 3: 服务端同时最多看到 3 个请求
+  AsyncDownloader::SetMaxConcurrency(3);
+  ASSERT_EQUAL(size_t{3}, CurlMultiEngine::Instance().MaxConcurrency());
+  server.delayMs = 100;
+  auto start = std::chrono::steady_clock::now();
+  fus.clear();
+  for (int i = 0; i < 12; i++) {
+    fus.push_back(AsyncDownloader::FetchAsString(server.Url("/slow/" + std::to_string(i))));
+  }
+  for (auto& fu : fus) {
+    bad += fu.get().second != 200;
+  }
+  auto elapsed = std::chrono::steady_clock::now() - start;
+  server.delayMs = 0;
+  ASSERT_EQUAL(0, bad);
+  ASSERT_EQUAL(3, server.peakInFlight.load());
+  // 12 个 100ms 的请求, 3 路并发至少 4 轮
+  ASSERT_TRUE(elapsed >= std::chrono::milliseconds(400));
+  ASSERT_TRUE(server.connections.load() <= 4);
+
+  // 条件请求和回调
+  std::promise<AsyncDownloader::Response> done;
+  AsyncDownloader::FetchConditional(server.Url("/cond"), "\"same\"",
+                                    [&done](AsyncDownloader::Response r) { done.set_value(std::move(r)); });
+  auto cond = done.get_future().get();
+  ASSERT_EQUAL(std::int64_t{304}, cond.code);
+  ASSERT_STR_EQUAL(std::string{"\"same\""}, cond.etag);
+  ASSERT_TRUE(cond.body.empty());
+
+  // 下载到文件
+  auto dir = fs::temp_directory_path() / ("sk_curl_engine_" + std::to_string(getpid()));
+  auto [ok, fileCode] = AsyncDownloader::DownloadToFile(server.Url("/files/asset.tar.gz"), dir).get();
+  ASSERT_TRUE(ok);
+  ASSERT_EQUAL(std::int64_t{200}, fileCode);
+  std::ifstream in(dir / "asset.tar.gz");
+  std::stringstream content;
+  content << in.rdbuf();
+  ASSERT_STR_EQUAL(std::string{"body of /files/asset.tar.gz"}, content.str());
+  fs::remove_all(dir);
+
+  // 并发上限 0 按 1 处理, 传输照常完成
+  {
+    CurlMultiEngine engine(0);
+    ASSERT_EQUAL(size_t{1}, engine.MaxConcurrency());
+    std::promise<std::int64_t> code;
+    engine.Perform([&server](CURL* curl) { curl_easy_setopt(curl, CURLOPT_URL, server.Url("/zero").c_str()); },
+                   [&code](CURL*, CURLcode, std::int64_t http_code) { code.set_value(http_code); });
+    ASSERT_EQUAL(std::int64_t{200}, code.get_future().get());
+  }
+
+  // 连不上时返回负数错误码
+  ASSERT_TRUE(AsyncDownloader::FetchAsString("http://127.0.0.1:1/unreachable").get().second < 0);
+
+  return ASSERT_ALL_PASSED();
+}
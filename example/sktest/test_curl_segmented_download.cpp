@@ -0,0 +1,221 @@
+#include <unistd.h>
+
+#include <atomic>
+#include <filesystem>
+#include <fstream>
+#include <mutex>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "http_stand_in.h"
+#include "skutils/logger.h"
+#include "skutils/net_tools.h"
+#include "skutils/sha256.h"
+#include "skutils/test.h"
+
+// 支持 Range 的文件替身: HEAD 回大小和 Accept-Ranges, Range 请求回 206, 可让靠后的分段回 503 模拟中断
+struct Asset {
+  std::mutex mtx;
+  std::string content;
+  std::string etag{"\"v1\""};
+  std::string lastModified;
+  std::atomic<bool> rangesSupported{true};
+  std::atomic<std::int64_t> failFrom{-1};
+  std::vector<std::int64_t> rangeStarts;
+
+  void Set(std::string c, std::string e, std::string m = "") {
+    std::lock_guard<std::mutex> lock(mtx);
+    content = std::move(c);
+    etag = std::move(e);
+    lastModified = std::move(m);
+  }
+
+  std::vector<std::int64_t> TakeRangeStarts() {
+    std::lock_guard<std::mutex> lock(mtx);
+    return std::exchange(rangeStarts, {});
+  }
+
+  HttpStandIn::Reply Serve(const std::string& request) {
+    std::lock_guard<std::mutex> lock(mtx);
+    std::string headers;
+    if (!etag.empty()) {
+      headers += "ETag: " + etag + "\r\n";
+    }
+    if (!lastModified.empty()) {
+      headers += "Last-Modified: " + lastModified + "\r\n";
+    }
+    if (!rangesSupported) {
+      return {200, headers, content};
+    }
+    headers += "Accept-Ranges: bytes\r\n";
+    auto pos = request.find("\r\nRange: bytes=");
+    if (pos == std::string::npos) {
+      return {200, headers, content};
+    }
+    std::int64_t first = 0;
+    std::int64_t last = 0;
+    char dash = 0;
+    std::istringstream(request.substr(pos + 15)) >> first >> dash >> last;
+    rangeStarts.push_back(first);
+    if (failFrom >= 0 && first >= failFrom) {
+      return {503, "", "busy"};
+    }
+    const auto& validator = etag.empty() ? lastModified : etag;
+    if (request.find("If-Range: ") != std::string::npos &&
+        request.find("If-Range: " + validator + "\r\n") == std::string::npos) {
+      return {200, headers, content};
+    }
+    headers += "Content-Range: bytes " + std::to_string(first) + "-" + std::to_string(last) + "/" +
+               std::to_string(content.size()) + "\r\n";
+    return {206, headers, content.substr(first, last - first + 1)};
+  }
+};
+
+std::string RandomBytes(size_t n, unsigned seed) {
+  std::mt19937 gen(seed);
+  std::string s(n, '\0');
+  for (auto& c : s) {
+    c = static_cast<char>(gen());
+  }
+  return s;
+}
+
+std::string ReadAll(const fs::path& path) {
+  std::ifstream in(path, std::ios::binary);
+  std::stringstream ss;
+  ss << in.rdbuf();
+  return ss.str();
+}
+
+int main() {
+  using sk::utils::Sha256;
+  // 标准测试向量
+  ASSERT_STR_EQUAL(std::string{"e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855"}, Sha256::of(""));
+  ASSERT_STR_EQUAL(std::string{"ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad"}, Sha256::of("abc"));
+  ASSERT_STR_EQUAL(std::string{"248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1"},
+                   Sha256::of("abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq"));
+  ASSERT_STR_EQUAL(std::string{"cdc76e5c9914fb9281a1c7e284d73e67f1809a48a497200e046d39ccc7112cd0"},
+                   Sha256::of(std::string(1000000, 'a')));
+  // 分块 update 与一次性计算一致
+  auto random = RandomBytes(100000, 7);
+  Sha256 chunked;
+  for (size_t i = 0, step = 1; i < random.size(); i += step, step = step * 3 % 257 + 1) {
+    chunked.update(std::string_view(random).substr(i, step));
+  }
+  ASSERT_STR_EQUAL(Sha256::of(random), chunked.hexDigest());
+
+  Asset asset;
+  asset.content = RandomBytes((1 << 20) + 12345, 42);
+  HttpStandIn server([&asset](const std::string& request) { return asset.Serve(request); });
+  auto dir = fs::temp_directory_path() / ("sk_curl_segmented_" + std::to_string(getpid()));
+  fs::remove_all(dir);
+  AsyncDownloader::SetMaxConcurrency(8);
+
+  // 4 个分段并行下载, 校验通过后删除进度文件
+  SegmentedDownloadOptions options{4, 128 << 10, Sha256::of(asset.content)};
+  server.delayMs = 50;
+  auto [ok, code] = AsyncDownloader::DownloadSegmented(server.Url("/files/asset.bin"), dir, options).get();
+  server.delayMs = 0;
+  ASSERT_TRUE(ok);
+  ASSERT_EQUAL(std::int64_t{206}, code);
+  ASSERT_TRUE(ReadAll(dir / "asset.bin") == asset.content);
+  ASSERT_EQUAL(size_t{4}, asset.TakeRangeStarts().size());
+  ASSERT_TRUE(server.peakInFlight.load() >= 2);
+  ASSERT_TRUE(!fs::exists(dir / "asset.bin.part"));
+
+  // 后两段失败: 保留进度文件, 再次下载只请求缺的分段
+  const auto half = static_cast<std::int64_t>(asset.content.size() / 2);
+  const auto resumeUrl = server.Url("/files/resume.bin");
+  asset.failFrom = half;
+  auto failed = AsyncDownloader::DownloadSegmented(resumeUrl, dir, options).get();
+  ASSERT_TRUE(!failed.first);
+  ASSERT_EQUAL(std::int64_t{503}, failed.second);
+  ASSERT_TRUE(fs::exists(dir / "resume.bin.part"));
+  ASSERT_EQUAL(size_t{4}, asset.TakeRangeStarts().size());
+  asset.failFrom = -1;
+  auto resumed = AsyncDownloader::DownloadSegmented(resumeUrl, dir, options).get();
+  ASSERT_TRUE(resumed.first);
+  auto starts = asset.TakeRangeStarts();
+  ASSERT_EQUAL(size_t{2}, starts.size());
+  ASSERT_TRUE(starts[0] >= half && starts[1] >= half);
+  ASSERT_TRUE(ReadAll(dir / "resume.bin") == asset.content);
+  ASSERT_TRUE(!fs::exists(dir / "resume.bin.part"));
+
+  // 两次之间文件变了(ETag 不同): 进度作废, 从头下载
+  asset.failFrom = half;
+  ASSERT_TRUE(!AsyncDownloader::DownloadSegmented(resumeUrl, dir, options).get().first);
+  asset.TakeRangeStarts();
+  asset.failFrom = -1;
+  asset.Set(RandomBytes(asset.content.size() + 1000, 43), "\"v2\"");
+  options.sha256 = "sha256:" + Sha256::of(asset.content);
+  ASSERT_TRUE(AsyncDownloader::DownloadSegmented(resumeUrl, dir, options).get().first);
+  ASSERT_EQUAL(size_t{4}, asset.TakeRangeStarts().size());
+  ASSERT_TRUE(ReadAll(dir / "resume.bin") == asset.content);
+
+  // 没有 ETag 时用 Last-Modified: 不变时续传, 变了(长度相同)时从头下载
+  const auto lmUrl = server.Url("/files/lastmod.bin");
+  options.sha256.clear();
+  asset.Set(RandomBytes(asset.content.size(), 45), "", "Mon, 05 Oct 2026 10:00:00 GMT");
+  asset.failFrom = half;
+  ASSERT_TRUE(!AsyncDownloader::DownloadSegmented(lmUrl, dir, options).get().first);
+  asset.TakeRangeStarts();
+  asset.failFrom = -1;
+  ASSERT_TRUE(AsyncDownloader::DownloadSegmented(lmUrl, dir, options).get().first);
+  ASSERT_EQUAL(size_t{2}, asset.TakeRangeStarts().size());
+  ASSERT_TRUE(ReadAll(dir / "lastmod.bin") == asset.content);
+  asset.failFrom = half;
+  ASSERT_TRUE(!AsyncDownloader::DownloadSegmented(lmUrl, dir, options).get().first);
+  asset.TakeRangeStarts();
+  asset.failFrom = -1;
+  asset.Set(RandomBytes(asset.content.size(), 46), "", "Tue, 06 Oct 2026 10:00:00 GMT");
+  ASSERT_TRUE(AsyncDownloader::DownloadSegmented(lmUrl, dir, options).get().first);
+  ASSERT_EQUAL(size_t{4}, asset.TakeRangeStarts().size());
+  ASSERT_TRUE(ReadAll(dir / "lastmod.bin") == asset.content);
+
+  // ETag 和 Last-Modified 都没有: 无法判断文件是否变过, 不续传
+  const auto bareUrl = server.Url("/files/novalidator.bin");
+  asset.Set(RandomBytes(asset.content.size(), 47), "");
+  asset.failFrom = half;
+  ASSERT_TRUE(!AsyncDownloader::DownloadSegmented(bareUrl, dir, options).get().first);
+  asset.TakeRangeStarts();
+  asset.failFrom = -1;
+  asset.Set(RandomBytes(asset.content.size(), 48), "");
+  ASSERT_TRUE(AsyncDownloader::DownloadSegmented(bareUrl, dir, options).get().first);
+  ASSERT_EQUAL(size_t{4}, asset.TakeRangeStarts().size());
+  ASSERT_TRUE(ReadAll(dir / "novalidator.bin") == asset.content);
+
+  // 摘要不符: 删除文件
+  options.sha256 = std::string(64, '0');
+  auto mismatch = AsyncDownloader::DownloadSegmented(server.Url("/files/bad.bin"), dir, options).get();
+  ASSERT_TRUE(!mismatch.first);
+  ASSERT_EQUAL(AsyncDownloader::CHECKSUM_FAIL_CODE, mismatch.second);
+  ASSERT_TRUE(!fs::exists(dir / "bad.bin"));
+  asset.TakeRangeStarts();
+
+  // 小文件只用一段
+  options.sha256.clear();
+  asset.Set("tiny", "\"t\"");
+  ASSERT_TRUE(AsyncDownloader::DownloadSegmented(server.Url("/files/tiny.txt"), dir, options).get().first);
+  ASSERT_EQUAL(size_t{1}, asset.TakeRangeStarts().size());
+  ASSERT_STR_EQUAL(std::string{"tiny"}, ReadAll(dir / "tiny.txt"));
+
+  // 不支持 Range: 退化成整个下载, 仍然校验摘要
+  asset.rangesSupported = false;
+  asset.Set(RandomBytes(300000, 44), "\"w\"");
+  options.sha256 = Sha256::of(asset.content);
+  auto whole = AsyncDownloader::DownloadSegmented(server.Url("/files/whole.bin"), dir, options).get();
+  ASSERT_TRUE(whole.first);
+  ASSERT_EQUAL(std::int64_t{200}, whole.second);
+  ASSERT_TRUE(asset.TakeRangeStarts().empty());
+  ASSERT_TRUE(ReadAll(dir / "whole.bin") == asset.content);
+  // 没有扩展名的文件(如 jq-linux64)不能被当成目录
+  auto bare = AsyncDownloader::DownloadSegmented(server.Url("/files/jq-linux64"), dir, options).get();
+  ASSERT_TRUE(bare.first);
+  ASSERT_TRUE(fs::is_regular_file(dir / "jq-linux64"));
+  ASSERT_TRUE(ReadAll(dir / "jq-linux64") == asset.content);
+
+  fs::remove_all(dir);
+  return ASSERT_ALL_PASSED();
+}
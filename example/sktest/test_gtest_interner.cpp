@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "skutils/arena.h"
+#include "skutils/string_interner.h"
+
+namespace str = sk::utils::str;
+
+TEST(SK_ARENA_TEST, allocate_and_reset) {  // NOLINT
+  sk::utils::Arena arena(64);
+  auto* a = arena.create<std::uint64_t>(42);
+  auto* b = arena.allocateArray<double>(100);  // larger than the first block
+  EXPECT_EQ(*a, 42);
+  EXPECT_EQ(reinterpret_cast<std::uintptr_t>(b) % alignof(double), 0);
+  b[99] = 1.0;
+  auto s = arena.copy("hello");
+  EXPECT_EQ(s, "hello");
+  EXPECT_EQ(s.data()[s.size()], '\0');
+  EXPECT_GE(arena.bytesReserved(), arena.bytesUsed());
+  arena.allocateArray<char>(200);  // does not fit the rest of the oversize block, opens a smaller one
+  arena.reset();
+  EXPECT_EQ(arena.bytesUsed(), 0);
+  EXPECT_GE(arena.bytesReserved(), sizeof(double) * 100);  // the largest block is the one kept
+  auto* again = arena.allocateArray<double>(100);
+  again[99] = 2.0;
+  EXPECT_GE(arena.bytesReserved(), sizeof(double) * 100);
+}
+
+TEST(SK_INTERNER_TEST, same_string_same_id) {  // NOLINT
+  str::Interner interner;
+  auto a = interner.intern("--help");
+  auto b = interner.intern(std::string("--") + "help");
+  auto c = interner.intern("-h");
+  EXPECT_EQ(a, b);
+  EXPECT_NE(a, c);
+  EXPECT_EQ(interner.size(), 2);
+  EXPECT_EQ(interner.view(a), "--help");
+  EXPECT_EQ(interner.internView("-h").data(), interner.view(c).data());
+  EXPECT_EQ(interner.find("-h"), c);
+  EXPECT_EQ(interner.find("-x"), str::Interner::npos);
+}
+
+TEST(SK_INTERNER_TEST, views_stay_valid) {  // NOLINT
+  str::Interner interner(64);
+  auto first = interner.internView("first");
+  for (int i = 0; i < 10000; ++i) {
+    interner.intern("key_" + std::to_string(i));
+  }
+  EXPECT_EQ(first, "first");
+  EXPECT_EQ(interner.internView("first").data(), first.data());
+}
+
+TEST(SK_INTERNER_TEST, id_space_exhausted) {  // NOLINT
+  str::Interner interner(64, 2);
+  auto a = interner.intern("a");
+  interner.intern("b");
+  EXPECT_THROW(interner.intern("c"), std::length_error);
+  EXPECT_EQ(interner.intern("a"), a);
+  EXPECT_EQ(interner.size(), 2);
+}
+
+TEST(SK_INTERNER_TEST, sharded_concurrent) {  // NOLINT
+  str::ShardedInterner<8> interner;
+  constexpr int kThreads = 4;
+  constexpr int kKeys = 2000;
+  std::vector<std::vector<str::ShardedInterner<8>::Id>> ids(kThreads);
+  std::vector<std::thread> workers;
+  for (int t = 0; t < kThreads; ++t) {
+    workers.emplace_back([&, t] {
+      for (int i = 0; i < kKeys; ++i) {
+        ids[t].push_back(interner.intern("key_" + std::to_string(i)));
+      }
+    });
+  }
+  for (auto& w : workers) {
+    w.join();
+  }
+  EXPECT_EQ(interner.size(), kKeys);
+  for (int t = 1; t < kThreads; ++t) {
+    EXPECT_EQ(ids[t], ids[0]);
+  }
+  for (int i = 0; i < kKeys; ++i) {
+    EXPECT_EQ(interner.view(ids[0][i]), "key_" + std::to_string(i));
+  }
+}
+
+int main() {
+  ::testing::InitGoogleTest();
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,90 @@
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+#include "skutils/random.h"
+#include "skutils/string_search.h"
+#include "skutils/string_utils.h"
+
+namespace str = sk::utils::str;
+
+std::vector<str::detail::SimdLevel> SupportedLevels() {
+  std::vector<str::detail::SimdLevel> levels{str::detail::SimdLevel::SCALAR};
+#if SK_STR_SIMD_X86
+  levels.push_back(str::detail::SimdLevel::SSE2);
+  if (str::detail::simdLevel() == str::detail::SimdLevel::AVX2) {
+    levels.push_back(str::detail::SimdLevel::AVX2);
+  }
+#endif
+  return levels;
+}
+
+TEST(SK_STRING_SEARCH_TEST, find_matches_std_find) {  // NOLINT
+  for (auto level : SupportedLevels()) {
+    auto kernel = str::detail::findKernel(level);
+    for (int round = 0; round < 500; ++round) {
+      // 小字符集保证有足够多的命中和首尾字节的误报
+      auto hay = RANDTOOL.getRandomString(RANDTOOL.getRandomInt(0, 200), "abc");
+      auto needle = RANDTOOL.getRandomString(RANDTOOL.getRandomInt(1, 6), "abc");
+      EXPECT_EQ(kernel(hay.data(), hay.size(), needle.data(), needle.size()), std::string_view(hay).find(needle))
+        << hay << " / " << needle;
+    }
+  }
+}
+
+TEST(SK_STRING_SEARCH_TEST, ifind_matches_lowered_find) {  // NOLINT
+  for (auto level : SupportedLevels()) {
+    auto kernel = str::detail::ifindKernel(level);
+    for (int round = 0; round < 500; ++round) {
+      auto hay = RANDTOOL.getRandomString(RANDTOOL.getRandomInt(0, 200), "aAbB@`");
+      auto needle = RANDTOOL.getRandomString(RANDTOOL.getRandomInt(1, 5), "aAbB@`");
+      std::string lhay(hay);
+      std::string lneedle(needle);
+      for (auto& c : lhay) c = str::detail::asciiLower(c);
+      for (auto& c : lneedle) c = str::detail::asciiLower(c);
+      EXPECT_EQ(kernel(hay.data(), hay.size(), needle.data(), needle.size()), lhay.find(lneedle))
+        << hay << " / " << needle;
+    }
+  }
+}
+
+TEST(SK_STRING_SEARCH_TEST, public_api) {  // NOLINT
+  std::string log(100, '.');
+  log += "ERROR: disk full; error again; Error";
+  EXPECT_EQ(str::find(log, "ERROR"), 100);
+  EXPECT_EQ(str::find(log, "ERROR", 101), std::string::npos);
+  EXPECT_EQ(str::find(log, ""), 0);
+  EXPECT_TRUE(str::contains(log, "disk full"));
+  EXPECT_EQ(str::count(log, "rr"), 2);
+  EXPECT_EQ(str::count("aaaa", "aa"), 2);
+  EXPECT_TRUE(str::icontains(log, "DISK FULL"));
+  EXPECT_EQ(str::icount(log, "error"), 3);
+  // empty pattern: 0 everywhere, also at compile time
+  EXPECT_EQ(str::count(log, ""), 0);
+  EXPECT_EQ(str::icount(log, ""), 0);
+  static_assert(str::count("abc", "") == 0);
+  static_assert(str::count("abcabc", "bc") == 2);
+}
+
+TEST(SK_STRING_SEARCH_TEST, aho_corasick) {  // NOLINT
+  str::AhoCorasick ac({"he", "she", "his", "hers"});
+  EXPECT_EQ(ac.count("ushers"), 3);  // she, he, hers
+  auto m = ac.find("ushers");
+  ASSERT_TRUE(m.has_value());
+  EXPECT_EQ(m->pos, 1);
+  EXPECT_EQ(ac.pattern(m->pattern), "she");
+  EXPECT_FALSE(ac.contains("xyz"));
+
+  str::AhoCorasick exts({".md", ".cpp", ".h"}, true);
+  EXPECT_TRUE(exts.endsWithAny("README.MD"));
+  EXPECT_TRUE(exts.endsWithAny("src/main.cpp"));
+  EXPECT_FALSE(exts.endsWithAny("main.cpp.bak"));
+  EXPECT_FALSE(exts.endsWithAny("notes.hpp"));
+  EXPECT_TRUE(exts.contains("notes.hpp"));
+}
+
+int main() {
+  ::testing::InitGoogleTest();
+  return RUN_ALL_TESTS();
+}
@@ -27,6 +27,58 @@ TEST(SK_STRING_UTILITIES_TEST, splited_by_strs) {  // NOLINT
   EXPECT_EQ(sk::utils::toString(ret), REPLACED_SEP("[h, wor,d]"));
 }
 
+TEST(SK_STRING_UTILITIES_TEST, split_view_by_char) {  // NOLINT
+  std::string s("//usr//local/bin/");
+  std::vector<std::string_view> tokens;
+  for (auto token : sk::utils::str::split_view(s, '/')) {
+    tokens.push_back(token);
+  }
+  EXPECT_EQ(tokens, (std::vector<std::string_view>{"usr", "local", "bin"}));
+  EXPECT_EQ(sk::utils::str::split_view(s, '/').back(), "bin");
+  EXPECT_TRUE(sk::utils::str::split_view("///", '/').empty());
+  EXPECT_TRUE(sk::utils::str::split_view("", '/').empty());
+}
+
+TEST(SK_STRING_UTILITIES_TEST, split_view_matches_split) {  // NOLINT
+  std::string s("hello worlld, hello again");
+  EXPECT_EQ(sk::utils::str::split_view(s, 'o').to_vector(), sk::utils::str::split(s, 'o'));
+  EXPECT_EQ(sk::utils::str::split_view(s, {'o', 'l'}).to_vector(), sk::utils::str::split(s, {'o', 'l'}));
+  EXPECT_EQ(sk::utils::str::split_view(s, "ll").to_vector(), sk::utils::str::split(s, "ll"));
+  EXPECT_EQ(sk::utils::str::split_view(s, {"ll", "llo", "e"}).to_vector(),
+            sk::utils::str::split(s, {"ll", "llo", "e"}));
+}
+
+TEST(SK_STRING_UTILITIES_TEST, basename) {  // NOLINT
+  EXPECT_EQ(sk::utils::str::basename("/home/user/file.txt"), "file.txt");
+  EXPECT_EQ(sk::utils::str::basename("C:\\Users\\file.txt"), "file.txt");
+  EXPECT_EQ(sk::utils::str::basename("dir/sub/"), "sub");
+  EXPECT_EQ(sk::utils::str::basename("file"), "file");
+  EXPECT_EQ(sk::utils::str::basenameWithoutExt("/a/b/c.cpp"), "c");
+}
+
+TEST(SK_STRING_UTILITIES_TEST, replace_all) {  // NOLINT
+  EXPECT_EQ(sk::utils::str::replace_all("a.b.c", ".", "::"), "a::b::c");
+  EXPECT_EQ(sk::utils::str::replace_all("aaaa", "aa", "b"), "bb");
+  EXPECT_EQ(sk::utils::str::replace_all("a+b", "+", ""), "ab");
+  EXPECT_EQ(sk::utils::str::replace_all("abc", "", "x"), "abc");
+  EXPECT_EQ(sk::utils::str::replace_all("", "a", "x"), "");
+}
+
+TEST(SK_STRING_UTILITIES_TEST, replace_regex) {  // NOLINT
+  EXPECT_EQ(sk::utils::str::replace_regex("a1b22c", "[0-9]+", "#"), "a#b#c");
+  EXPECT_EQ(sk::utils::str::replace_regex("a1b22c", "[0-9]+", "#"), "a#b#c");
+  EXPECT_EQ(sk::utils::str::replace("x.y", ".", "-"), "---");
+}
+
+TEST(SK_STRING_UTILITIES_TEST, trim) {  // NOLINT
+  EXPECT_EQ(sk::utils::str::trim("  a b  "), "a b");
+  EXPECT_EQ(sk::utils::str::trim_left("  a b  "), "a b  ");
+  EXPECT_EQ(sk::utils::str::trim_right("  a b  "), "  a b");
+  EXPECT_EQ(sk::utils::str::trim("\" sharkdp/fd\"", "\" "), "sharkdp/fd");
+  EXPECT_EQ(sk::utils::str::trim("    "), "");
+  EXPECT_EQ(sk::utils::str::trim(""), "");
+}
+
 int main() {
   ::testing::InitGoogleTest();
   return RUN_ALL_TESTS();
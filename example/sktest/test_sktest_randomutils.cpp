@@ -1,3 +1,6 @@
+#include <algorithm>
+#include <set>
+#include <thread>
 #include <vector>
 
 #include "skutils/logger.h"
@@ -33,6 +36,91 @@ void random_printer() {
   std::cout << std::endl;
 }
 
+void random_checker() {
+  auto ints = RANDTOOL.getRandomIntVector(10000, -50000, 50000);
+  ASSERT_TRUE(std::all_of(ints.begin(), ints.end(), [](int x) { return x >= -50000 && x <= 50000; }));
+  // 旧实现只能产生 [lower, lower + 10000] 之间的数
+  ASSERT_TRUE(std::any_of(ints.begin(), ints.end(), [](int x) { return x > 20000; }));
+
+  auto full = RANDTOOL.getRandomIntVector(1000, INT32_MIN, INT32_MAX);
+  ASSERT_TRUE(std::any_of(full.begin(), full.end(), [](int x) { return x < 0; }));
+
+  ASSERT_EQUAL(7, RANDTOOL.getRandomInt(7, 7));
+
+  std::vector<double> ds(1000);
+  RANDTOOL.fill(ds, -0.5, 0.5);
+  ASSERT_TRUE(std::all_of(ds.begin(), ds.end(), [](double x) { return x >= -0.5 && x < 0.5; }));
+  // 少于 64 个走标量引擎, 不构造四路生成器
+  auto few = RANDTOOL.getRandomDoubleVector(3, 10.0, 11.0);
+  ASSERT_TRUE(std::all_of(few.begin(), few.end(), [](double x) { return x >= 10.0 && x < 11.0; }));
+
+  std::vector<int> levels(8);
+  for (int i = 0; i < 80000; i++) {
+    ++levels[RANDTOOL.getRandomLevel(8) - 1];
+  }
+  // p = 1/2: 大约一半在第一层, 且不会超过 maxLevel
+  ASSERT_TRUE(levels[0] > 36000 && levels[0] < 44000);
+  ASSERT_TRUE(levels[1] > 16000 && levels[1] < 24000);
+
+  std::vector<int> a(4);
+  std::vector<int> b(4);
+  std::thread t1([&a] { RANDTOOL.fill(a, 0, 1 << 30); });
+  std::thread t2([&b] { RANDTOOL.fill(b, 0, 1 << 30); });
+  t1.join();
+  t2.join();
+  ASSERT_TRUE(a != b);
+}
+
+void reproducible_checker() {
+  sk::utils::ThreadPool pool(4);
+  // 跨越多个 chunk 且不是整数倍
+  std::vector<int> seq(300007);
+  std::vector<int> par(seq.size());
+  RANDTOOL.fill(seq, -100, 100, 42);
+  RANDTOOL.fill(par, -100, 100, 42, &pool);
+  ASSERT_TRUE(seq == par);
+  ASSERT_TRUE(std::all_of(seq.begin(), seq.end(), [](int x) { return x >= -100 && x <= 100; }));
+  RANDTOOL.fill(par, -100, 100, 43, &pool);
+  ASSERT_TRUE(seq != par);
+  // 四路批量映射到区间, 非 2 的幂的区间每个值都要出现
+  std::vector<int> small(4099);
+  RANDTOOL.fill(small, 0, 2, 5);
+  ASSERT_EQUAL(size_t(3), std::set<int>(small.begin(), small.end()).size());
+
+  std::vector<double> dseq(200003);
+  std::vector<double> dpar(dseq.size());
+  RANDTOOL.fill(dseq, 1.0, 2.0, 7);
+  RANDTOOL.fill(dpar, 1.0, 2.0, 7, &pool);
+  ASSERT_TRUE(dseq == dpar);
+  ASSERT_TRUE(std::all_of(dseq.begin(), dseq.end(), [](double x) { return x >= 1.0 && x < 2.0; }));
+
+  const std::string charset = CHARSET_UPPER + CHARSET_NUMBER;
+  std::vector<char> cseq(150001);
+  std::vector<char> cpar(cseq.size());
+  RANDTOOL.fill(cseq, charset, 9);
+  RANDTOOL.fill(cpar, charset, 9, &pool);
+  ASSERT_TRUE(cseq == cpar);
+  ASSERT_TRUE(std::all_of(cseq.begin(), cseq.end(), [&](char c) { return charset.find(c) != std::string::npos; }));
+  // 36 个字符都应出现
+  ASSERT_EQUAL(charset.size(), std::set<char>(cseq.begin(), cseq.end()).size());
+
+  auto str = RANDTOOL.getRandomString(1000, charset);
+  ASSERT_EQUAL(size_t(1000), str.size());
+  ASSERT_TRUE(str.find_first_not_of(charset) == std::string::npos);
+
+  RANDTOOL.seed(2024);
+  auto x = RANDTOOL.getRandomIntVector(16, 0, 1000);
+  RANDTOOL.seed(2024);
+  ASSERT_TRUE(x == RANDTOOL.getRandomIntVector(16, 0, 1000));
+
+  auto phone = RANDTOOL.getRandomPhoneNumber();
+  ASSERT_EQUAL(size_t(11), phone.size());
+  ASSERT_TRUE(RANDTOOL.getRandomEmail().find('@') != std::string::npos);
+}
+
 int main() {
   random_printer();
+  random_checker();
+  reproducible_checker();
+  return ASSERT_ALL_PASSED();
 }
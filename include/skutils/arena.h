@@ -0,0 +1,133 @@
+#ifndef SK_UTILS_ARENA_H
+#define SK_UTILS_ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "noncopyable.h"
+
+namespace sk::utils {
+
+/// Bump allocator: allocation is a pointer increment, and everything is freed at once by reset() or the
+/// destructor. Destructors of objects placed in the arena are never run, so only put trivially destructible
+/// objects (or objects whose destruction you handle yourself) in it. Not thread-safe.
+class Arena : public NonCopyable {
+  public:
+  static constexpr size_t DEFAULT_BLOCK_SIZE = 4096;
+  static constexpr size_t MAX_BLOCK_SIZE = 1 << 20;
+
+  explicit Arena(size_t blockSize = DEFAULT_BLOCK_SIZE) : nextBlockSize_(std::max<size_t>(blockSize, 64)) {}
+
+  Arena(Arena&& o) noexcept
+    : blocks_(std::move(o.blocks_)),
+      cur_(std::exchange(o.cur_, nullptr)),
+      end_(std::exchange(o.end_, nullptr)),
+      nextBlockSize_(o.nextBlockSize_),
+      used_(std::exchange(o.used_, 0)) {}
+
+  Arena& operator=(Arena&& o) noexcept {
+    if (this != &o) {
+      blocks_ = std::move(o.blocks_);
+      cur_ = std::exchange(o.cur_, nullptr);
+      end_ = std::exchange(o.end_, nullptr);
+      nextBlockSize_ = o.nextBlockSize_;
+      used_ = std::exchange(o.used_, 0);
+    }
+    return *this;
+  }
+
+  ~Arena() = default;
+
+  void* allocate(size_t bytes, size_t align = alignof(std::max_align_t)) {
+    auto p = alignUp(cur_, align);
+    if (cur_ == nullptr || p + bytes > end_) {
+      grow(bytes + align);
+      p = alignUp(cur_, align);
+    }
+    cur_ = p + bytes;
+    used_ += bytes;
+    return p;
+  }
+
+  template <typename T, typename... Args>
+  T* create(Args&&... args) {
+    return new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+  }
+
+  template <typename T>
+  T* allocateArray(size_t n) {
+    return static_cast<T*>(allocate(sizeof(T) * n, alignof(T)));
+  }
+
+  /// copies `s` with a trailing '\0', the returned view stays valid until reset()
+  std::string_view copy(std::string_view s) {
+    auto* p = static_cast<char*>(allocate(s.length() + 1, 1));
+    std::memcpy(p, s.data(), s.length());
+    p[s.length()] = '\0';
+    return {p, s.length()};
+  }
+
+  /// frees everything but keeps the largest block for reuse
+  void reset() {
+    if (blocks_.size() > 1) {
+      // an oversize grow() can leave a smaller block after a larger one, so the last block is not always it
+      auto largest = std::max_element(blocks_.begin(), blocks_.end(),
+                                      [](const Block& a, const Block& b) { return a.size < b.size; });
+      std::iter_swap(largest, blocks_.begin());
+      blocks_.erase(blocks_.begin() + 1, blocks_.end());
+    }
+    if (!blocks_.empty()) {
+      cur_ = blocks_.back().data.get();
+      end_ = cur_ + blocks_.back().size;
+    }
+    used_ = 0;
+  }
+
+  /// bytes handed out by allocate()
+  size_t bytesUsed() const { return used_; }
+
+  /// bytes held in blocks
+  size_t bytesReserved() const {
+    size_t sz = 0;
+    for (const auto& b : blocks_) {
+      sz += b.size;
+    }
+    return sz;
+  }
+
+  private:
+  struct Block {
+    std::unique_ptr<std::byte[]> data;
+    size_t size;
+  };
+
+  static std::byte* alignUp(std::byte* p, size_t align) {
+    auto v = reinterpret_cast<std::uintptr_t>(p);
+    return reinterpret_cast<std::byte*>((v + align - 1) & ~(static_cast<std::uintptr_t>(align) - 1));
+  }
+
+  void grow(size_t atLeast) {
+    auto size = std::max(nextBlockSize_, atLeast);
+    nextBlockSize_ = std::min(nextBlockSize_ * 2, MAX_BLOCK_SIZE);
+    blocks_.push_back({std::make_unique_for_overwrite<std::byte[]>(size), size});  // no zero-fill
+    cur_ = blocks_.back().data.get();
+    end_ = cur_ + size;
+  }
+
+  std::vector<Block> blocks_;
+  std::byte* cur_{nullptr};
+  std::byte* end_{nullptr};
+  size_t nextBlockSize_;
+  size_t used_{0};
+};
+
+}  // namespace sk::utils
+
+#endif  // SK_UTILS_ARENA_H
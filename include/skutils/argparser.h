@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <exception>
+#include <functional>
 #include <map>
 #include <optional>
 #include <stdexcept>
@@ -62,7 +63,7 @@ class ArgParser {
   std::string file_name;
   std::vector<std::string> front_default_args;
   std::vector<std::string> back_default_args;
-  std::map<std::string, ArgInfo> arg_info_mp;
+  std::map<std::string, ArgInfo, std::less<>> arg_info_mp;  // transparent, lookups by string_view don't allocate
 };
 
 // Implementation
@@ -91,7 +92,7 @@ inline ArgParser& ArgParser::add_arg(ArgInfo&& info) {
 }
 
 inline auto ArgParser::get_value(std::string_view arg) -> std::optional<ArgValueType> {
-  auto it = arg_info_mp.find(std::string(arg));
+  auto it = arg_info_mp.find(arg);
   if (it == arg_info_mp.end() || !it->second.has_value) {
     return std::nullopt;
   }
@@ -99,7 +100,7 @@ inline auto ArgParser::get_value(std::string_view arg) -> std::optional<ArgValue
 }
 
 inline auto ArgParser::get_value_with_default(std::string_view arg) -> std::optional<std::vector<std::string>> {
-  auto it = arg_info_mp.find(std::string(arg));
+  auto it = arg_info_mp.find(arg);
   if (it == arg_info_mp.end()) {
     return std::nullopt;
   }
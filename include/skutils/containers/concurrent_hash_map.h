@@ -0,0 +1,301 @@
+#ifndef SK_DATASTRUCTURE_CONCURRENT_HASH_MAP_H
+#define SK_DATASTRUCTURE_CONCURRENT_HASH_MAP_H
+
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "skutils/containers/flat_hash_map.h"
+#include "skutils/containers/shard_detail.h"
+#include "skutils/spinlock.h"
+#include "skutils/threadpool.h"
+
+namespace sk::utils::dts {
+
+/// Hash map shared between threads, split into shards that are each a flat_hash_map behind its own SpinLock on
+/// its own cache line. A key always lives in the shard picked by the high bits of its hash, so threads working on
+/// different keys rarely meet on a lock.
+///
+/// No reference to an element escapes its shard lock: values are read and changed through callbacks that run
+/// while the lock is held. A callback must be short and must not call back into the same map.
+template <typename K, typename V, typename Hash = flat_hash<K>, typename Eq = std::equal_to<>>
+class concurrent_hash_map {
+  public:
+  using key_type = K;
+  using mapped_type = V;
+  using map_type = flat_hash_map<K, V, Hash, Eq>;
+
+  explicit concurrent_hash_map(size_t shardNum = 0)
+    : shardMask(shard_detail::shardMaskFor(shardNum)), shards(std::make_unique<Shard[]>(shardMask + 1)) {}
+
+  /// runs fn(V &) on the value of key, default-constructing the value first when key is absent;
+  /// true if key was inserted
+  template <typename KK, typename Fn>
+  bool upsert(KK &&key, Fn &&fn) {
+    auto &shard = shardOf(key);
+    sk::utils::SpinLockGuard guard{shard.spinlock};
+    auto [it, inserted] = shard.map.try_emplace(std::forward<KK>(key));
+    fn(it->second);
+    return inserted;
+  }
+
+  /// inserts V(init) when key is absent, runs fn(V &) on the existing value otherwise; true if key was inserted
+  template <typename KK, typename VV, typename Fn>
+  bool upsert(KK &&key, VV &&init, Fn &&fn) {
+    auto &shard = shardOf(key);
+    sk::utils::SpinLockGuard guard{shard.spinlock};
+    if (auto it = shard.map.find(key); it != shard.map.end()) {
+      fn(it->second);
+      return false;
+    }
+    shard.map.try_emplace(std::forward<KK>(key), std::forward<VV>(init));
+    return true;
+  }
+
+  /// false and no change if key is already present
+  template <typename KK, typename... Args>
+  bool try_emplace(KK &&key, Args &&...args) {
+    auto &shard = shardOf(key);
+    sk::utils::SpinLockGuard guard{shard.spinlock};
+    return shard.map.try_emplace(std::forward<KK>(key), std::forward<Args>(args)...).second;
+  }
+
+  /// true if key was inserted, false if an existing value was overwritten
+  template <typename VV>
+  bool insert_or_assign(const K &key, VV &&val) {
+    auto &shard = shardOf(key);
+    sk::utils::SpinLockGuard guard{shard.spinlock};
+    return shard.map.insert_or_assign(key, std::forward<VV>(val)).second;
+  }
+
+  /// runs fn(V &) on the value of key if it is present; false if it is not
+  template <typename Fn>
+  bool visit(const K &key, Fn &&fn) {
+    return visit<K>(key, std::forward<Fn>(fn));
+  }
+
+  template <typename K2, typename Fn>
+    requires flat_hash_detail::LookupKey<K2, K, Hash, Eq>
+  bool visit(const K2 &key, Fn &&fn) {
+    auto &shard = shardOf(key);
+    sk::utils::SpinLockGuard guard{shard.spinlock};
+    auto it = shard.map.find(key);
+    if (it == shard.map.end()) {
+      return false;
+    }
+    fn(it->second);
+    return true;
+  }
+
+  template <typename Fn>
+  bool visit(const K &key, Fn &&fn) const {
+    return visit<K>(key, std::forward<Fn>(fn));
+  }
+
+  template <typename K2, typename Fn>
+    requires flat_hash_detail::LookupKey<K2, K, Hash, Eq>
+  bool visit(const K2 &key, Fn &&fn) const {
+    return const_cast<concurrent_hash_map *>(this)->visit(key, [&fn](const V &v) { fn(v); });
+  }
+
+  /// a copy of the value of key
+  std::optional<V> get(const K &key) const { return get<K>(key); }
+
+  template <typename K2>
+    requires flat_hash_detail::LookupKey<K2, K, Hash, Eq>
+  std::optional<V> get(const K2 &key) const {
+    std::optional<V> ret;
+    visit(key, [&ret](const V &v) { ret.emplace(v); });
+    return ret;
+  }
+
+  bool contains(const K &key) const { return contains<K>(key); }
+
+  template <typename K2>
+    requires flat_hash_detail::LookupKey<K2, K, Hash, Eq>
+  bool contains(const K2 &key) const {
+    auto &shard = shardOf(key);
+    sk::utils::SpinLockGuard guard{shard.spinlock};
+    return shard.map.contains(key);
+  }
+
+  size_t erase(const K &key) { return erase<K>(key); }
+
+  template <typename K2>
+    requires flat_hash_detail::LookupKey<K2, K, Hash, Eq>
+  size_t erase(const K2 &key) {
+    auto &shard = shardOf(key);
+    sk::utils::SpinLockGuard guard{shard.spinlock};
+    return shard.map.erase(key);
+  }
+
+  /// locks the shards one at a time: concurrent writers may be counted in some shards and not in others
+  size_t size() const {
+    size_t sz = 0;
+    for (size_t i = 0; i <= shardMask; ++i) {
+      sk::utils::SpinLockGuard guard{shards[i].spinlock};
+      sz += shards[i].map.size();
+    }
+    return sz;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  void clear() {
+    for (size_t i = 0; i <= shardMask; ++i) {
+      sk::utils::SpinLockGuard guard{shards[i].spinlock};
+      shards[i].map.clear();
+    }
+  }
+
+  /// sizes every shard for its share of n keys
+  void reserve(size_t n) {
+    for (size_t i = 0; i <= shardMask; ++i) {
+      sk::utils::SpinLockGuard guard{shards[i].spinlock};
+      shards[i].map.reserve(n / (shardMask + 1) + 1);
+    }
+  }
+
+  /// fn(const K &, V &) for every element, holding one shard lock at a time
+  template <typename Fn>
+  void for_each(Fn &&fn) {
+    for (size_t i = 0; i <= shardMask; ++i) {
+      forEachInShard(i, fn);
+    }
+  }
+
+  /// for_each with the shards spread over pool and the calling thread. fn runs concurrently for elements of
+  /// different shards, so anything it writes besides the value itself must be thread safe.
+  template <typename Fn>
+  void for_each_parallel(ThreadPool &pool, Fn &&fn) {
+    std::vector<std::future<void>> fus;
+    fus.reserve(shardMask);
+    for (size_t i = 1; i <= shardMask; ++i) {
+      fus.emplace_back(pool.submit([this, &fn, i] { forEachInShard(i, fn); }));
+    }
+    forEachInShard(0, fn);
+    for (auto &fu : fus) {
+      fu.get();
+    }
+  }
+
+  /// a plain map holding everything inserted so far, taken one shard at a time
+  map_type snapshot() const {
+    map_type ret;
+    for (size_t i = 0; i <= shardMask; ++i) {
+      sk::utils::SpinLockGuard guard{shards[i].spinlock};
+      ret.reserve(ret.size() + shards[i].map.size());
+      ret.insert(shards[i].map.begin(), shards[i].map.end());
+    }
+    return ret;
+  }
+
+  size_t shard_count() const { return shardMask + 1; }
+
+  private:
+  struct alignas(64) Shard {
+    mutable sk::utils::SpinLock spinlock;
+    map_type map;
+  };
+
+  template <typename Fn>
+  void forEachInShard(size_t i, Fn &fn) {
+    sk::utils::SpinLockGuard guard{shards[i].spinlock};
+    for (auto &[k, v] : shards[i].map) {
+      fn(k, v);
+    }
+  }
+
+  /// the shard map probes with the low bits of the same hash, the shard is picked from the high ones
+  template <typename K2>
+  Shard &shardOf(const K2 &key) const {
+    auto h = static_cast<std::uint64_t>(hash_(key)) * 0x9E3779B97F4A7C15ULL;
+    return shards[(h >> 32) & shardMask];
+  }
+
+  size_t shardMask;
+  std::unique_ptr<Shard[]> shards;
+  [[no_unique_address]] Hash hash_;
+};
+
+/// Write-mostly aggregation: add(key, v) folds v into a map private to the calling thread's shard, and the
+/// combined result is only built on read by merged(). Unlike concurrent_hash_map, two threads adding the same
+/// hot key never touch the same cache line while there are no more threads than shards, at the price of one copy
+/// of every key per shard.
+///
+/// Combine(V, V) -> V must be associative and commutative (std::plus<> for counters and sums).
+template <typename K, typename V, typename Combine = std::plus<>, typename Hash = flat_hash<K>,
+          typename Eq = std::equal_to<>>
+class concurrent_hash_accumulator {
+  public:
+  using key_type = K;
+  using mapped_type = V;
+  using map_type = flat_hash_map<K, V, Hash, Eq>;
+
+  /// shardNum = 0 picks one shard per hardware thread
+  explicit concurrent_hash_accumulator(size_t shardNum = 0, Combine combine = Combine{})
+    : shardMask(shard_detail::shardMaskFor(shardNum)),
+      shards(std::make_unique<Shard[]>(shardMask + 1)),
+      combine_(std::move(combine)) {}
+
+  template <typename KK, typename VV>
+  void add(KK &&key, VV &&v) {
+    auto &shard = localShard();
+    sk::utils::SpinLockGuard guard{shard.spinlock};
+    foldInto(shard.map, std::forward<KK>(key), std::forward<VV>(v));
+  }
+
+  /// everything added so far combined per key
+  map_type merged() const {
+    map_type ret;
+    for (size_t i = 0; i <= shardMask; ++i) {
+      sk::utils::SpinLockGuard guard{shards[i].spinlock};
+      if (ret.empty()) {
+        ret = shards[i].map;
+        continue;
+      }
+      for (const auto &[k, v] : shards[i].map) {
+        foldInto(ret, k, v);
+      }
+    }
+    return ret;
+  }
+
+  void clear() {
+    for (size_t i = 0; i <= shardMask; ++i) {
+      sk::utils::SpinLockGuard guard{shards[i].spinlock};
+      shards[i].map.clear();
+    }
+  }
+
+  size_t shard_count() const { return shardMask + 1; }
+
+  private:
+  struct alignas(64) Shard {
+    mutable sk::utils::SpinLock spinlock;
+    map_type map;
+  };
+
+  template <typename KK, typename VV>
+  void foldInto(map_type &m, KK &&key, VV &&v) const {
+    if (auto it = m.find(key); it != m.end()) {
+      it->second = combine_(std::move(it->second), std::forward<VV>(v));
+    } else {
+      m.try_emplace(std::forward<KK>(key), std::forward<VV>(v));
+    }
+  }
+
+  Shard &localShard() { return shards[shard_detail::localShardIndex(shardMask)]; }
+
+  size_t shardMask;
+  std::unique_ptr<Shard[]> shards;
+  [[no_unique_address]] Combine combine_;
+};
+
+}  // namespace sk::utils::dts
+
+#endif  // SK_DATASTRUCTURE_CONCURRENT_HASH_MAP_H
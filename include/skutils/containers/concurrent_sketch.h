@@ -0,0 +1,71 @@
+#ifndef SK_DATASTRUCTURE_CONCURRENT_SKETCH_H
+#define SK_DATASTRUCTURE_CONCURRENT_SKETCH_H
+
+#include <memory>
+#include <utility>
+
+#include "skutils/containers/shard_detail.h"
+#include "skutils/spinlock.h"
+
+namespace sk::utils::dts {
+
+/// Shares a mergeable sketch (space_saving, misra_gries, count_min_sketch, kll_sketch) between threads.
+///
+/// Every shard holds a copy of the prototype and each thread keeps pushing into the same shard, so the shard
+/// locks are almost never contended; merged() folds the shards into one sketch.
+template <typename Sketch>
+class concurrent_sketch {
+  public:
+  /// shardNum = 0 picks one shard per hardware thread
+  explicit concurrent_sketch(const Sketch& proto, size_t shardNum = 0)
+    : shardMask(shard_detail::shardMaskFor(shardNum)),
+      shards(std::make_unique<Shard[]>(shardMask + 1)) {
+    for (size_t i = 0; i <= shardMask; ++i) {
+      shards[i].sketch = std::make_unique<Sketch>(proto);
+    }
+  }
+
+  template <typename... Args>
+  void push(Args&&... args) {
+    auto& shard = localShard();
+    sk::utils::SpinLockGuard guard{shard.spinlock};
+    shard.sketch->push(std::forward<Args>(args)...);
+  }
+
+  /// a snapshot of everything pushed so far
+  Sketch merged() const {
+    Sketch ret = [this] {
+      sk::utils::SpinLockGuard guard{shards[0].spinlock};
+      return *shards[0].sketch;
+    }();
+    for (size_t i = 1; i <= shardMask; ++i) {
+      sk::utils::SpinLockGuard guard{shards[i].spinlock};
+      ret.merge(*shards[i].sketch);
+    }
+    return ret;
+  }
+
+  void clear() {
+    for (size_t i = 0; i <= shardMask; ++i) {
+      sk::utils::SpinLockGuard guard{shards[i].spinlock};
+      shards[i].sketch->clear();
+    }
+  }
+
+  size_t shard_count() const { return shardMask + 1; }
+
+  private:
+  struct alignas(64) Shard {
+    mutable sk::utils::SpinLock spinlock;
+    std::unique_ptr<Sketch> sketch;
+  };
+
+  Shard& localShard() { return shards[shard_detail::localShardIndex(shardMask)]; }
+
+  size_t shardMask;
+  std::unique_ptr<Shard[]> shards;
+};
+
+}  // namespace sk::utils::dts
+
+#endif  // SK_DATASTRUCTURE_CONCURRENT_SKETCH_H
@@ -0,0 +1,321 @@
+#ifndef SHUAIKAI_DATASTRUCTURE_CONCURRENT_SKIP_LIST_H
+#define SHUAIKAI_DATASTRUCTURE_CONCURRENT_SKIP_LIST_H
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <new>
+#include <optional>
+
+#include "skutils/epoch.h"
+#include "skutils/noncopyable.h"
+#include "skutils/random.h"
+
+namespace sk::utils::dts {
+
+/// Lock-free ordered map (Fraser / Herlihy-Shavit skip list).
+///
+/// Lookups and iteration never write shared memory. insert links a node bottom-up with CAS; erase marks the
+/// low bit of the node's forward pointers top-down, and a marked node is unlinked by whichever traversal meets
+/// it. Unlinked nodes are freed through EpochManager, so pointers read under a pin stay valid. Values are
+/// returned by copy and are immutable once inserted.
+template <typename K, typename V, typename Compare = std::less<K>>
+class ConcurrentSkipList : public NonCopyable {
+  public:
+  static constexpr int MAX_LEVEL = 20;
+
+  ConcurrentSkipList() : head_(createNode(MAX_LEVEL, K{}, V{})) {}
+
+  /// not thread-safe: no other operation may run concurrently
+  ~ConcurrentSkipList() {
+    auto* curr = ptrOf(head_->links()[0].load(std::memory_order_acquire));
+    while (curr != nullptr) {
+      auto* next = ptrOf(curr->links()[0].load(std::memory_order_relaxed));
+      destroyNode(curr);
+      curr = next;
+    }
+    destroyNode(head_);
+  }
+
+  /// false if the key is already present
+  bool insert(const K& key, const V& val);
+
+  bool erase(const K& key);
+
+  std::optional<V> find(const K& key) const {
+    auto guard = epoch_.pin();
+    auto* node = lowerBound(key);
+    if (node == nullptr || comp_(key, node->key)) {
+      return std::nullopt;
+    }
+    return node->val;
+  }
+
+  bool contains(const K& key) const {
+    auto guard = epoch_.pin();
+    auto* node = lowerBound(key);
+    return node != nullptr && !comp_(key, node->key);
+  }
+
+  /// calls fn(key, val) in key order; entries inserted or erased during the walk may or may not be seen
+  template <typename Fn>
+  void forEach(Fn&& fn) const {
+    auto guard = epoch_.pin();
+    walk(ptrOf(head_->links()[0].load(std::memory_order_acquire)), nullptr, fn);
+  }
+
+  /// like forEach, restricted to keys in [lo, hi)
+  template <typename Fn>
+  void forEachRange(const K& lo, const K& hi, Fn&& fn) const {
+    auto guard = epoch_.pin();
+    walk(lowerBound(lo), &hi, fn);
+  }
+
+  /// approximate while writers are running
+  size_t size() const {
+    return static_cast<size_t>(std::max<std::int64_t>(size_.load(std::memory_order_relaxed), 0));
+  }
+
+  bool empty() const { return size() == 0; }
+
+  private:
+  using Link = std::atomic<std::uintptr_t>;
+
+  /// forward pointers are stored inline after the node; refs counts the inserter and the eraser, the last of
+  /// them to finish hands the node to the epoch manager
+  struct alignas(Link) Node {
+    K key;
+    V val;
+    int level;
+    std::atomic<int> refs{2};
+
+    Node(int lvl, const K& k, const V& v) : key(k), val(v), level(lvl) {}
+
+    Link* links() { return reinterpret_cast<Link*>(this + 1); }
+  };
+
+  static Node* createNode(int level, const K& key, const V& val) {
+    void* mem = ::operator new(sizeof(Node) + sizeof(Link) * level);
+    auto* node = new (mem) Node(level, key, val);
+    for (int i = 0; i < level; ++i) {
+      new (node->links() + i) Link(0);
+    }
+    return node;
+  }
+
+  static void destroyNode(void* p) {
+    auto* node = static_cast<Node*>(p);
+    node->~Node();
+    ::operator delete(p);
+  }
+
+  static Node* ptrOf(std::uintptr_t link) { return reinterpret_cast<Node*>(link & ~std::uintptr_t{1}); }
+
+  static bool marked(std::uintptr_t link) { return (link & 1) != 0; }
+
+  static std::uintptr_t toLink(Node* node) { return reinterpret_cast<std::uintptr_t>(node); }
+
+  /// Fills preds/succs with the last node before `key` and the first node not before it on every level,
+  /// unlinking marked nodes on the way. With `sweep`, the run of nodes equal to `key` is scanned too, so a
+  /// marked node is removed even when a newer node with the same key sits in front of it.
+  bool findPath(const K& key, Node** preds, Node** succs, bool sweep = false);
+
+  /// first unmarked node not before `key`, read-only
+  Node* lowerBound(const K& key) const;
+
+  template <typename Fn>
+  void walk(Node* curr, const K* hi, Fn& fn) const {
+    while (curr != nullptr && (hi == nullptr || comp_(curr->key, *hi))) {
+      auto next = curr->links()[0].load(std::memory_order_acquire);
+      if (!marked(next)) {
+        fn(curr->key, curr->val);
+      }
+      curr = ptrOf(next);
+    }
+  }
+
+  void release(Node* node) {
+    if (node->refs.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+      epoch_.retire(node, &destroyNode);
+    }
+  }
+
+  Node* head_;
+  /// levels in use, searches start there instead of at MAX_LEVEL; never lowered
+  std::atomic<int> height_{1};
+  std::atomic<std::int64_t> size_{0};
+  [[no_unique_address]] Compare comp_;
+  EpochManager& epoch_{EpochManager::instance()};
+};
+
+template <typename K, typename V, typename Compare>
+bool ConcurrentSkipList<K, V, Compare>::findPath(const K& key, Node** preds, Node** succs, bool sweep) {
+  const int top = height_.load(std::memory_order_acquire);
+  std::fill(preds + top, preds + MAX_LEVEL, head_);
+  std::fill(succs + top, succs + MAX_LEVEL, nullptr);
+retry:
+  Node* pred = head_;
+  for (int l = top - 1; l >= 0; --l) {
+    Node* curr = ptrOf(pred->links()[l].load(std::memory_order_acquire));
+    while (curr != nullptr) {
+      auto succ = curr->links()[l].load(std::memory_order_acquire);
+      if (marked(succ)) {
+        auto expected = toLink(curr);
+        if (!pred->links()[l].compare_exchange_strong(expected, succ & ~std::uintptr_t{1},
+                                                      std::memory_order_acq_rel)) {
+          goto retry;
+        }
+        curr = ptrOf(succ);
+      } else if (comp_(curr->key, key)) {
+        pred = curr;
+        curr = ptrOf(succ);
+      } else {
+        break;
+      }
+    }
+    preds[l] = pred;
+    succs[l] = curr;
+
+    if (sweep) {
+      Node* p = pred;
+      Node* c = curr;
+      while (c != nullptr && !comp_(key, c->key)) {
+        auto succ = c->links()[l].load(std::memory_order_acquire);
+        if (marked(succ)) {
+          auto expected = toLink(c);
+          if (!p->links()[l].compare_exchange_strong(expected, succ & ~std::uintptr_t{1},
+                                                     std::memory_order_acq_rel)) {
+            goto retry;
+          }
+          if (p == pred) {
+            succs[l] = ptrOf(succ);
+          }
+        } else {
+          p = c;
+        }
+        c = ptrOf(succ);
+      }
+    }
+  }
+  return succs[0] != nullptr && !comp_(key, succs[0]->key);
+}
+
+template <typename K, typename V, typename Compare>
+typename ConcurrentSkipList<K, V, Compare>::Node* ConcurrentSkipList<K, V, Compare>::lowerBound(const K& key) const {
+  Node* pred = head_;
+  Node* curr = nullptr;
+  for (int l = height_.load(std::memory_order_acquire) - 1; l >= 0; --l) {
+    curr = ptrOf(pred->links()[l].load(std::memory_order_acquire));
+    while (curr != nullptr) {
+      auto succ = curr->links()[l].load(std::memory_order_acquire);
+      if (marked(succ)) {
+        curr = ptrOf(succ);
+      } else if (comp_(curr->key, key)) {
+        pred = curr;
+        curr = ptrOf(succ);
+      } else {
+        break;
+      }
+    }
+  }
+  return curr;
+}
+
+template <typename K, typename V, typename Compare>
+bool ConcurrentSkipList<K, V, Compare>::insert(const K& key, const V& val) {
+  const int topLevel = RANDTOOL.getRandomLevel(MAX_LEVEL);
+  Node* preds[MAX_LEVEL];
+  Node* succs[MAX_LEVEL];
+  auto guard = epoch_.pin();
+  // raise the height before linking, so every search that can meet the node starts high enough
+  auto h = height_.load(std::memory_order_acquire);
+  while (h < topLevel && !height_.compare_exchange_weak(h, topLevel, std::memory_order_acq_rel)) {}
+
+  Node* node = nullptr;
+  while (true) {
+    if (findPath(key, preds, succs)) {
+      if (node != nullptr) {
+        destroyNode(node);
+      }
+      return false;
+    }
+    if (node == nullptr) {
+      node = createNode(topLevel, key, val);
+    }
+    for (int l = 0; l < topLevel; ++l) {
+      node->links()[l].store(toLink(succs[l]), std::memory_order_relaxed);
+    }
+    auto expected = toLink(succs[0]);
+    if (preds[0]->links()[0].compare_exchange_strong(expected, toLink(node), std::memory_order_acq_rel)) {
+      break;
+    }
+  }
+  size_.fetch_add(1, std::memory_order_relaxed);
+
+  // the node is in the map from here on, the upper levels only speed up searches
+  for (int l = 1; l < topLevel; ++l) {
+    bool linked = false;
+    while (!linked) {
+      auto cur = node->links()[l].load(std::memory_order_acquire);
+      if (marked(cur)) {
+        break;  // erased meanwhile, stop growing the tower
+      }
+      if (ptrOf(cur) != succs[l]
+          && !node->links()[l].compare_exchange_strong(cur, toLink(succs[l]), std::memory_order_acq_rel)) {
+        continue;
+      }
+      auto expected = toLink(succs[l]);
+      linked = preds[l]->links()[l].compare_exchange_strong(expected, toLink(node), std::memory_order_acq_rel);
+      if (!linked) {
+        findPath(key, preds, succs);
+      }
+    }
+    if (!linked) {
+      break;
+    }
+  }
+  // an erase that ran while the tower was growing may have missed the levels linked after it
+  if (marked(node->links()[0].load(std::memory_order_acquire))) {
+    findPath(key, preds, succs, true);
+  }
+  release(node);
+  return true;
+}
+
+template <typename K, typename V, typename Compare>
+bool ConcurrentSkipList<K, V, Compare>::erase(const K& key) {
+  Node* preds[MAX_LEVEL];
+  Node* succs[MAX_LEVEL];
+  auto guard = epoch_.pin();
+
+  while (true) {
+    if (!findPath(key, preds, succs)) {
+      return false;
+    }
+    Node* node = succs[0];
+    for (int l = node->level - 1; l >= 1; --l) {
+      auto cur = node->links()[l].load(std::memory_order_acquire);
+      while (!marked(cur) && !node->links()[l].compare_exchange_weak(cur, cur | 1, std::memory_order_acq_rel)) {}
+    }
+    auto cur = node->links()[0].load(std::memory_order_acquire);
+    bool won = false;
+    while (!marked(cur)) {
+      if (node->links()[0].compare_exchange_weak(cur, cur | 1, std::memory_order_acq_rel)) {
+        won = true;
+        break;
+      }
+    }
+    if (!won) {
+      continue;  // a concurrent erase took this node, look again
+    }
+    findPath(key, preds, succs, true);
+    size_.fetch_sub(1, std::memory_order_relaxed);
+    release(node);
+    return true;
+  }
+}
+
+}  // namespace sk::utils::dts
+
+#endif  // SHUAIKAI_DATASTRUCTURE_CONCURRENT_SKIP_LIST_H
@@ -0,0 +1,89 @@
+#ifndef SK_DATASTRUCTURE_COUNT_MIN_H
+#define SK_DATASTRUCTURE_COUNT_MIN_H
+
+#include <algorithm>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <stdexcept>
+#include <vector>
+
+namespace sk::utils::dts {
+
+/// Count-Min sketch: depth rows of width counters, each item adds its weight to one counter per row and the
+/// estimate is the smallest of them. It never underestimates, and with width = e / epsilon and
+/// depth = ln(1 / delta) it overestimates by more than epsilon * total with probability at most delta.
+/// Memory is fixed at construction, whatever the number of distinct items.
+template <typename T, typename Hash = std::hash<T>>
+class count_min_sketch {
+  public:
+  /// width is rounded up to a power of 2
+  count_min_sketch(size_t width, size_t depth)
+    : w(std::bit_ceil(std::max<size_t>(width, 1))), d(std::max<size_t>(depth, 1)), table(w * d, 0) {}
+
+  static count_min_sketch with_error(double epsilon, double delta) {
+    return count_min_sketch(static_cast<size_t>(std::ceil(std::exp(1.0) / epsilon)),
+                            static_cast<size_t>(std::ceil(std::log(1.0 / delta))));
+  }
+
+  void push(const T& item, std::uint64_t weight = 1) {
+    total_ += weight;
+    auto [h1, h2] = hashes(item);
+    for (size_t i = 0; i < d; ++i) {
+      table[i * w + ((h1 + i * h2) & (w - 1))] += weight;
+    }
+  }
+
+  /// upper bound of the item's count
+  std::uint64_t estimate(const T& item) const {
+    auto [h1, h2] = hashes(item);
+    auto ret = std::numeric_limits<std::uint64_t>::max();
+    for (size_t i = 0; i < d; ++i) {
+      ret = std::min(ret, table[i * w + ((h1 + i * h2) & (w - 1))]);
+    }
+    return ret;
+  }
+
+  /// both sketches must have the same shape
+  void merge(const count_min_sketch& o) {
+    if (o.w != w || o.d != d) {
+      throw std::invalid_argument("count_min_sketch shape mismatch");
+    }
+    for (size_t i = 0; i < table.size(); ++i) {
+      table[i] += o.table[i];
+    }
+    total_ += o.total_;
+  }
+
+  void clear() {
+    std::fill(table.begin(), table.end(), 0);
+    total_ = 0;
+  }
+
+  size_t width() const { return w; }
+
+  size_t depth() const { return d; }
+
+  std::uint64_t total() const { return total_; }
+
+  private:
+  /// row i uses h1 + i * h2 (Kirsch-Mitzenmacher), both derived from one call to Hash
+  static std::pair<std::uint64_t, std::uint64_t> hashes(const T& item) {
+    std::uint64_t z = static_cast<std::uint64_t>(Hash{}(item)) + 0x9E3779B97F4A7C15ull;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+    z ^= z >> 31;
+    return {z, (z >> 32 | z << 32) | 1};
+  }
+
+  size_t w;
+  size_t d;
+  std::uint64_t total_{0};
+  std::vector<std::uint64_t> table;
+};
+
+}  // namespace sk::utils::dts
+
+#endif  // SK_DATASTRUCTURE_COUNT_MIN_H
@@ -0,0 +1,709 @@
+#ifndef SK_DATASTRUCTURE_FLAT_HASH_MAP_H
+#define SK_DATASTRUCTURE_FLAT_HASH_MAP_H
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <initializer_list>
+#include <iterator>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SK_FLAT_HASH_SSE2 1
+#include <emmintrin.h>
+#else
+#define SK_FLAT_HASH_SSE2 0
+#endif
+
+namespace sk::utils::dts {
+
+/// Default hasher of flat_hash_map / flat_hash_set: std::hash, except that string keys hash as string_view and
+/// are transparent, so find("abc") or find(std::string_view) never builds a std::string.
+template <typename K>
+struct flat_hash : std::hash<K> {};
+
+template <>
+struct flat_hash<std::string> {
+  using is_transparent = void;
+
+  size_t operator()(std::string_view s) const { return std::hash<std::string_view>{}(s); }
+};
+
+template <>
+struct flat_hash<std::string_view> : flat_hash<std::string> {};
+
+namespace flat_hash_detail {
+
+using ctrl_t = std::int8_t;
+/// a full slot stores the low 7 bits of its hash (H2), free slots have the sign bit set
+constexpr ctrl_t EMPTY = -128;
+constexpr ctrl_t DELETED = -2;
+constexpr size_t GROUP_WIDTH = 16;
+
+/// 16 control bytes matched at once, one bit per byte in the returned masks
+class Group {
+  public:
+  explicit Group(const ctrl_t *p) {
+#if SK_FLAT_HASH_SSE2
+    ctrl = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+#else
+    std::memcpy(ctrl, p, GROUP_WIDTH);
+#endif
+  }
+
+  std::uint32_t match(ctrl_t h2) const {
+#if SK_FLAT_HASH_SSE2
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(h2), ctrl)));
+#else
+    std::uint32_t m = 0;
+    for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+      m |= static_cast<std::uint32_t>(ctrl[i] == h2) << i;
+    }
+    return m;
+#endif
+  }
+
+  std::uint32_t matchEmpty() const { return match(EMPTY); }
+
+  std::uint32_t matchEmptyOrDeleted() const {
+#if SK_FLAT_HASH_SSE2
+    return static_cast<std::uint32_t>(_mm_movemask_epi8(ctrl));
+#else
+    std::uint32_t m = 0;
+    for (size_t i = 0; i < GROUP_WIDTH; ++i) {
+      m |= static_cast<std::uint32_t>(ctrl[i] < 0) << i;
+    }
+    return m;
+#endif
+  }
+
+  private:
+#if SK_FLAT_HASH_SSE2
+  __m128i ctrl;
+#else
+  ctrl_t ctrl[GROUP_WIDTH];
+#endif
+};
+
+/// control bytes of every empty table, so lookups need no capacity check; never written, inserting grows first
+inline ctrl_t *emptyGroup() {
+  alignas(16) static ctrl_t group[GROUP_WIDTH] = {EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY,
+                                                             EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY, EMPTY};
+  return group;
+}
+
+template <typename T>
+concept Transparent = requires { typename T::is_transparent; };
+
+/// K2 may differ from the key type K only with a transparent hasher and key_equal; used by the containers built
+/// on flat_hash_map, which pair a `const K &` overload with a K2 template constrained on this
+template <typename K2, typename K, typename Hash, typename Eq>
+concept LookupKey = std::is_same_v<K2, K> || (Transparent<Hash> && Transparent<Eq>);
+
+template <typename K, typename V>
+struct MapPolicy {
+  using key_type = K;
+  using value_type = std::pair<const K, V>;
+
+  static const K &key(const value_type &v) { return v.first; }
+
+  /// moves a slot into uninitialized storage and destroys the source; the key is const only to users
+  static void transfer(value_type *dst, value_type *src) {
+    new (dst) value_type(std::piecewise_construct, std::forward_as_tuple(std::move(const_cast<K &>(src->first))),
+                         std::forward_as_tuple(std::move(src->second)));
+    src->~value_type();
+  }
+};
+
+template <typename K>
+struct SetPolicy {
+  using key_type = K;
+  using value_type = K;
+
+  static const K &key(const value_type &v) { return v; }
+
+  static void transfer(value_type *dst, value_type *src) {
+    new (dst) value_type(std::move(*src));
+    src->~value_type();
+  }
+};
+
+/// Open-addressing table in the SwissTable layout (Abseil): slots plus one control byte per slot, and the first
+/// GROUP_WIDTH control bytes cloned past the end so a group can be loaded at any slot. A lookup splits the
+/// mixed hash into H1, the probe start, and H2, the 7 bits kept in the control byte; every probe step matches
+/// H2 against 16 control bytes with one SSE2 compare, so keys are only compared for likely hits, and it stops
+/// at the first group holding an empty byte. Groups are visited by triangular steps, which cover the whole
+/// power-of-two table.
+///
+/// Growth: the table keeps at most 7/8 of its slots used, counting tombstones. When that runs out it is rebuilt
+/// at the same capacity if at least half of the budget is tombstones, and at twice the capacity otherwise.
+/// reserve(n) sizes it for n elements up front. Erasing marks a tombstone only when the slot sits in a run of
+/// 16 non-empty bytes that a probe could have walked through, and frees it outright otherwise.
+template <typename Policy, typename Hash, typename Eq>
+class raw_hash_table {
+  public:
+  using key_type = typename Policy::key_type;
+  using value_type = typename Policy::value_type;
+  using size_type = size_t;
+  using hasher = Hash;
+  using key_equal = Eq;
+  using reference = value_type &;
+  using const_reference = const value_type &;
+
+  template <bool Const>
+  class Iter {
+    public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = typename Policy::value_type;
+    using difference_type = std::ptrdiff_t;
+    using reference = std::conditional_t<Const, const value_type &, value_type &>;
+    using pointer = std::conditional_t<Const, const value_type *, value_type *>;
+
+    Iter() = default;
+
+    /// iterator to const_iterator
+    template <bool C = Const>
+      requires C
+    Iter(const Iter<false> &o) : ctrl(o.ctrl), slot(o.slot), end(o.end) {}
+
+    reference operator*() const { return *slot; }
+
+    pointer operator->() const { return slot; }
+
+    Iter &operator++() {
+      ++ctrl;
+      ++slot;
+      skipFree();
+      return *this;
+    }
+
+    Iter operator++(int) {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const Iter &o) const { return ctrl == o.ctrl; }
+
+    private:
+    friend class raw_hash_table;
+    template <bool>
+    friend class Iter;
+
+    Iter(const ctrl_t *c, value_type *s, const ctrl_t *e) : ctrl(c), slot(s), end(e) {}
+
+    void skipFree() {
+      while (ctrl != end && *ctrl < 0) {
+        ++ctrl;
+        ++slot;
+      }
+    }
+
+    const ctrl_t *ctrl{nullptr};
+    value_type *slot{nullptr};
+    const ctrl_t *end{nullptr};
+  };
+
+  using iterator = Iter<false>;
+  using const_iterator = Iter<true>;
+
+  protected:
+  /// lookups by another type than key_type need a transparent hasher and key_equal; iterators never qualify, so
+  /// erase(it) is not taken for a key
+  template <typename K2>
+  static constexpr bool TRANSPARENT_LOOKUP = Transparent<Hash> && Transparent<Eq> &&
+                                             !std::is_convertible_v<const K2 &, iterator> &&
+                                             !std::is_convertible_v<const K2 &, const_iterator>;
+
+  public:
+
+  raw_hash_table() = default;
+
+  explicit raw_hash_table(size_t n, const Hash &hash = Hash(), const Eq &eq = Eq()) : hash_(hash), eq_(eq) {
+    reserve(n);
+  }
+
+  raw_hash_table(const raw_hash_table &o) : hash_(o.hash_), eq_(o.eq_) {
+    reserve(o.size_);
+    for (const auto &v : o) {
+      auto h = hashOf(Policy::key(v));
+      new (slots_ + prepareInsert(h)) value_type(v);
+    }
+  }
+
+  raw_hash_table(raw_hash_table &&o) noexcept
+    : slots_(std::exchange(o.slots_, nullptr)),
+      ctrl_(std::exchange(o.ctrl_, emptyGroup())),
+      cap_(std::exchange(o.cap_, 0)),
+      size_(std::exchange(o.size_, 0)),
+      growthLeft_(std::exchange(o.growthLeft_, 0)),
+      hash_(std::move(o.hash_)),
+      eq_(std::move(o.eq_)) {}
+
+  raw_hash_table &operator=(raw_hash_table o) noexcept {
+    swap(o);
+    return *this;
+  }
+
+  ~raw_hash_table() { destroy(); }
+
+  void swap(raw_hash_table &o) noexcept {
+    std::swap(slots_, o.slots_);
+    std::swap(ctrl_, o.ctrl_);
+    std::swap(cap_, o.cap_);
+    std::swap(size_, o.size_);
+    std::swap(growthLeft_, o.growthLeft_);
+    std::swap(hash_, o.hash_);
+    std::swap(eq_, o.eq_);
+  }
+
+  iterator begin() {
+    iterator it(ctrl_, slots_, ctrl_ + cap_);
+    it.skipFree();
+    return it;
+  }
+
+  iterator end() { return iterator(ctrl_ + cap_, slots_ + cap_, ctrl_ + cap_); }
+
+  const_iterator begin() const { return const_cast<raw_hash_table *>(this)->begin(); }
+
+  const_iterator end() const { return const_cast<raw_hash_table *>(this)->end(); }
+
+  const_iterator cbegin() const { return begin(); }
+
+  const_iterator cend() const { return end(); }
+
+  size_t size() const { return size_; }
+
+  bool empty() const { return size_ == 0; }
+
+  /// number of slots, 0 or a power of 2 of at least 16
+  size_t capacity() const { return cap_; }
+
+  double load_factor() const { return cap_ == 0 ? 0.0 : static_cast<double>(size_) / static_cast<double>(cap_); }
+
+  /// destroys every element, keeping the slots
+  void clear() {
+    if (cap_ == 0) {
+      return;
+    }
+    destroyElements();
+    std::memset(ctrl_, EMPTY, cap_ + GROUP_WIDTH);
+    size_ = 0;
+    growthLeft_ = maxLoad(cap_);
+  }
+
+  /// room for n elements without rehashing
+  void reserve(size_t n) {
+    if (n > size_ + growthLeft_) {
+      resize(capacityFor(n));
+    }
+  }
+
+  /// rebuilds with at least n slots, and enough for size(); rehash(0) on an empty table frees it
+  void rehash(size_t n) {
+    if (n == 0 && size_ == 0) {
+      destroy();
+      slots_ = nullptr;
+      ctrl_ = emptyGroup();
+      cap_ = growthLeft_ = 0;
+      return;
+    }
+    resize(std::max(capacityFor(size_), std::bit_ceil(std::max(n, GROUP_WIDTH))));
+  }
+
+  iterator find(const key_type &key) { return findKey(key); }
+
+  template <typename K2>
+    requires TRANSPARENT_LOOKUP<K2>
+  iterator find(const K2 &key) {
+    return findKey(key);
+  }
+
+  const_iterator find(const key_type &key) const { return const_cast<raw_hash_table *>(this)->findKey(key); }
+
+  template <typename K2>
+    requires TRANSPARENT_LOOKUP<K2>
+  const_iterator find(const K2 &key) const {
+    return const_cast<raw_hash_table *>(this)->findKey(key);
+  }
+
+  bool contains(const key_type &key) const { return findIndex(key, hashOf(key)) != NPOS; }
+
+  template <typename K2>
+    requires TRANSPARENT_LOOKUP<K2>
+  bool contains(const K2 &key) const {
+    return findIndex(key, hashOf(key)) != NPOS;
+  }
+
+  size_t count(const key_type &key) const { return contains(key) ? 1 : 0; }
+
+  template <typename K2>
+    requires TRANSPARENT_LOOKUP<K2>
+  size_t count(const K2 &key) const {
+    return contains(key) ? 1 : 0;
+  }
+
+  size_t erase(const key_type &key) { return eraseKey(key); }
+
+  template <typename K2>
+    requires TRANSPARENT_LOOKUP<K2>
+  size_t erase(const K2 &key) {
+    return eraseKey(key);
+  }
+
+  /// returns the iterator past the erased element
+  iterator erase(const_iterator pos) {
+    auto i = static_cast<size_t>(pos.ctrl - ctrl_);
+    eraseAt(i);
+    auto it = iteratorAt(i);
+    it.skipFree();
+    return it;
+  }
+
+  iterator erase(iterator pos) { return erase(const_iterator(pos)); }
+
+  hasher hash_function() const { return hash_; }
+
+  key_equal key_eq() const { return eq_; }
+
+  friend bool operator==(const raw_hash_table &a, const raw_hash_table &b) {
+    if (a.size() != b.size()) {
+      return false;
+    }
+    for (const auto &v : a) {
+      auto it = b.find(Policy::key(v));
+      if (it == b.end() || !(*it == v)) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  protected:
+  static constexpr size_t NPOS = static_cast<size_t>(-1);
+
+  static size_t maxLoad(size_t cap) { return cap - cap / 8; }
+
+  static size_t capacityFor(size_t n) {
+    size_t cap = GROUP_WIDTH;
+    while (maxLoad(cap) < n) {
+      cap *= 2;
+    }
+    return cap;
+  }
+
+  template <typename K2>
+  size_t hashOf(const K2 &key) const {
+    // std::hash of integers is the identity, H1 and H2 both need well mixed bits
+    auto h = static_cast<std::uint64_t>(hash_(key));
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdULL;
+    h ^= h >> 33;
+    return static_cast<size_t>(h);
+  }
+
+  static ctrl_t h2(size_t hash) { return static_cast<ctrl_t>(hash & 0x7F); }
+
+  size_t mask() const { return cap_ == 0 ? 0 : cap_ - 1; }
+
+  template <typename K2>
+  size_t findIndex(const K2 &key, size_t hash) const {
+    const size_t m = mask();
+    size_t pos = (hash >> 7) & m;
+    for (size_t step = GROUP_WIDTH;; pos = (pos + step) & m, step += GROUP_WIDTH) {
+      Group g(ctrl_ + pos);
+      for (auto bits = g.match(h2(hash)); bits != 0; bits &= bits - 1) {
+        size_t i = (pos + std::countr_zero(bits)) & m;
+        if (eq_(Policy::key(slots_[i]), key)) {
+          return i;
+        }
+      }
+      if (g.matchEmpty() != 0) {
+        return NPOS;
+      }
+    }
+  }
+
+  template <typename K2>
+  iterator findKey(const K2 &key) {
+    auto i = findIndex(key, hashOf(key));
+    return i == NPOS ? end() : iteratorAt(i);
+  }
+
+  template <typename K2>
+  size_t eraseKey(const K2 &key) {
+    auto i = findIndex(key, hashOf(key));
+    if (i == NPOS) {
+      return 0;
+    }
+    eraseAt(i);
+    return 1;
+  }
+
+  /// first empty or deleted slot on the probe sequence of hash
+  size_t findFree(size_t hash) const {
+    const size_t m = mask();
+    size_t pos = (hash >> 7) & m;
+    for (size_t step = GROUP_WIDTH;; pos = (pos + step) & m, step += GROUP_WIDTH) {
+      if (auto bits = Group(ctrl_ + pos).matchEmptyOrDeleted(); bits != 0) {
+        return (pos + std::countr_zero(bits)) & m;
+      }
+    }
+  }
+
+  void setCtrl(size_t i, ctrl_t c) {
+    ctrl_[i] = c;
+    // the clone of slot i < GROUP_WIDTH sits at cap_ + i, for the others this writes ctrl_[i] again
+    ctrl_[((i - GROUP_WIDTH) & mask()) + GROUP_WIDTH] = c;
+  }
+
+  /// claims a free slot for a key known to be absent, growing first if needed; the caller constructs it
+  size_t prepareInsert(size_t hash) {
+    if (growthLeft_ == 0) {
+      if (cap_ == 0) {
+        resize(GROUP_WIDTH);
+      } else if (size_ <= maxLoad(cap_) / 2) {
+        resize(cap_);
+      } else {
+        resize(cap_ * 2);
+      }
+    }
+    auto i = findFree(hash);
+    growthLeft_ -= ctrl_[i] == EMPTY;
+    setCtrl(i, h2(hash));
+    ++size_;
+    return i;
+  }
+
+  void eraseAt(size_t i) {
+    slots_[i].~value_type();
+    --size_;
+    // a probe can only have walked past i if i is inside a window of GROUP_WIDTH non-empty bytes
+    const size_t before = (i - GROUP_WIDTH) & mask();
+    auto emptyAfter = Group(ctrl_ + i).matchEmpty();
+    auto emptyBefore = static_cast<std::uint16_t>(Group(ctrl_ + before).matchEmpty());
+    bool neverFull = emptyAfter != 0 && emptyBefore != 0 &&
+                     static_cast<size_t>(std::countr_zero(emptyAfter) + std::countl_zero(emptyBefore)) < GROUP_WIDTH;
+    setCtrl(i, neverFull ? EMPTY : DELETED);
+    growthLeft_ += neverFull;
+  }
+
+  iterator iteratorAt(size_t i) { return iterator(ctrl_ + i, slots_ + i, ctrl_ + cap_); }
+
+  void destroyElements() {
+    if constexpr (!std::is_trivially_destructible_v<value_type>) {
+      for (size_t i = 0; i < cap_; ++i) {
+        if (ctrl_[i] >= 0) {
+          slots_[i].~value_type();
+        }
+      }
+    }
+  }
+
+  static constexpr size_t slotAlign() { return std::max(alignof(value_type), alignof(std::max_align_t)); }
+
+  /// slots and control bytes share one allocation, control bytes last
+  void resize(size_t newCap) {
+    auto *mem = static_cast<std::byte *>(
+      ::operator new(newCap * sizeof(value_type) + newCap + GROUP_WIDTH, std::align_val_t(slotAlign())));
+    auto *oldSlots = slots_;
+    auto *oldCtrl = ctrl_;
+    auto oldCap = cap_;
+    slots_ = reinterpret_cast<value_type *>(mem);
+    ctrl_ = reinterpret_cast<ctrl_t *>(mem + newCap * sizeof(value_type));
+    cap_ = newCap;
+    std::memset(ctrl_, EMPTY, newCap + GROUP_WIDTH);
+    for (size_t i = 0; i < oldCap; ++i) {
+      if (oldCtrl[i] >= 0) {
+        auto h = hashOf(Policy::key(oldSlots[i]));
+        auto j = findFree(h);
+        setCtrl(j, h2(h));
+        Policy::transfer(slots_ + j, oldSlots + i);
+      }
+    }
+    growthLeft_ = maxLoad(cap_) - size_;
+    if (oldCap != 0) {
+      ::operator delete(oldSlots, std::align_val_t(slotAlign()));
+    }
+  }
+
+  void destroy() {
+    if (cap_ == 0) {
+      return;
+    }
+    destroyElements();
+    ::operator delete(slots_, std::align_val_t(slotAlign()));
+  }
+
+  value_type *slots_{nullptr};
+  ctrl_t *ctrl_{emptyGroup()};
+  size_t cap_{0};
+  size_t size_{0};
+  size_t growthLeft_{0};
+  [[no_unique_address]] Hash hash_{};
+  [[no_unique_address]] Eq eq_{};
+};
+
+}  // namespace flat_hash_detail
+
+/// Flat open-addressing hash map, see flat_hash_detail::raw_hash_table for the layout and the growth policy.
+/// Elements live in the slot array itself: rehashing, and erasing, invalidate iterators and references.
+/// With the default hasher and std::equal_to<> string keys can be looked up by string_view or const char *.
+template <typename K, typename V, typename Hash = flat_hash<K>, typename Eq = std::equal_to<>>
+class flat_hash_map : public flat_hash_detail::raw_hash_table<flat_hash_detail::MapPolicy<K, V>, Hash, Eq> {
+  using Base = flat_hash_detail::raw_hash_table<flat_hash_detail::MapPolicy<K, V>, Hash, Eq>;
+
+  public:
+  using mapped_type = V;
+  using typename Base::const_iterator;
+  using typename Base::iterator;
+  using typename Base::value_type;
+
+  using Base::Base;
+
+  flat_hash_map() = default;
+
+  flat_hash_map(std::initializer_list<value_type> init) {
+    this->reserve(init.size());
+    insert(init.begin(), init.end());
+  }
+
+  template <typename KK, typename... Args>
+  std::pair<iterator, bool> try_emplace(KK &&key, Args &&...args) {
+    auto h = this->hashOf(key);
+    if (auto i = this->findIndex(key, h); i != Base::NPOS) {
+      return {this->iteratorAt(i), false};
+    }
+    auto i = this->prepareInsert(h);
+    new (this->slots_ + i) value_type(std::piecewise_construct, std::forward_as_tuple(std::forward<KK>(key)),
+                                      std::forward_as_tuple(std::forward<Args>(args)...));
+    return {this->iteratorAt(i), true};
+  }
+
+  std::pair<iterator, bool> insert(const value_type &v) { return try_emplace(v.first, v.second); }
+
+  std::pair<iterator, bool> insert(value_type &&v) {
+    return try_emplace(std::move(const_cast<K &>(v.first)), std::move(v.second));
+  }
+
+  template <typename It>
+  void insert(It first, It last) {
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  template <typename... Args>
+  std::pair<iterator, bool> emplace(Args &&...args) {
+    return insert(value_type(std::forward<Args>(args)...));
+  }
+
+  template <typename VV>
+  std::pair<iterator, bool> insert_or_assign(const K &key, VV &&val) {
+    auto ret = try_emplace(key, std::forward<VV>(val));
+    if (!ret.second) {
+      ret.first->second = std::forward<VV>(val);
+    }
+    return ret;
+  }
+
+  V &operator[](const K &key) { return try_emplace(key).first->second; }
+
+  V &operator[](K &&key) { return try_emplace(std::move(key)).first->second; }
+
+  V &at(const K &key) { return atKey(key); }
+
+  template <typename K2>
+    requires Base::template TRANSPARENT_LOOKUP<K2>
+  V &at(const K2 &key) {
+    return atKey(key);
+  }
+
+  const V &at(const K &key) const { return const_cast<flat_hash_map *>(this)->atKey(key); }
+
+  template <typename K2>
+    requires Base::template TRANSPARENT_LOOKUP<K2>
+  const V &at(const K2 &key) const {
+    return const_cast<flat_hash_map *>(this)->atKey(key);
+  }
+
+  private:
+  template <typename K2>
+  V &atKey(const K2 &key) {
+    auto it = this->find(key);
+    if (it == this->end()) {
+      throw std::out_of_range("flat_hash_map::at: key unexist");
+    }
+    return it->second;
+  }
+};
+
+/// Flat open-addressing hash set, the key-only flat_hash_map.
+template <typename K, typename Hash = flat_hash<K>, typename Eq = std::equal_to<>>
+class flat_hash_set : public flat_hash_detail::raw_hash_table<flat_hash_detail::SetPolicy<K>, Hash, Eq> {
+  using Base = flat_hash_detail::raw_hash_table<flat_hash_detail::SetPolicy<K>, Hash, Eq>;
+
+  public:
+  /// elements are keys and must not change in place
+  using iterator = typename Base::const_iterator;
+  using const_iterator = typename Base::const_iterator;
+  using typename Base::value_type;
+
+  using Base::Base;
+
+  flat_hash_set() = default;
+
+  flat_hash_set(std::initializer_list<K> init) {
+    this->reserve(init.size());
+    insert(init.begin(), init.end());
+  }
+
+  const_iterator begin() const { return Base::begin(); }
+
+  const_iterator end() const { return Base::end(); }
+
+  const_iterator find(const K &key) const { return Base::find(key); }
+
+  template <typename K2>
+    requires Base::template TRANSPARENT_LOOKUP<K2>
+  const_iterator find(const K2 &key) const {
+    return Base::find(key);
+  }
+
+  template <typename KK>
+  std::pair<const_iterator, bool> insert(KK &&key) {
+    auto h = this->hashOf(key);
+    if (auto i = this->findIndex(key, h); i != Base::NPOS) {
+      return {this->iteratorAt(i), false};
+    }
+    auto i = this->prepareInsert(h);
+    new (this->slots_ + i) K(std::forward<KK>(key));
+    return {this->iteratorAt(i), true};
+  }
+
+  template <typename It>
+  void insert(It first, It last) {
+    for (; first != last; ++first) {
+      insert(*first);
+    }
+  }
+
+  template <typename... Args>
+  std::pair<const_iterator, bool> emplace(Args &&...args) {
+    return insert(K(std::forward<Args>(args)...));
+  }
+};
+
+}  // namespace sk::utils::dts
+
+#endif  // SK_DATASTRUCTURE_FLAT_HASH_MAP_H
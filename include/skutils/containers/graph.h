@@ -6,6 +6,7 @@
 #include <string>
 #include <vector>
 
+#include "skutils/containers/graph_generators.h"
 #include "skutils/printer.h"
 #include "skutils/random.h"
 
@@ -75,33 +76,19 @@ class Graph {
   std::string toString() const;
 };
 
-Graph<int> buildRandomGraph(int n = 10, bool isYouXiang = false, bool useDefaultWeight = true, int start = 1,
-                            int end = 100) {
-  std::vector<int> vertex = RANDTOOL.getRandomIntVector(n, start, end);
-  int dummy = graphConst::dummyValue;
-  std::vector<std::vector<int>> adjust(n, std::vector<int>(n, dummy));
-  for (int i = 0; i < n * 3; i++) {
-    std::vector<int> tup = RANDTOOL.getRandomIntVector(2, 0, n - 1);
-    if (!useDefaultWeight) {
-      adjust[tup[0]][tup[1]] = RANDTOOL.getRandomInt(start, end);
-    } else {
-      adjust[tup[0]][tup[1]] = graphConst::wuxiangtuWeight;
-    }
+/// n random nodes valued in [start, end] and n * 3 random G(n, m) edges, weighted in [start, end] unless
+/// useDefaultWeight. The edges are drawn as a list and written straight into the matrix, both ways when undirected.
+inline Graph<int> buildRandomGraph(int n = 10, bool isYouXiang = false, bool useDefaultWeight = true, int start = 1,
+                                   int end = 100) {
+  Graph<int> g(RANDTOOL.getRandomIntVector(n, start, end), isYouXiang);
+  auto edges = erdosRenyiEdges(n, static_cast<size_t>(n) * 3, RANDTOOL.engine()(), nullptr, true);
+  if (!useDefaultWeight) {
+    randomizeWeights(edges, start, end, RANDTOOL.engine()());
   }
-  if (!isYouXiang) {
-    for (int i = 0; i < n; i++) {
-      for (int j = 0; j < i; j++) {
-        if (adjust[i][j] != adjust[j][i]) {
-          if (RANDTOOL.coinOnce()) {
-            adjust[i][j] = adjust[j][i];
-          } else {
-            adjust[j][i] = adjust[i][j];
-          }
-        }
-      }
-    }
+  for (const auto &e : edges) {
+    g.addEdge(e.from, e.to, e.weight);
   }
-  return Graph<int>(vertex, adjust, isYouXiang);
+  return g;
 }
 
 template <typename ValueType>
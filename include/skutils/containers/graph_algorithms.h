@@ -0,0 +1,334 @@
+#ifndef SK_DATASTRUCTURE_GRAPH_ALGORITHMS_H
+#define SK_DATASTRUCTURE_GRAPH_ALGORITHMS_H
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdint>
+#include <future>
+#include <limits>
+#include <map>
+#include <numeric>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+
+#include "skutils/containers/sparse_graph.h"
+#include "skutils/containers/unionfind_set.h"
+#include "skutils/threadpool.h"
+
+/// Graph algorithms over CsrGraph. Every function takes an optional ThreadPool: with nullptr it runs on the
+/// calling thread, otherwise the work is split into chunks submitted to the pool while the caller takes the
+/// first chunk and waits for the rest. Do not call them from a task running on the same pool.
+namespace sk::utils::dts {
+
+namespace graphConst {
+/// bfs() depth of nodes the source cannot reach
+const int unreachable = -1;
+/// deltaStepping() distance of nodes the source cannot reach
+const std::int64_t infDistance = std::numeric_limits<std::int64_t>::max();
+}  // namespace graphConst
+
+namespace graph_detail {
+
+/// lowers slot to val if val is smaller, true if this call did it
+template <typename T>
+bool writeMin(T &slot, T val) {
+  std::atomic_ref<T> ref(slot);
+  T cur = ref.load(std::memory_order_relaxed);
+  while (val < cur) {
+    if (ref.compare_exchange_weak(cur, val, std::memory_order_relaxed)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+/// concatenates the per-chunk outputs
+template <typename T>
+std::vector<T> flatten(std::vector<std::vector<T>> &parts) {
+  size_t total = 0;
+  for (const auto &p : parts) {
+    total += p.size();
+  }
+  std::vector<T> ret;
+  ret.reserve(total);
+  for (auto &p : parts) {
+    ret.insert(ret.end(), p.begin(), p.end());
+  }
+  return ret;
+}
+
+constexpr size_t NODE_GRAIN = 1 << 12;
+constexpr size_t FRONTIER_GRAIN = 1 << 10;
+
+}  // namespace graph_detail
+
+/// Direction-optimizing BFS (Beamer et al.): hop count from `source` to every node, graphConst::unreachable for
+/// the rest. Small frontiers expand top-down over their out-edges; once the frontier's edges outnumber a
+/// fraction of the unexplored ones, every unvisited node instead looks for a parent among its in-neighbors and
+/// stops at the first hit, which skips most edges of the large middle levels. Directed graphs build a transposed
+/// copy the first time they go bottom-up.
+template <typename ValueType>
+std::vector<int> bfs(const CsrGraph<ValueType> &g, int source, ThreadPool *pool = nullptr) {
+  using namespace graph_detail;
+  constexpr size_t ALPHA = 14;
+  constexpr size_t BETA = 24;
+
+  const auto n = static_cast<size_t>(g.size());
+  if (source < 0 || static_cast<size_t>(source) >= n) {
+    throw std::out_of_range("bfs source unexist");
+  }
+  std::vector<int> depth(n, graphConst::unreachable);
+  depth[source] = 0;
+
+  std::optional<CsrGraph<ValueType>> transposed;
+  const CsrGraph<ValueType> *in = g.isYouXiang ? nullptr : &g;
+
+  std::vector<int> frontier{source};
+  std::vector<std::uint8_t> inFrontier;
+  std::vector<std::uint8_t> nextFrontier;
+  size_t frontierSize = 1;
+  size_t frontierEdges = g.degree(source);
+  size_t unexploredEdges = g.edgeCount();
+  bool bottomUp = false;
+  int level = 0;
+
+  while (frontierSize > 0) {
+    ++level;
+    if (!bottomUp && frontierEdges > unexploredEdges / ALPHA) {
+      if (in == nullptr) {
+        transposed.emplace(g.transpose());
+        in = &*transposed;
+      }
+      inFrontier.assign(n, 0);
+      nextFrontier.assign(n, 0);
+      for (auto u : frontier) {
+        inFrontier[u] = 1;
+      }
+      bottomUp = true;
+    } else if (bottomUp && frontierSize < n / BETA) {
+      frontier.clear();
+      for (size_t v = 0; v < n; ++v) {
+        if (inFrontier[v]) {
+          frontier.push_back(static_cast<int>(v));
+        }
+      }
+      bottomUp = false;
+    }
+    unexploredEdges -= std::min(unexploredEdges, frontierEdges);
+
+    std::vector<size_t> sizes;
+    std::vector<size_t> edges;
+    if (!bottomUp) {
+      std::vector<std::vector<int>> next(chunkCount(frontier.size(), FRONTIER_GRAIN));
+      edges.assign(next.size(), 0);
+      parallelChunks(frontier.size(), FRONTIER_GRAIN, pool, [&](size_t c, size_t b, size_t e) {
+        for (auto i = b; i < e; ++i) {
+          for (auto v : g.neighbors(frontier[i])) {
+            std::atomic_ref<int> d(depth[v]);
+            int expected = graphConst::unreachable;
+            if (d.load(std::memory_order_relaxed) == expected
+                && d.compare_exchange_strong(expected, level, std::memory_order_relaxed)) {
+              next[c].push_back(v);
+              edges[c] += g.degree(v);
+            }
+          }
+        }
+      });
+      frontier = flatten(next);
+      frontierSize = frontier.size();
+    } else {
+      // each node only writes its own slots, so no atomics are needed
+      sizes.assign(chunkCount(n, NODE_GRAIN), 0);
+      edges.assign(sizes.size(), 0);
+      parallelChunks(n, NODE_GRAIN, pool, [&](size_t c, size_t b, size_t e) {
+        for (auto v = b; v < e; ++v) {
+          nextFrontier[v] = 0;
+          if (depth[v] != graphConst::unreachable) {
+            continue;
+          }
+          for (auto u : in->neighbors(static_cast<int>(v))) {
+            if (inFrontier[u]) {
+              depth[v] = level;
+              nextFrontier[v] = 1;
+              ++sizes[c];
+              edges[c] += g.degree(static_cast<int>(v));
+              break;
+            }
+          }
+        }
+      });
+      inFrontier.swap(nextFrontier);
+      frontierSize = std::accumulate(sizes.begin(), sizes.end(), size_t{0});
+    }
+    frontierEdges = std::accumulate(edges.begin(), edges.end(), size_t{0});
+  }
+  return depth;
+}
+
+/// Delta-stepping single-source shortest paths (Meyer, Sanders) for non-negative weights; graphConst::infDistance
+/// marks unreachable nodes. Nodes are kept in buckets of width delta; all nodes of the lowest bucket relax
+/// their light edges (weight <= delta) in parallel until the bucket stays empty, then their heavy edges once.
+/// delta = 0 picks max weight / average degree. A small delta approaches Dijkstra, a large one Bellman-Ford.
+template <typename ValueType>
+std::vector<std::int64_t> deltaStepping(const CsrGraph<ValueType> &g, int source, ThreadPool *pool = nullptr,
+                                        std::int64_t delta = 0) {
+  using namespace graph_detail;
+  const auto n = static_cast<size_t>(g.size());
+  if (source < 0 || static_cast<size_t>(source) >= n) {
+    throw std::out_of_range("deltaStepping source unexist");
+  }
+  std::int64_t maxWeight = 1;
+  for (size_t e = 0; e < g.edgeCount(); ++e) {
+    if (g.edgeWeight(e) < 0) {
+      throw std::invalid_argument("deltaStepping needs non-negative weights");
+    }
+    maxWeight = std::max<std::int64_t>(maxWeight, g.edgeWeight(e));
+  }
+  if (delta <= 0) {
+    auto avgDegree = std::max<std::int64_t>(1, static_cast<std::int64_t>(g.edgeCount() / n));
+    delta = std::max<std::int64_t>(1, maxWeight / avgDegree);
+  }
+
+  std::vector<std::int64_t> dist(n, graphConst::infDistance);
+  /// distance at which a node last relaxed its light edges, to skip stale and duplicate bucket entries
+  std::vector<std::int64_t> relaxedAt(n, graphConst::infDistance);
+  std::vector<std::int64_t> heavyDone(n, -1);
+  /// only non-empty buckets exist, so a small delta against large weights does not allocate the empty ones
+  std::map<std::int64_t, std::vector<int>> buckets;
+  dist[source] = 0;
+  buckets[0].push_back(source);
+
+  auto relax = [&](const std::vector<int> &from, bool light) {
+    std::vector<std::vector<int>> updated(chunkCount(from.size(), FRONTIER_GRAIN));
+    parallelChunks(from.size(), FRONTIER_GRAIN, pool, [&](size_t c, size_t b, size_t e) {
+      for (auto i = b; i < e; ++i) {
+        int u = from[i];
+        auto du = std::atomic_ref<std::int64_t>(dist[u]).load(std::memory_order_relaxed);
+        for (auto k = g.offset(u); k < g.offset(u + 1); ++k) {
+          std::int64_t w = g.edgeWeight(k);
+          if ((w <= delta) == light && writeMin(dist[g.target(k)], du + w)) {
+            updated[c].push_back(g.target(k));
+          }
+        }
+      }
+    });
+    for (auto v : flatten(updated)) {
+      buckets[dist[v] / delta].push_back(v);
+    }
+  };
+
+  std::vector<int> front;
+  std::vector<int> settled;
+  while (!buckets.empty()) {
+    const auto cur = buckets.begin()->first;
+    settled.clear();
+    // light edges can refill the current bucket, heavy ones only reach later buckets
+    for (auto it = buckets.begin(); it != buckets.end() && it->first == cur; it = buckets.find(cur)) {
+      auto pending = std::move(it->second);
+      buckets.erase(it);
+      front.clear();
+      for (auto v : pending) {
+        if (dist[v] / delta == cur && dist[v] < relaxedAt[v]) {
+          relaxedAt[v] = dist[v];
+          front.push_back(v);
+          if (heavyDone[v] != cur) {
+            heavyDone[v] = cur;
+            settled.push_back(v);
+          }
+        }
+      }
+      relax(front, true);
+    }
+    relax(settled, false);
+  }
+  return dist;
+}
+
+/// Connected components (weakly connected for directed graphs) by ConcurrentUnionFindSet: edges are united in
+/// parallel with CAS links, larger root under smaller. labels[v] is the smallest node of v's component.
+template <typename ValueType>
+std::vector<int> connectedComponents(const CsrGraph<ValueType> &g, ThreadPool *pool = nullptr) {
+  using namespace graph_detail;
+  const auto n = static_cast<size_t>(g.size());
+  ConcurrentUnionFindSet uf(g.size());
+  parallelChunks(n, NODE_GRAIN, pool, [&](size_t, size_t b, size_t e) {
+    for (auto u = static_cast<int>(b); u < static_cast<int>(e); ++u) {
+      for (auto v : g.neighbors(u)) {
+        // an undirected edge is stored both ways
+        if (g.isYouXiang || v < u) {
+          uf.connect(u, v);
+        }
+      }
+    }
+  });
+  return uf.components(pool);
+}
+
+/// number of components in connectedComponents() labels
+inline int componentCount(const std::vector<int> &labels) {
+  int cnt = 0;
+  for (size_t v = 0; v < labels.size(); ++v) {
+    cnt += labels[v] == static_cast<int>(v);
+  }
+  return cnt;
+}
+
+/// PageRank by pull-style power iteration: each node sums the shares of its in-neighbors, so every score is
+/// written by one thread. Rank of dangling nodes is spread evenly. Stops after maxIter rounds or once the L1
+/// change drops below tol. Scores sum to 1.
+template <typename ValueType>
+std::vector<double> pageRank(const CsrGraph<ValueType> &g, ThreadPool *pool = nullptr, double damping = 0.85,
+                             int maxIter = 100, double tol = 1e-6) {
+  using namespace graph_detail;
+  const auto n = static_cast<size_t>(g.size());
+  if (n == 0) {
+    return {};
+  }
+  std::optional<CsrGraph<ValueType>> transposed;
+  if (g.isYouXiang) {
+    transposed.emplace(g.transpose());
+  }
+  const auto &in = g.isYouXiang ? *transposed : g;
+
+  std::vector<double> rank(n, 1.0 / static_cast<double>(n));
+  std::vector<double> next(n);
+  std::vector<double> share(n);
+  const size_t chunks = chunkCount(n, NODE_GRAIN);
+  std::vector<double> partial(chunks);
+  for (int it = 0; it < maxIter; ++it) {
+    parallelChunks(n, NODE_GRAIN, pool, [&](size_t c, size_t b, size_t e) {
+      double dangling = 0;
+      for (auto u = b; u < e; ++u) {
+        auto deg = g.degree(static_cast<int>(u));
+        share[u] = deg ? rank[u] / deg : 0.0;
+        dangling += deg ? 0.0 : rank[u];
+      }
+      partial[c] = dangling;
+    });
+    const double base = (1.0 - damping) / static_cast<double>(n)
+                        + damping * std::accumulate(partial.begin(), partial.end(), 0.0) / static_cast<double>(n);
+    parallelChunks(n, NODE_GRAIN, pool, [&](size_t c, size_t b, size_t e) {
+      double diff = 0;
+      for (auto v = b; v < e; ++v) {
+        double sum = 0;
+        for (auto u : in.neighbors(static_cast<int>(v))) {
+          sum += share[u];
+        }
+        next[v] = base + damping * sum;
+        diff += std::abs(next[v] - rank[v]);
+      }
+      partial[c] = diff;
+    });
+    rank.swap(next);
+    if (std::accumulate(partial.begin(), partial.end(), 0.0) < tol) {
+      break;
+    }
+  }
+  return rank;
+}
+
+}  // namespace sk::utils::dts
+
+#endif  // SK_DATASTRUCTURE_GRAPH_ALGORITHMS_H
@@ -0,0 +1,151 @@
+#ifndef SK_DATASTRUCTURE_GRAPH_GENERATORS_H
+#define SK_DATASTRUCTURE_GRAPH_GENERATORS_H
+
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include "skutils/random.h"
+#include "skutils/threadpool.h"
+
+/// Random graph generators that stream edges straight into an edge list, O(E) memory and no adjacency matrix.
+/// Like RandomUtil::fill, the output is split into fixed chunks with their own RNG streams, so it depends only
+/// on the seed, whether or not a ThreadPool runs the chunks. Feed the list to CsrGraph::fromEdges.
+namespace sk::utils::dts {
+
+struct Edge {
+  int from;
+  int to;
+  int weight{1};
+};
+
+namespace graph_detail {
+
+/// maps a 64-bit hash to [0, range)
+inline std::uint64_t scaleHash(std::uint64_t h, std::uint64_t range) {
+#if defined(__SIZEOF_INT128__)
+  return static_cast<std::uint64_t>((static_cast<unsigned __int128>(h) * range) >> 64);
+#else
+  return h % range;
+#endif
+}
+
+}  // namespace graph_detail
+
+/// RMAT / Kronecker edges on 2^scale nodes: every edge descends `scale` levels of the adjacency matrix, picking
+/// the top-left, top-right, bottom-left or bottom-right quadrant with probability a, b, c or 1 - a - b - c.
+/// The defaults are the Graph500 ones and give a skewed, small-world degree distribution.
+inline void fillRmatEdges(std::span<Edge> out, int scale, std::uint64_t seed, ThreadPool *pool = nullptr,
+                          double a = 0.57, double b = 0.19, double c = 0.19) {
+  if (scale < 1 || scale > 30) {
+    throw std::invalid_argument("rmat scale should be in [1, 30]");
+  }
+  // 16-bit thresholds, so one 64-bit draw decides four levels
+  const auto ta = static_cast<std::uint32_t>(a * 65536);
+  const auto tab = static_cast<std::uint32_t>((a + b) * 65536);
+  const auto tabc = static_cast<std::uint32_t>((a + b + c) * 65536);
+  sk::utils::detail::forEachSeededChunk(out, seed, pool, [=](std::span<Edge> chunk, Xoshiro256ppX4 &gen) {
+    for (auto &e : chunk) {
+      int u = 0;
+      int v = 0;
+      std::uint64_t r = 0;
+      for (int lvl = 0; lvl < scale; ++lvl) {
+        if ((lvl & 3) == 0) {
+          r = gen();
+        }
+        auto x = static_cast<std::uint32_t>(r & 0xFFFF);
+        r >>= 16;
+        // branch-free, the quadrant is a coin flip and would mispredict half the time
+        u |= static_cast<int>(x >= tab) << lvl;
+        v |= static_cast<int>((x >= ta) ^ (x >= tab) ^ (x >= tabc)) << lvl;
+      }
+      e = {u, v};
+    }
+  });
+}
+
+/// edgeFactor << scale RMAT edges
+inline std::vector<Edge> rmatEdges(int scale, int edgeFactor, std::uint64_t seed, ThreadPool *pool = nullptr,
+                                   double a = 0.57, double b = 0.19, double c = 0.19) {
+  std::vector<Edge> edges((static_cast<size_t>(edgeFactor)) << scale);
+  fillRmatEdges(edges, scale, seed, pool, a, b, c);
+  return edges;
+}
+
+/// Erdos-Renyi G(n, m): every edge joins two uniform nodes. Self-loops are redrawn unless allowed; parallel
+/// edges are kept, they are rare while m is much smaller than n^2.
+inline void fillErdosRenyiEdges(std::span<Edge> out, int n, std::uint64_t seed, ThreadPool *pool = nullptr,
+                                bool allowSelfLoops = false) {
+  if (n <= 0) {
+    if (!out.empty()) {
+      throw std::invalid_argument("edges without nodes");
+    }
+    return;
+  }
+  allowSelfLoops |= n == 1;
+  sk::utils::detail::forEachSeededChunk(out, seed, pool, [=](std::span<Edge> chunk, Xoshiro256ppX4 &gen) {
+    for (auto &e : chunk) {
+      auto u = static_cast<int>(sk::utils::detail::lemireBounded(gen, n));
+      auto v = static_cast<int>(sk::utils::detail::lemireBounded(gen, n));
+      while (!allowSelfLoops && v == u) {
+        v = static_cast<int>(sk::utils::detail::lemireBounded(gen, n));
+      }
+      e = {u, v};
+    }
+  });
+}
+
+inline std::vector<Edge> erdosRenyiEdges(int n, size_t m, std::uint64_t seed, ThreadPool *pool = nullptr,
+                                         bool allowSelfLoops = false) {
+  std::vector<Edge> edges(m);
+  fillErdosRenyiEdges(edges, n, seed, pool, allowSelfLoops);
+  return edges;
+}
+
+/// Barabasi-Albert preferential attachment: node v brings k edges whose targets are drawn proportionally to
+/// degree. Follows Batagelj-Brandes, where the endpoints form one array M and edge i is (M[2i], M[2i + 1]) with
+/// M[2i] = i / k and M[2i + 1] a copy of a uniform earlier slot. The slot is picked by hashing (seed, i) rather
+/// than by a sequential RNG (Sanders, Schulz), so every edge can be resolved on its own, in parallel, by
+/// following copies until an even slot. The first node's edges are self-loops.
+inline void fillBarabasiAlbertEdges(std::span<Edge> out, int k, std::uint64_t seed, ThreadPool *pool = nullptr) {
+  if (k <= 0) {
+    throw std::invalid_argument("barabasi albert needs k >= 1");
+  }
+  const Edge *base = out.data();
+  sk::utils::detail::forEachSeededChunk(out, seed, pool, [=](std::span<Edge> chunk, Xoshiro256ppX4 &) {
+    auto i = static_cast<std::uint64_t>(chunk.data() - base);
+    for (auto &e : chunk) {
+      std::uint64_t slot = 2 * i + 1;
+      while (slot & 1) {
+        std::uint64_t j = slot >> 1;
+        // uniform in [0, 2j], the slot itself excluded
+        slot = graph_detail::scaleHash(sk::utils::detail::streamSeed(seed, j), 2 * j + 1);
+      }
+      e = {static_cast<int>(i / k), static_cast<int>((slot >> 1) / k)};
+      ++i;
+    }
+  });
+}
+
+/// n * k edges over n nodes
+inline std::vector<Edge> barabasiAlbertEdges(int n, int k, std::uint64_t seed, ThreadPool *pool = nullptr) {
+  std::vector<Edge> edges(static_cast<size_t>(n) * k);
+  fillBarabasiAlbertEdges(edges, k, seed, pool);
+  return edges;
+}
+
+/// uniform weights in [lower, upper]
+inline void randomizeWeights(std::span<Edge> edges, int lower, int upper, std::uint64_t seed,
+                             ThreadPool *pool = nullptr) {
+  const auto range = static_cast<std::uint64_t>(static_cast<std::int64_t>(upper) - lower + 1);
+  sk::utils::detail::forEachSeededChunk(edges, seed, pool, [=](std::span<Edge> chunk, Xoshiro256ppX4 &gen) {
+    for (auto &e : chunk) {
+      e.weight = static_cast<int>(lower + static_cast<std::int64_t>(sk::utils::detail::lemireBounded(gen, range)));
+    }
+  });
+}
+
+}  // namespace sk::utils::dts
+
+#endif  // SK_DATASTRUCTURE_GRAPH_GENERATORS_H
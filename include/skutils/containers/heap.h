@@ -1,116 +1,388 @@
 #ifndef SHUAIKAI_DATASTRUCTURE_HEAP_H
 #define SHUAIKAI_DATASTRUCTURE_HEAP_H
 
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
-#include "skutils/logger.h"
 #include "skutils/printer.h"
 
 namespace sk::utils::dts {
 
-template <typename ValueType, typename Compare = std::greater<ValueType>>
+/// d-ary heap helpers on a 0-indexed array. Same convention as std::priority_queue: comp(a, b) means a ranks
+/// below b, so std::less gives a max-heap and std::greater a min-heap.
+namespace heap_detail {
+
+template <size_t Arity, typename ValueType, typename Compare>
+void siftUp(ValueType *data, size_t k, Compare &comp) {
+  ValueType val = std::move(data[k]);
+  while (k > 0) {
+    size_t p = (k - 1) / Arity;
+    if (!comp(data[p], val)) {
+      break;
+    }
+    data[k] = std::move(data[p]);
+    k = p;
+  }
+  data[k] = std::move(val);
+}
+
+/// the children of a node share one or two cache lines, so a wider node trades a few compares for a
+/// shallower tree and fewer misses
+template <size_t Arity, typename ValueType, typename Compare>
+void siftDown(ValueType *data, size_t n, size_t k, Compare &comp) {
+  ValueType val = std::move(data[k]);
+  while (true) {
+    size_t first = Arity * k + 1;
+    if (first >= n) {
+      break;
+    }
+    size_t last = std::min(first + Arity, n);
+    size_t best = first;
+    for (size_t c = first + 1; c < last; ++c) {
+      if (comp(data[best], data[c])) {
+        best = c;
+      }
+    }
+    if (!comp(val, data[best])) {
+      break;
+    }
+    data[k] = std::move(data[best]);
+    k = best;
+  }
+  data[k] = std::move(val);
+}
+
+/// Replaces the root with `val` (Floyd): the hole walks down along the best children to a leaf without
+/// comparing against `val`, which then sifts up. The last element usually belongs near the bottom, so this
+/// saves about one compare per level compared with siftDown.
+template <size_t Arity, typename ValueType, typename Compare>
+void replaceTop(ValueType *data, size_t n, ValueType val, Compare &comp) {
+  size_t k = 0;
+  while (true) {
+    size_t first = Arity * k + 1;
+    if (first >= n) {
+      break;
+    }
+    size_t last = std::min(first + Arity, n);
+    size_t best = first;
+    for (size_t c = first + 1; c < last; ++c) {
+      if (comp(data[best], data[c])) {
+        best = c;
+      }
+    }
+    data[k] = std::move(data[best]);
+    k = best;
+  }
+  data[k] = std::move(val);
+  siftUp<Arity>(data, k, comp);
+}
+
+template <size_t Arity, typename ValueType, typename Compare>
+void makeHeap(ValueType *data, size_t n, Compare &comp) {
+  if (n < 2) {
+    return;
+  }
+  for (size_t i = (n - 2) / Arity + 1; i-- > 0;) {
+    siftDown<Arity>(data, n, i, comp);
+  }
+}
+
+}  // namespace heap_detail
+
+template <typename ValueType, typename Compare = std::greater<ValueType>, size_t Arity = 4>
 class Heap {
+  static_assert(Arity >= 2, "Heap arity should be at least 2");
+
   protected:
   Compare comp;
   std::vector<ValueType> data;
-  size_t elemNums;
 
-  void buildHeap();
-  void adjustUp(int k);
-  void adjustDown(int k);
+  void buildHeap() { heap_detail::makeHeap<Arity>(data.data(), data.size(), comp); }
+
+  void adjustUp(size_t k) { heap_detail::siftUp<Arity>(data.data(), k, comp); }
+
+  void adjustDown(size_t k) { heap_detail::siftDown<Arity>(data.data(), data.size(), k, comp); }
 
   public:
-  Heap() : comp(Compare()), data(1, ValueType{}), elemNums(0) {}
+  Heap() = default;
 
-  explicit Heap(std::vector<ValueType> vals) : comp(Compare()), data(std::move(vals)), elemNums(data.size()) {
-    data.insert(data.begin(), ValueType{});
+  explicit Heap(std::vector<ValueType> vals, const Compare &cmp = Compare()) : comp(cmp), data(std::move(vals)) {
     buildHeap();
   }
 
-  explicit Heap(const Compare &cmp) : comp(cmp), data(1, ValueType{}), elemNums(0) {}
+  explicit Heap(const Compare &cmp) : comp(cmp) {}
 
   ValueType &top();
+  const ValueType &top() const;
 
-  void pop() noexcept;
+  /// moves the top element out
+  ValueType pop();
   void push(ValueType val);
 
-  bool empty() const { return elemNums == 0; }
+  template <typename... Args>
+  void emplace(Args &&...args) {
+    data.emplace_back(std::forward<Args>(args)...);
+    adjustUp(data.size() - 1);
+  }
 
-  int size() const { return elemNums; }
+  void reserve(size_t n) { data.reserve(n); }
 
-  std::string toString() const {
-    return sk::utils::toString(std::vector<ValueType>(data.begin() + 1, data.begin() + 1 + elemNums));
-  }
+  void clear() { data.clear(); }
+
+  bool empty() const { return data.empty(); }
+
+  int size() const { return static_cast<int>(data.size()); }
+
+  std::string toString() const { return sk::utils::toString(data); }
 
-  static void sort(std::vector<ValueType> &vc);
+  /// in-place heapsort, leaves vc in pop order (ascending for std::greater)
+  static void sort(std::vector<ValueType> &vc, const Compare &cmp = Compare());
 };
 
-template <typename ValueType, typename Compare>
-void Heap<ValueType, Compare>::buildHeap() {
-  for (int i = elemNums / 2; i >= 1; --i) {
-    adjustDown(i);
+template <typename ValueType, typename Compare, size_t Arity>
+ValueType &Heap<ValueType, Compare, Arity>::top() {
+  if (!data.empty()) {
+    return data.front();
   }
+  throw std::out_of_range("Heap Empty");
+}
+
+template <typename ValueType, typename Compare, size_t Arity>
+const ValueType &Heap<ValueType, Compare, Arity>::top() const {
+  if (!data.empty()) {
+    return data.front();
+  }
+  throw std::out_of_range("Heap Empty");
+}
+
+template <typename ValueType, typename Compare, size_t Arity>
+ValueType Heap<ValueType, Compare, Arity>::pop() {
+  if (data.empty()) {
+    throw std::out_of_range("Heap Empty");
+  }
+  ValueType ret = std::move(data.front());
+  ValueType last = std::move(data.back());
+  data.pop_back();
+  if (!data.empty()) {
+    heap_detail::replaceTop<Arity>(data.data(), data.size(), std::move(last), comp);
+  }
+  return ret;
+}
+
+template <typename ValueType, typename Compare, size_t Arity>
+void Heap<ValueType, Compare, Arity>::push(ValueType val) {
+  data.push_back(std::move(val));
+  adjustUp(data.size() - 1);
 }
 
-template <typename ValueType, typename Compare>
-void Heap<ValueType, Compare>::adjustDown(int k) {
-  while ((2 * k) <= elemNums) {
-    int j = 2 * k;
-    if (j < elemNums && comp(data[j], data[j + 1])) {
-      j++;
+template <typename ValueType, typename Compare, size_t Arity>
+void Heap<ValueType, Compare, Arity>::sort(std::vector<ValueType> &vc, const Compare &cmp) {
+  // a heap on the reversed order keeps the element that pops last on top, moving it to the back each round
+  auto inv = [&cmp](const ValueType &a, const ValueType &b) { return cmp(b, a); };
+  auto n = vc.size();
+  heap_detail::makeHeap<Arity>(vc.data(), n, inv);
+  while (n > 1) {
+    --n;
+    ValueType last = std::move(vc[n]);
+    vc[n] = std::move(vc[0]);
+    heap_detail::replaceTop<Arity>(vc.data(), n, std::move(last), inv);
+  }
+}
+
+/// Heap with stable handles: push returns a handle that can later be used to read, change or erase that
+/// element in O(log n), e.g. decrease_key for Dijkstra. Handles of removed elements are reused.
+template <typename ValueType, typename Compare = std::greater<ValueType>, size_t Arity = 4>
+class IndexedHeap {
+  static_assert(Arity >= 2, "Heap arity should be at least 2");
+
+  public:
+  using Handle = size_t;
+  static constexpr Handle npos = std::numeric_limits<Handle>::max();
+
+  IndexedHeap() = default;
+
+  explicit IndexedHeap(const Compare &cmp) : comp(cmp) {}
+
+  Handle push(ValueType val) { return emplace(std::move(val)); }
+
+  template <typename... Args>
+  Handle emplace(Args &&...args);
+
+  const ValueType &top() const {
+    if (data.empty()) {
+      throw std::out_of_range("Heap Empty");
     }
-    if (!comp(data[k], data[j])) {
+    return data.front().val;
+  }
+
+  Handle top_handle() const { return data.empty() ? npos : data.front().handle; }
+
+  /// moves the top element out, its handle becomes invalid
+  ValueType pop();
+
+  /// moves the element towards the top, val should not rank below the current value
+  void decrease_key(Handle h, ValueType val);
+
+  /// replaces the value, in either direction
+  void update(Handle h, ValueType val);
+
+  bool erase(Handle h);
+
+  bool contains(Handle h) const { return h < pos.size() && pos[h] != npos; }
+
+  const ValueType &get(Handle h) const { return data[pos[h]].val; }
+
+  bool empty() const { return data.empty(); }
+
+  int size() const { return static_cast<int>(data.size()); }
+
+  void reserve(size_t n) {
+    data.reserve(n);
+    pos.reserve(n);
+  }
+
+  private:
+  struct Entry {
+    ValueType val;
+    Handle handle;
+  };
+
+  void place(size_t k, Entry &&e) {
+    pos[e.handle] = k;
+    data[k] = std::move(e);
+  }
+
+  void adjustUp(size_t k);
+  void adjustDown(size_t k);
+  /// removes the element at index k
+  void removeAt(size_t k);
+
+  Compare comp;
+  std::vector<Entry> data;
+  /// handle -> index in data, npos once removed
+  std::vector<size_t> pos;
+  std::vector<Handle> freeHandles;
+};
+
+template <typename ValueType, typename Compare, size_t Arity>
+template <typename... Args>
+typename IndexedHeap<ValueType, Compare, Arity>::Handle IndexedHeap<ValueType, Compare, Arity>::emplace(
+    Args &&...args) {
+  Handle h;
+  if (!freeHandles.empty()) {
+    h = freeHandles.back();
+    freeHandles.pop_back();
+  } else {
+    h = pos.size();
+    pos.push_back(npos);
+  }
+  data.push_back(Entry{ValueType(std::forward<Args>(args)...), h});
+  pos[h] = data.size() - 1;
+  adjustUp(data.size() - 1);
+  return h;
+}
+
+template <typename ValueType, typename Compare, size_t Arity>
+void IndexedHeap<ValueType, Compare, Arity>::adjustUp(size_t k) {
+  Entry e = std::move(data[k]);
+  while (k > 0) {
+    size_t p = (k - 1) / Arity;
+    if (!comp(data[p].val, e.val)) {
       break;
     }
-    std::swap(data[k], data[j]);
-    k = j;
+    place(k, std::move(data[p]));
+    k = p;
   }
+  place(k, std::move(e));
 }
 
-template <typename ValueType, typename Compare>
-void Heap<ValueType, Compare>::adjustUp(int k) {
-  while (k > 1 && comp(data[k], data[k / 2])) {
-    std::swap(data[k], data[k / 2]);
-    k /= 2;
+template <typename ValueType, typename Compare, size_t Arity>
+void IndexedHeap<ValueType, Compare, Arity>::adjustDown(size_t k) {
+  const size_t n = data.size();
+  Entry e = std::move(data[k]);
+  while (true) {
+    size_t first = Arity * k + 1;
+    if (first >= n) {
+      break;
+    }
+    size_t last = std::min(first + Arity, n);
+    size_t best = first;
+    for (size_t c = first + 1; c < last; ++c) {
+      if (comp(data[best].val, data[c].val)) {
+        best = c;
+      }
+    }
+    if (!comp(e.val, data[best].val)) {
+      break;
+    }
+    place(k, std::move(data[best]));
+    k = best;
   }
+  place(k, std::move(e));
 }
 
-template <typename ValueType, typename Compare>
-ValueType &Heap<ValueType, Compare>::top() {
-  if (elemNums >= 1) {
-    return data[1];
+template <typename ValueType, typename Compare, size_t Arity>
+void IndexedHeap<ValueType, Compare, Arity>::removeAt(size_t k) {
+  Handle h = data[k].handle;
+  pos[h] = npos;
+  freeHandles.push_back(h);
+  if (k + 1 == data.size()) {
+    data.pop_back();
+    return;
+  }
+  Entry last = std::move(data.back());
+  data.pop_back();
+  bool up = k > 0 && comp(data[(k - 1) / Arity].val, last.val);
+  place(k, std::move(last));
+  if (up) {
+    adjustUp(k);
+  } else {
+    adjustDown(k);
   }
-  throw std::out_of_range("Heap Empty");
 }
 
-template <typename ValueType, typename Compare>
-void Heap<ValueType, Compare>::pop() noexcept {
-  if (elemNums > 0) {
-    std::swap(data[1], data[elemNums]);
-    TODO("HEAP并没有真正删除元素，只是挪到了数组最后面");
-    --elemNums;
-    adjustDown(1);
+template <typename ValueType, typename Compare, size_t Arity>
+ValueType IndexedHeap<ValueType, Compare, Arity>::pop() {
+  if (data.empty()) {
+    throw std::out_of_range("Heap Empty");
   }
+  ValueType ret = std::move(data.front().val);
+  removeAt(0);
+  return ret;
 }
 
-template <typename ValueType, typename Compare>
-void Heap<ValueType, Compare>::push(ValueType val) {
-  ++elemNums;
-  data.resize(elemNums + 1);
-  data[elemNums] = std::move(val);
-  adjustUp(elemNums);
+template <typename ValueType, typename Compare, size_t Arity>
+void IndexedHeap<ValueType, Compare, Arity>::decrease_key(Handle h, ValueType val) {
+  auto k = pos[h];
+  data[k].val = std::move(val);
+  adjustUp(k);
+}
+
+template <typename ValueType, typename Compare, size_t Arity>
+void IndexedHeap<ValueType, Compare, Arity>::update(Handle h, ValueType val) {
+  auto k = pos[h];
+  bool up = comp(data[k].val, val);
+  data[k].val = std::move(val);
+  if (up) {
+    adjustUp(k);
+  } else {
+    adjustDown(k);
+  }
 }
 
-template <typename ValueType, typename Compare>
-void Heap<ValueType, Compare>::sort(std::vector<ValueType> &vc) {
-  std::vector<ValueType> ret;
-  auto heap = Heap<ValueType, Compare>(vc);
-  while (!heap.empty()) {
-    ret.push_back(heap.top());
-    heap.pop();
+template <typename ValueType, typename Compare, size_t Arity>
+bool IndexedHeap<ValueType, Compare, Arity>::erase(Handle h) {
+  if (!contains(h)) {
+    return false;
   }
-  vc.assign(ret.begin(), ret.end());
+  removeAt(pos[h]);
+  return true;
 }
 
 }  //  namespace sk::utils::dts
@@ -0,0 +1,297 @@
+#ifndef SK_DATASTRUCTURE_HEAVY_HITTERS_H
+#define SK_DATASTRUCTURE_HEAVY_HITTERS_H
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "skutils/containers/heap.h"
+
+namespace sk::utils::dts {
+
+/// Space-Saving heavy hitters with at most `capacity` counters.
+///
+/// An untracked item takes over the smallest counter and inherits its count as error, so for every tracked
+/// item count - error <= true count <= count, and any item with true count > total / capacity is tracked.
+template <typename T, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+class space_saving {
+  public:
+  struct Entry {
+    T item;
+    std::uint64_t count;
+    std::uint64_t error;
+  };
+
+  explicit space_saving(size_t capacity) : cap(std::max<size_t>(capacity, 1)) { index.reserve(cap); }
+
+  space_saving(const space_saving& o) : cap(o.cap), total_(o.total_) { rebuild(o.entries()); }
+
+  space_saving& operator=(const space_saving& o) {
+    if (&o != this) {
+      cap = o.cap;
+      total_ = o.total_;
+      rebuild(o.entries());
+    }
+    return *this;
+  }
+
+  space_saving(space_saving&&) noexcept = default;
+  space_saving& operator=(space_saving&&) noexcept = default;
+  ~space_saving() = default;
+
+  void push(const T& item, std::uint64_t weight = 1);
+
+  /// upper bound of the item's count
+  std::uint64_t estimate(const T& item) const {
+    auto it = index.find(item);
+    if (it != index.end()) {
+      return heap.get(it->second).count;
+    }
+    return full() ? heap.top().count : 0;
+  }
+
+  /// the k largest counters, largest first
+  std::vector<Entry> top(size_t k) const {
+    auto ret = entries();
+    k = std::min(k, ret.size());
+    std::partial_sort(ret.begin(), ret.begin() + k, ret.end(),
+                      [](const Entry& a, const Entry& b) { return a.count > b.count; });
+    ret.resize(k);
+    return ret;
+  }
+
+  /// all counters, largest first; the sketch is left empty
+  std::vector<Entry> pop() {
+    auto ret = top(index.size());
+    clear();
+    return ret;
+  }
+
+  /// Combines two summaries of disjoint streams: an item missing from a full summary may have had up to that
+  /// summary's minimum count there, so it is added to both its count and error, then the largest `capacity`
+  /// counters are kept.
+  void merge(const space_saving& o);
+
+  void clear() {
+    heap = Heap();
+    index.clear();
+    total_ = 0;
+  }
+
+  size_t size() const { return index.size(); }
+
+  size_t capacity() const { return cap; }
+
+  bool empty() const { return index.empty(); }
+
+  /// total weight pushed
+  std::uint64_t total() const { return total_; }
+
+  private:
+  /// the item lives in the map node, whose address is stable across rehashes
+  struct Counter {
+    std::uint64_t count;
+    std::uint64_t error;
+    const T* item;
+  };
+
+  struct CountGreater {
+    bool operator()(const Counter& a, const Counter& b) const { return a.count > b.count; }
+  };
+
+  using Heap = IndexedHeap<Counter, CountGreater>;
+
+  bool full() const { return index.size() >= cap; }
+
+  std::vector<Entry> entries() const {
+    std::vector<Entry> ret;
+    ret.reserve(index.size());
+    for (const auto& [item, h] : index) {
+      const auto& c = heap.get(h);
+      ret.push_back({item, c.count, c.error});
+    }
+    return ret;
+  }
+
+  void rebuild(const std::vector<Entry>& es) {
+    heap = Heap();
+    index.clear();
+    index.reserve(cap);
+    for (const auto& e : es) {
+      auto it = index.emplace(e.item, typename Heap::Handle{}).first;
+      it->second = heap.push({e.count, e.error, &it->first});
+    }
+  }
+
+  size_t cap;
+  std::uint64_t total_{0};
+  Heap heap;
+  std::unordered_map<T, typename Heap::Handle, Hash, KeyEqual> index;
+};
+
+template <typename T, typename Hash, typename KeyEqual>
+void space_saving<T, Hash, KeyEqual>::push(const T& item, std::uint64_t weight) {
+  total_ += weight;
+  auto it = index.find(item);
+  if (it != index.end()) {
+    auto c = heap.get(it->second);
+    c.count += weight;
+    heap.update(it->second, c);
+    return;
+  }
+  if (!full()) {
+    auto pos = index.emplace(item, typename Heap::Handle{}).first;
+    pos->second = heap.push({weight, 0, &pos->first});
+    return;
+  }
+  // replace the smallest counter
+  auto h = heap.top_handle();
+  auto victim = heap.top();
+  index.erase(index.find(*victim.item));
+  auto pos = index.emplace(item, h).first;
+  heap.update(h, {victim.count + weight, victim.count, &pos->first});
+}
+
+template <typename T, typename Hash, typename KeyEqual>
+void space_saving<T, Hash, KeyEqual>::merge(const space_saving& o) {
+  const std::uint64_t myMin = full() ? heap.top().count : 0;
+  const std::uint64_t otherMin = o.full() ? o.heap.top().count : 0;
+  std::unordered_map<T, Entry, Hash, KeyEqual> combined;
+  for (auto& e : entries()) {
+    auto it = o.index.find(e.item);
+    if (it != o.index.end()) {
+      const auto& oc = o.heap.get(it->second);
+      e.count += oc.count;
+      e.error += oc.error;
+    } else {
+      e.count += otherMin;
+      e.error += otherMin;
+    }
+    combined.emplace(e.item, e);
+  }
+  for (auto& e : o.entries()) {
+    if (combined.find(e.item) == combined.end()) {
+      e.count += myMin;
+      e.error += myMin;
+      combined.emplace(e.item, e);
+    }
+  }
+  std::vector<Entry> es;
+  es.reserve(combined.size());
+  for (auto& [item, e] : combined) {
+    es.push_back(std::move(e));
+  }
+  if (es.size() > cap) {
+    std::nth_element(es.begin(), es.begin() + cap, es.end(),
+                     [](const Entry& a, const Entry& b) { return a.count > b.count; });
+    es.resize(cap);
+  }
+  total_ += o.total_;
+  rebuild(es);
+}
+
+/// Misra-Gries frequent items with at most `k` counters. Counts never overestimate, and each is at most
+/// error_bound() <= total / (k + 1) below the true count, so every item above that frequency is kept.
+template <typename T, typename Hash = std::hash<T>, typename KeyEqual = std::equal_to<T>>
+class misra_gries {
+  public:
+  struct Entry {
+    T item;
+    std::uint64_t count;
+  };
+
+  explicit misra_gries(size_t k) : cap(std::max<size_t>(k, 1)) { counters.reserve(cap + 1); }
+
+  void push(const T& item, std::uint64_t weight = 1) {
+    total_ += weight;
+    counters[item] += weight;
+    if (counters.size() > cap) {
+      reduce();
+    }
+  }
+
+  /// lower bound of the item's count
+  std::uint64_t estimate(const T& item) const {
+    auto it = counters.find(item);
+    return it == counters.end() ? 0 : it->second;
+  }
+
+  /// how much any count may be below the true one
+  std::uint64_t error_bound() const { return decremented; }
+
+  std::vector<Entry> top(size_t k) const {
+    std::vector<Entry> ret;
+    ret.reserve(counters.size());
+    for (const auto& [item, c] : counters) {
+      ret.push_back({item, c});
+    }
+    k = std::min(k, ret.size());
+    std::partial_sort(ret.begin(), ret.begin() + k, ret.end(),
+                      [](const Entry& a, const Entry& b) { return a.count > b.count; });
+    ret.resize(k);
+    return ret;
+  }
+
+  /// all counters, largest first; the sketch is left empty
+  std::vector<Entry> pop() {
+    auto ret = top(counters.size());
+    clear();
+    return ret;
+  }
+
+  /// sums the counters, then subtracts the (k+1)-th largest count from all of them
+  void merge(const misra_gries& o) {
+    for (const auto& [item, c] : o.counters) {
+      counters[item] += c;
+    }
+    total_ += o.total_;
+    decremented += o.decremented;
+    if (counters.size() > cap) {
+      reduce();
+    }
+  }
+
+  void clear() {
+    counters.clear();
+    total_ = 0;
+    decremented = 0;
+  }
+
+  size_t size() const { return counters.size(); }
+
+  bool empty() const { return counters.empty(); }
+
+  std::uint64_t total() const { return total_; }
+
+  private:
+  void reduce() {
+    std::vector<std::uint64_t> counts;
+    counts.reserve(counters.size());
+    for (const auto& [item, c] : counters) {
+      counts.push_back(c);
+    }
+    std::nth_element(counts.begin(), counts.begin() + cap, counts.end(), std::greater<>());
+    const auto d = counts[cap];
+    for (auto it = counters.begin(); it != counters.end();) {
+      if (it->second <= d) {
+        it = counters.erase(it);
+      } else {
+        it->second -= d;
+        ++it;
+      }
+    }
+    decremented += d;
+  }
+
+  size_t cap;
+  std::uint64_t total_{0};
+  std::uint64_t decremented{0};
+  std::unordered_map<T, std::uint64_t, Hash, KeyEqual> counters;
+};
+
+}  // namespace sk::utils::dts
+
+#endif  // SK_DATASTRUCTURE_HEAVY_HITTERS_H
@@ -0,0 +1,208 @@
+#ifndef SK_DATASTRUCTURE_KLL_SKETCH_H
+#define SK_DATASTRUCTURE_KLL_SKETCH_H
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "skutils/random.h"
+
+namespace sk::utils::dts {
+
+/// KLL quantile sketch (Karnin, Lang, Liberty).
+///
+/// Items are kept in levels, an item on level h standing for 2^h inputs. When the sketch is over budget, the
+/// lowest full level is sorted and every other item, starting at a random offset, is promoted one level up.
+/// Level capacities shrink geometrically (by 2/3) going down from the top, so memory stays around 3k items
+/// and the rank error is about 1.65 / k with high probability. Sketches of any streams can be merged.
+template <typename T, typename Comp = std::less<T>>
+class kll_sketch {
+  public:
+  static constexpr size_t DEFAULT_K = 200;
+
+  explicit kll_sketch(size_t k = DEFAULT_K) : k(std::max<size_t>(k, 8)), levels(1), rng(RANDTOOL.engine()()) {}
+
+  void push(const T& item) {
+    levels[0].push_back(item);
+    ++n;
+    ++stored;
+    if (stored >= budget()) {
+      compress();
+    }
+  }
+
+  /// adds the other sketch's items, level by level
+  void merge(const kll_sketch& o) {
+    if (levels.size() < o.levels.size()) {
+      levels.resize(o.levels.size());
+    }
+    for (size_t h = 0; h < o.levels.size(); ++h) {
+      levels[h].insert(levels[h].end(), o.levels[h].begin(), o.levels[h].end());
+    }
+    n += o.n;
+    stored += o.stored;
+    while (stored >= budget()) {
+      compress();
+    }
+  }
+
+  /// approximate item at rank q * count(), q in [0, 1]
+  T quantile(double q) const;
+
+  /// quantile() for several q at once, sharing one sort
+  std::vector<T> quantiles(const std::vector<double>& qs) const;
+
+  /// approximate fraction of inputs <= item
+  double rank(const T& item) const {
+    if (n == 0) {
+      return 0.0;
+    }
+    std::uint64_t w = 0;
+    for (size_t h = 0; h < levels.size(); ++h) {
+      for (const auto& x : levels[h]) {
+        if (!comp(item, x)) {
+          w += std::uint64_t{1} << h;
+        }
+      }
+    }
+    return static_cast<double>(w) / static_cast<double>(n);
+  }
+
+  /// number of pushed items
+  std::uint64_t count() const { return n; }
+
+  /// number of items held
+  size_t retained() const { return stored; }
+
+  bool empty() const { return n == 0; }
+
+  /// the retained items sorted, each with the number of inputs it stands for (the weights sum to count());
+  /// the sketch is left empty
+  std::vector<std::pair<T, std::uint64_t>> pop() {
+    auto ret = weighted();
+    clear();
+    return ret;
+  }
+
+  void clear() {
+    levels.assign(1, {});
+    n = 0;
+    stored = 0;
+  }
+
+  private:
+  /// capacity of level h: k * (2/3)^(depth from the top), at least 2
+  size_t capacity(size_t h) const {
+    auto depth = static_cast<double>(levels.size() - 1 - h);
+    return std::max<size_t>(2, static_cast<size_t>(std::ceil(static_cast<double>(k) * std::pow(2.0 / 3.0, depth))));
+  }
+
+  size_t budget() const {
+    size_t sz = 0;
+    for (size_t h = 0; h < levels.size(); ++h) {
+      sz += capacity(h);
+    }
+    return sz;
+  }
+
+  void compress() {
+    for (size_t h = 0; h < levels.size(); ++h) {
+      if (levels[h].size() < capacity(h)) {
+        continue;
+      }
+      if (h + 1 == levels.size()) {
+        levels.emplace_back();
+      }
+      auto& cur = levels[h];
+      std::sort(cur.begin(), cur.end(), comp);
+      // an odd item stays behind so the promoted pairs exactly halve the weight
+      T leftover{};
+      bool hasLeftover = (cur.size() % 2) == 1;
+      if (hasLeftover) {
+        leftover = std::move(cur.back());
+        cur.pop_back();
+      }
+      auto& up = levels[h + 1];
+      for (size_t i = rng() & 1; i < cur.size(); i += 2) {
+        up.push_back(std::move(cur[i]));
+      }
+      stored -= cur.size() / 2;
+      cur.clear();
+      if (hasLeftover) {
+        cur.push_back(std::move(leftover));
+      }
+      return;
+    }
+  }
+
+  /// all items with their weights, sorted
+  std::vector<std::pair<T, std::uint64_t>> weighted() const {
+    std::vector<std::pair<T, std::uint64_t>> ret;
+    ret.reserve(stored);
+    for (size_t h = 0; h < levels.size(); ++h) {
+      for (const auto& x : levels[h]) {
+        ret.emplace_back(x, std::uint64_t{1} << h);
+      }
+    }
+    std::sort(ret.begin(), ret.end(), [this](const auto& a, const auto& b) { return comp(a.first, b.first); });
+    return ret;
+  }
+
+  static T pick(const std::vector<std::pair<T, std::uint64_t>>& items, std::uint64_t total, double q) {
+    auto target = static_cast<std::uint64_t>(std::ceil(std::clamp(q, 0.0, 1.0) * static_cast<double>(total)));
+    std::uint64_t acc = 0;
+    for (const auto& [x, w] : items) {
+      acc += w;
+      if (acc >= target) {
+        return x;
+      }
+    }
+    return items.back().first;
+  }
+
+  size_t k;
+  std::uint64_t n{0};
+  size_t stored{0};
+  std::vector<std::vector<T>> levels;
+  sk::utils::Xoshiro256pp rng;
+  [[no_unique_address]] Comp comp;
+};
+
+template <typename T, typename Comp>
+T kll_sketch<T, Comp>::quantile(double q) const {
+  if (n == 0) {
+    throw std::out_of_range("kll_sketch empty");
+  }
+  auto items = weighted();
+  std::uint64_t total = 0;
+  for (const auto& [x, w] : items) {
+    total += w;
+  }
+  return pick(items, total, q);
+}
+
+template <typename T, typename Comp>
+std::vector<T> kll_sketch<T, Comp>::quantiles(const std::vector<double>& qs) const {
+  if (n == 0) {
+    throw std::out_of_range("kll_sketch empty");
+  }
+  auto items = weighted();
+  std::uint64_t total = 0;
+  for (const auto& [x, w] : items) {
+    total += w;
+  }
+  std::vector<T> ret;
+  ret.reserve(qs.size());
+  for (auto q : qs) {
+    ret.push_back(pick(items, total, q));
+  }
+  return ret;
+}
+
+}  // namespace sk::utils::dts
+
+#endif  // SK_DATASTRUCTURE_KLL_SKETCH_H
@@ -1,11 +1,14 @@
 #ifndef SHUAIKAI_DATDSTRUCTURE_LC_H
 #define SHUAIKAI_DATDSTRUCTURE_LC_H
 
-#include <functional>
+#include <optional>
 #include <span>
 #include <sstream>
 #include <string>
+#include <utility>
+#include <vector>
 
+#include "skutils/arena.h"
 #include "skutils/config.h"
 
 namespace sk::utils::dts::lc {
@@ -18,7 +21,15 @@ struct ListNode {
 
   ListNode(int v, ListNode *n) : val(v), next(n) {}
 
-  ~ListNode() { delete next; }
+  /// frees the rest of the list one node at a time, a long list must not recurse once per node
+  ~ListNode() {
+    while (next != nullptr) {
+      ListNode *n = next;
+      next = n->next;
+      n->next = nullptr;
+      delete n;
+    }
+  }
 
   std::string toString();
 };
@@ -31,42 +42,135 @@ struct TreeNode {
   explicit TreeNode(int x = 0, TreeNode *left = nullptr, TreeNode *right = nullptr)
     : val(x), left(left), right(right) {}
 
+  /// frees both subtrees in O(1) extra space: a node with a left child is rotated right until it has none,
+  /// then it is deleted and its right subtree is next
   ~TreeNode() {
-    delete left;
-    delete right;
+    for (TreeNode *sub : {std::exchange(left, nullptr), std::exchange(right, nullptr)}) {
+      while (sub != nullptr) {
+        if (sub->left != nullptr) {
+          TreeNode *l = sub->left;
+          sub->left = l->right;
+          l->right = sub;
+          sub = l;
+        } else {
+          TreeNode *r = std::exchange(sub->right, nullptr);
+          delete sub;
+          sub = r;
+        }
+      }
+    }
   }
 
   std::string toString();
 };
 
+/// Arena for ListNode / TreeNode: nodes are bump-allocated next to each other and all freed at once when the pool
+/// is destroyed or reset(). Pool nodes must never be deleted, and a pool structure must not own heap nodes,
+/// since their destructors are never run.
+class NodePool {
+  public:
+  explicit NodePool(size_t blockSize = Arena::MAX_BLOCK_SIZE) : arena_(blockSize) {}
+
+  ListNode *list(int v, ListNode *next = nullptr) { return arena_.create<ListNode>(v, next); }
+
+  TreeNode *tree(int v, TreeNode *left = nullptr, TreeNode *right = nullptr) {
+    return arena_.create<TreeNode>(v, left, right);
+  }
+
+  /// frees every node at once, keeping the largest block for the next build
+  void reset() { arena_.reset(); }
+
+  size_t bytesUsed() const { return arena_.bytesUsed(); }
+
+  private:
+  Arena arena_;
+};
+
+namespace detail {
+
+template <typename MakeList>
+ListNode *buildList(std::span<const int> data, MakeList &&make) {
+  ListNode *head = nullptr;
+  ListNode **tail = &head;
+  for (auto v : data) {
+    *tail = make(v);
+    tail = &(*tail)->next;
+  }
+  return head;
+}
+
+/// LeetCode level order: after the root, entries come in (left, right) pairs for each non-null node in turn
+template <typename MakeTree>
+TreeNode *buildTree(std::span<const std::optional<int>> data, MakeTree &&make) {
+  if (data.empty() || !data[0].has_value()) {
+    return nullptr;
+  }
+  std::vector<TreeNode *> order{make(*data[0])};
+  size_t parent = 0;
+  for (size_t i = 1; i < data.size() && parent < order.size(); ++i) {
+    TreeNode *child = data[i].has_value() ? make(*data[i]) : nullptr;
+    if (child != nullptr) {
+      order.push_back(child);
+    }
+    if (i % 2 == 1) {
+      order[parent]->left = child;
+    } else {
+      order[parent++]->right = child;
+    }
+  }
+  return order[0];
+}
+
+}  // namespace detail
+
 /// MARK: tree/List tools
+/// fn(node) for every node in order, iterative
+template <typename Fn>
+void inorderTraverse(TreeNode *root, Fn &&fn) {
+  std::vector<TreeNode *> stack;
+  TreeNode *p = root;
+  while (p != nullptr || !stack.empty()) {
+    for (; p != nullptr; p = p->left) {
+      stack.push_back(p);
+    }
+    p = stack.back();
+    stack.pop_back();
+    fn(p);
+    p = p->right;
+  }
+}
+
+/// fn(node) for every node in preorder, iterative
+template <typename Fn>
+void preorderTraverse(TreeNode *root, Fn &&fn) {
+  std::vector<TreeNode *> stack;
+  if (root != nullptr) {
+    stack.push_back(root);
+  }
+  while (!stack.empty()) {
+    TreeNode *p = stack.back();
+    stack.pop_back();
+    fn(p);
+    if (p->right != nullptr) {
+      stack.push_back(p->right);
+    }
+    if (p->left != nullptr) {
+      stack.push_back(p->left);
+    }
+  }
+}
+
 inline std::string treeToString(TreeNode *root, const std::string &sep) {
   std::string ret;
   // inorder
   std::stringstream ss;
-  TreeNode *p = root;
   ss << "(In)[";
-  std::function<void(sk::utils::dts::lc::TreeNode *)> inorder = [&](TreeNode *node) {
-    if (node != nullptr) {
-      inorder(node->left);
-      ss << node->val << sep;
-      inorder(node->right);
-    }
-  };
-  inorder(p);
+  inorderTraverse(root, [&](TreeNode *node) { ss << node->val << sep; });
   ret = ss.str().substr(0, ss.str().length() - sep.length()) + "]";
   // preorder
   std::stringstream ss2;
   ss2 << "(Pre)[";
-  std::function<void(TreeNode *)> preorder = [&](TreeNode *node) {
-    if (node != nullptr) {
-      ss2 << node->val << sep;
-      preorder(node->left);
-      preorder(node->right);
-    }
-  };
-  TreeNode *q = root;
-  preorder(q);
+  preorderTraverse(root, [&](TreeNode *node) { ss2 << node->val << sep; });
   std::string ret2 = ss2.str().substr(0, ss2.str().length() - sep.length()) + "]";
   return ret2 + sep + ret;
 }
@@ -90,19 +194,24 @@ inline std::string ListNode::toString() {
   return listToString(this, ELEM_SEP);
 }
 
-inline ListNode *vector2List(std::vector<int> &&data) {
-  int len = data.size();
-  auto *head = new ListNode(data[0]);
-  auto *tail = head;
-  for (int i = 1; i < len; i++) {
-    tail->next = new ListNode(data[i]);
-    tail = tail->next;
-  }
-  return head;
+/// heap nodes, owned by the head; nullptr for no data
+inline ListNode *vector2List(const std::vector<int> &data) {
+  return detail::buildList(data, [](int v) { return new ListNode(v); });
+}
+
+/// pool nodes, laid out contiguously in list order
+inline ListNode *vector2List(const std::vector<int> &data, NodePool &pool) {
+  return detail::buildList(data, [&pool](int v) { return pool.list(v); });
+}
+
+/// heap tree from a level-order vector where nullopt marks a missing child, e.g. {1, nullopt, 2, 3}
+inline TreeNode *vector2Tree(const std::vector<std::optional<int>> &data) {
+  return detail::buildTree(data, [](int v) { return new TreeNode(v); });
 }
 
-inline ListNode *vector2List(std::vector<int> &data) {
-  return vector2List(std::move(data));
+/// pool tree from a level-order vector, laid out contiguously in level order
+inline TreeNode *vector2Tree(const std::vector<std::optional<int>> &data, NodePool &pool) {
+  return detail::buildTree(data, [&pool](int v) { return pool.tree(v); });
 }
 
 inline void reverseList(ListNode **head) {
@@ -0,0 +1,590 @@
+#ifndef SK_DATASTRUCTURE_LRU_CACHE_H
+#define SK_DATASTRUCTURE_LRU_CACHE_H
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <utility>
+#include <vector>
+
+#include "skutils/containers/flat_hash_map.h"
+#include "skutils/containers/shard_detail.h"
+#include "skutils/spinlock.h"
+
+namespace sk::utils::dts {
+
+struct CacheStats {
+  size_t hits{0};
+  size_t misses{0};
+  /// live entries dropped to make room
+  size_t evictions{0};
+  /// entries found past their deadline, counted as misses as well
+  size_t expirations{0};
+
+  double hitRate() const { return hits + misses == 0 ? 0.0 : static_cast<double>(hits) / (hits + misses); }
+
+  CacheStats &operator+=(const CacheStats &o) {
+    hits += o.hits;
+    misses += o.misses;
+    evictions += o.evictions;
+    expirations += o.expirations;
+    return *this;
+  }
+};
+
+namespace cache_detail {
+
+using Clock = std::chrono::steady_clock;
+
+inline constexpr std::uint32_t NIL = UINT32_MAX;
+inline constexpr Clock::time_point NEVER = Clock::time_point::max();
+
+template <typename K, typename V>
+struct Node {
+  explicit Node(const K &k) : key(k) {}
+
+  K key;
+  /// empty for ARC ghost entries, which only remember the key
+  std::optional<V> value;
+  Clock::time_point expire{NEVER};
+  size_t weight{0};
+  std::uint32_t prev{NIL};
+  std::uint32_t next{NIL};
+  std::uint8_t list{0};
+};
+
+struct List {
+  std::uint32_t head{NIL};
+  std::uint32_t tail{NIL};
+  size_t size{0};
+};
+
+/// Doubly linked lists threaded through one node vector by index, so moving an entry to the front touches no
+/// allocator. Released nodes are reused by the next alloc().
+template <typename K, typename V>
+class Slab {
+  public:
+  std::vector<Node<K, V>> nodes;
+
+  std::uint32_t alloc(const K &key) {
+    if (free_.empty()) {
+      nodes.emplace_back(key);
+      return static_cast<std::uint32_t>(nodes.size() - 1);
+    }
+    auto i = free_.back();
+    free_.pop_back();
+    nodes[i].key = key;
+    return i;
+  }
+
+  void release(std::uint32_t i) {
+    nodes[i].value.reset();
+    free_.push_back(i);
+  }
+
+  void pushFront(List &l, std::uint32_t i, std::uint8_t id = 0) {
+    auto &n = nodes[i];
+    n.prev = NIL;
+    n.next = l.head;
+    n.list = id;
+    if (l.head != NIL) {
+      nodes[l.head].prev = i;
+    } else {
+      l.tail = i;
+    }
+    l.head = i;
+    ++l.size;
+  }
+
+  void unlink(List &l, std::uint32_t i) {
+    auto &n = nodes[i];
+    (n.prev != NIL ? nodes[n.prev].next : l.head) = n.next;
+    (n.next != NIL ? nodes[n.next].prev : l.tail) = n.prev;
+    --l.size;
+  }
+
+  void clear() {
+    nodes.clear();
+    free_.clear();
+  }
+
+  private:
+  std::vector<std::uint32_t> free_;
+};
+
+inline Clock::time_point deadline(Clock::duration ttl) {
+  return ttl > Clock::duration::zero() ? Clock::now() + ttl : NEVER;
+}
+
+/// reads the clock only for entries that can expire
+inline bool expired(Clock::time_point expire) {
+  return expire != NEVER && expire <= Clock::now();
+}
+
+}  // namespace cache_detail
+
+/// Least recently used cache with O(1) get / put / erase.
+///
+/// Entries weigh weigher(key, value), 1 each by default, and the least recently used ones are evicted until the
+/// total weight fits the capacity; an entry heavier than the whole capacity is not kept at all. With a ttl an
+/// entry expires that long after its last put, and an expired entry is dropped by the lookup that finds it.
+/// Not thread safe, see ConcurrentCache.
+template <typename K, typename V, typename Hash = flat_hash<K>, typename Eq = std::equal_to<>>
+class LruCache {
+  public:
+  using key_type = K;
+  using mapped_type = V;
+  using hasher = Hash;
+  using key_equal = Eq;
+  using Clock = cache_detail::Clock;
+  using Weigher = std::function<size_t(const K &, const V &)>;
+
+  /// ttl = 0 keeps entries until they are evicted
+  explicit LruCache(size_t capacity, Clock::duration ttl = Clock::duration::zero(), Weigher weigher = {})
+    : capacity_(capacity), ttl_(ttl), weigher_(std::move(weigher)) {}
+
+  /// a copy of the value, marking it most recently used
+  std::optional<V> get(const K &key) { return get<K>(key); }
+
+  template <typename K2>
+    requires flat_hash_detail::LookupKey<K2, K, Hash, Eq>
+  std::optional<V> get(const K2 &key) {
+    auto i = lookup(key);
+    if (i == cache_detail::NIL) {
+      return std::nullopt;
+    }
+    slab_.unlink(lru_, i);
+    slab_.pushFront(lru_, i);
+    return slab_.nodes[i].value;
+  }
+
+  /// whether key is cached and unexpired, without touching its recency or the counters
+  bool contains(const K &key) const { return contains<K>(key); }
+
+  template <typename K2>
+    requires flat_hash_detail::LookupKey<K2, K, Hash, Eq>
+  bool contains(const K2 &key) const {
+    auto it = index_.find(key);
+    return it != index_.end() && !cache_detail::expired(slab_.nodes[it->second].expire);
+  }
+
+  template <typename KK, typename VV>
+  void put(KK &&key, VV &&value) {
+    put(std::forward<KK>(key), std::forward<VV>(value), ttl_);
+  }
+
+  /// inserts or replaces the value of key with its own ttl, then evicts down to the capacity
+  template <typename KK, typename VV>
+  void put(KK &&key, VV &&value, Clock::duration ttl) {
+    auto [it, inserted] = index_.try_emplace(std::forward<KK>(key), cache_detail::NIL);
+    std::uint32_t i = it->second;
+    if (inserted) {
+      i = it->second = slab_.alloc(it->first);
+    } else {
+      slab_.unlink(lru_, i);
+    }
+    auto &n = slab_.nodes[i];
+    n.value = std::forward<VV>(value);
+    n.expire = cache_detail::deadline(ttl);
+    weight_ -= n.weight;
+    n.weight = weigher_ ? weigher_(n.key, *n.value) : 1;
+    weight_ += n.weight;
+    slab_.pushFront(lru_, i);
+    if (n.weight > capacity_) {
+      remove(i);
+      return;
+    }
+    while (weight_ > capacity_) {
+      stats_.evictions++;
+      remove(lru_.tail);
+    }
+  }
+
+  bool erase(const K &key) { return erase<K>(key); }
+
+  template <typename K2>
+    requires flat_hash_detail::LookupKey<K2, K, Hash, Eq>
+  bool erase(const K2 &key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      return false;
+    }
+    remove(it->second);
+    return true;
+  }
+
+  /// drops every expired entry, O(n)
+  size_t purgeExpired() {
+    size_t dropped = 0;
+    for (auto i = lru_.head; i != cache_detail::NIL;) {
+      auto next = slab_.nodes[i].next;
+      if (cache_detail::expired(slab_.nodes[i].expire)) {
+        remove(i);
+        dropped++;
+      }
+      i = next;
+    }
+    stats_.expirations += dropped;
+    return dropped;
+  }
+
+  void clear() {
+    index_.clear();
+    slab_.clear();
+    lru_ = {};
+    weight_ = 0;
+  }
+
+  size_t size() const { return lru_.size; }
+
+  size_t weight() const { return weight_; }
+
+  size_t capacity() const { return capacity_; }
+
+  const CacheStats &stats() const { return stats_; }
+
+  private:
+  /// index of the live entry for key, counting the hit or the miss
+  template <typename K2>
+  std::uint32_t lookup(const K2 &key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+      stats_.misses++;
+      return cache_detail::NIL;
+    }
+    auto i = it->second;
+    if (cache_detail::expired(slab_.nodes[i].expire)) {
+      stats_.expirations++;
+      stats_.misses++;
+      remove(i);
+      return cache_detail::NIL;
+    }
+    stats_.hits++;
+    return i;
+  }
+
+  void remove(std::uint32_t i) {
+    auto &n = slab_.nodes[i];
+    weight_ -= n.weight;
+    n.weight = 0;
+    slab_.unlink(lru_, i);
+    index_.erase(n.key);
+    slab_.release(i);
+  }
+
+  size_t capacity_;
+  Clock::duration ttl_;
+  Weigher weigher_;
+  size_t weight_{0};
+  flat_hash_map<K, std::uint32_t, Hash, Eq> index_;
+  cache_detail::Slab<K, V> slab_;
+  cache_detail::List lru_;
+  CacheStats stats_;
+};
+
+/// Adaptive replacement cache (Megiddo and Modha, FAST '03) holding up to capacity entries.
+///
+/// T1 holds keys seen once recently and T2 keys seen at least twice; B1 / B2 remember the keys last evicted from
+/// each, without their values. A put that hits a ghost in B1 means T1 was too small and moves the target size p
+/// of T1 up, one in B2 moves it down, so a scan of one-off keys cannot flush the frequently used ones the way it
+/// flushes an LRU. Everything is O(1); the ghosts cost one key each, at most capacity of them.
+/// ttl works as in LruCache. Not thread safe, see ConcurrentCache.
+template <typename K, typename V, typename Hash = flat_hash<K>, typename Eq = std::equal_to<>>
+class ArcCache {
+  public:
+  using key_type = K;
+  using mapped_type = V;
+  using hasher = Hash;
+  using key_equal = Eq;
+  using Clock = cache_detail::Clock;
+
+  explicit ArcCache(size_t capacity, Clock::duration ttl = Clock::duration::zero())
+    : capacity_(std::max<size_t>(capacity, 1)), ttl_(ttl) {}
+
+  std::optional<V> get(const K &key) { return get<K>(key); }
+
+  template <typename K2>
+    requires flat_hash_detail::LookupKey<K2, K, Hash, Eq>
+  std::optional<V> get(const K2 &key) {
+    auto it = index_.find(key);
+    if (it == index_.end() || isGhost(it->second)) {
+      stats_.misses++;
+      return std::nullopt;
+    }
+    auto i = it->second;
+    if (cache_detail::expired(slab_.nodes[i].expire)) {
+      stats_.expirations++;
+      stats_.misses++;
+      remove(i);
+      return std::nullopt;
+    }
+    stats_.hits++;
+    moveTo(i, T2);
+    return slab_.nodes[i].value;
+  }
+
+  bool contains(const K &key) const { return contains<K>(key); }
+
+  template <typename K2>
+    requires flat_hash_detail::LookupKey<K2, K, Hash, Eq>
+  bool contains(const K2 &key) const {
+    auto it = index_.find(key);
+    return it != index_.end() && !isGhost(it->second) && !cache_detail::expired(slab_.nodes[it->second].expire);
+  }
+
+  template <typename KK, typename VV>
+  void put(KK &&key, VV &&value) {
+    auto i = cache_detail::NIL;
+    if (auto it = index_.find(key); it != index_.end()) {
+      i = it->second;
+      auto &ls = lists_;
+      switch (slab_.nodes[i].list) {
+        case B1:
+          p_ = std::min(capacity_, p_ + std::max<size_t>(ls[B2].size / ls[B1].size, 1));
+          replace(false);
+          break;
+        case B2: {
+          auto d = std::max<size_t>(ls[B1].size / ls[B2].size, 1);
+          p_ = p_ > d ? p_ - d : 0;
+          replace(true);
+          break;
+        }
+        default:
+          break;
+      }
+      moveTo(i, T2);
+    } else {
+      makeRoom();
+      auto slot = index_.try_emplace(std::forward<KK>(key), cache_detail::NIL).first;
+      i = slot->second = slab_.alloc(slot->first);
+      slab_.pushFront(lists_[T1], i, T1);
+    }
+    slab_.nodes[i].value = std::forward<VV>(value);
+    slab_.nodes[i].expire = cache_detail::deadline(ttl_);
+  }
+
+  bool erase(const K &key) { return erase<K>(key); }
+
+  template <typename K2>
+    requires flat_hash_detail::LookupKey<K2, K, Hash, Eq>
+  bool erase(const K2 &key) {
+    auto it = index_.find(key);
+    if (it == index_.end() || isGhost(it->second)) {
+      return false;
+    }
+    remove(it->second);
+    return true;
+  }
+
+  void clear() {
+    index_.clear();
+    slab_.clear();
+    lists_ = {};
+    p_ = 0;
+  }
+
+  size_t size() const { return lists_[T1].size + lists_[T2].size; }
+
+  size_t capacity() const { return capacity_; }
+
+  /// target size of T1, for tests and tuning
+  size_t recencyTarget() const { return p_; }
+
+  const CacheStats &stats() const { return stats_; }
+
+  private:
+  enum : std::uint8_t { T1, T2, B1, B2 };
+
+  bool isGhost(std::uint32_t i) const { return slab_.nodes[i].list >= B1; }
+
+  void moveTo(std::uint32_t i, std::uint8_t list) {
+    slab_.unlink(lists_[slab_.nodes[i].list], i);
+    slab_.pushFront(lists_[list], i, list);
+  }
+
+  void remove(std::uint32_t i) {
+    slab_.unlink(lists_[slab_.nodes[i].list], i);
+    index_.erase(slab_.nodes[i].key);
+    slab_.release(i);
+  }
+
+  /// turns the LRU entry of T1 or T2 into a ghost; only needed while the cache is full, which erase and
+  /// expiry can break
+  void replace(bool hitB2) {
+    auto &t1 = lists_[T1];
+    auto &t2 = lists_[T2];
+    if (t1.size + t2.size < capacity_) {
+      return;
+    }
+    bool fromT1 = t1.size > 0 && (t2.size == 0 || t1.size > p_ || (hitB2 && t1.size == p_));
+    auto i = fromT1 ? t1.tail : t2.tail;
+    stats_.evictions++;
+    moveTo(i, fromT1 ? B1 : B2);
+    slab_.nodes[i].value.reset();
+  }
+
+  /// case IV of the paper: a key in none of the four lists is about to enter T1
+  void makeRoom() {
+    auto &ls = lists_;
+    if (ls[T1].size + ls[B1].size >= capacity_) {
+      if (ls[T1].size < capacity_) {
+        remove(ls[B1].tail);
+        replace(false);
+      } else {
+        stats_.evictions++;
+        remove(ls[T1].tail);
+      }
+    } else if (ls[T1].size + ls[T2].size + ls[B1].size + ls[B2].size >= capacity_) {
+      if (ls[T1].size + ls[T2].size + ls[B1].size + ls[B2].size >= 2 * capacity_) {
+        remove(ls[B2].tail);
+      }
+      replace(false);
+    }
+  }
+
+  size_t capacity_;
+  Clock::duration ttl_;
+  size_t p_{0};
+  flat_hash_map<K, std::uint32_t, Hash, Eq> index_;
+  cache_detail::Slab<K, V> slab_;
+  std::array<cache_detail::List, 4> lists_{};
+  CacheStats stats_;
+};
+
+/// Thread safe cache made of independently locked shards of Cache (LruCache or ArcCache), picked by key hash;
+/// the capacity is split evenly between them, so eviction is per shard rather than global. There are never more
+/// shards than capacity, so each shard can hold at least one entry.
+template <typename Cache>
+class ConcurrentCache {
+  public:
+  using key_type = typename Cache::key_type;
+  using mapped_type = typename Cache::mapped_type;
+
+  /// shardNum = 0 picks one shard per hardware thread, halved while that exceeds capacity; args go to every
+  /// shard's constructor after its capacity
+  template <typename... Args>
+  explicit ConcurrentCache(size_t capacity, size_t shardNum = 0, const Args &...args)
+    : shardMask(shardMaskFor(capacity, shardNum)) {
+    shards.reserve(shardMask + 1);
+    for (size_t i = 0; i <= shardMask; ++i) {
+      shards.push_back(std::make_unique<Shard>(capacity / (shardMask + 1) + (i < capacity % (shardMask + 1)), args...));
+    }
+  }
+
+  std::optional<mapped_type> get(const key_type &key) { return get<key_type>(key); }
+
+  template <typename K2>
+    requires flat_hash_detail::LookupKey<K2, key_type, typename Cache::hasher, typename Cache::key_equal>
+  std::optional<mapped_type> get(const K2 &key) {
+    auto &shard = shardOf(key);
+    sk::utils::SpinLockGuard guard{shard.spinlock};
+    return shard.cache.get(key);
+  }
+
+  bool contains(const key_type &key) const { return contains<key_type>(key); }
+
+  template <typename K2>
+    requires flat_hash_detail::LookupKey<K2, key_type, typename Cache::hasher, typename Cache::key_equal>
+  bool contains(const K2 &key) const {
+    auto &shard = shardOf(key);
+    sk::utils::SpinLockGuard guard{shard.spinlock};
+    return shard.cache.contains(key);
+  }
+
+  template <typename KK, typename... Args>
+  void put(KK &&key, Args &&...args) {
+    auto &shard = shardOf(key);
+    sk::utils::SpinLockGuard guard{shard.spinlock};
+    shard.cache.put(std::forward<KK>(key), std::forward<Args>(args)...);
+  }
+
+  bool erase(const key_type &key) { return erase<key_type>(key); }
+
+  template <typename K2>
+    requires flat_hash_detail::LookupKey<K2, key_type, typename Cache::hasher, typename Cache::key_equal>
+  bool erase(const K2 &key) {
+    auto &shard = shardOf(key);
+    sk::utils::SpinLockGuard guard{shard.spinlock};
+    return shard.cache.erase(key);
+  }
+
+  void clear() {
+    for (auto &shard : shards) {
+      sk::utils::SpinLockGuard guard{shard->spinlock};
+      shard->cache.clear();
+    }
+  }
+
+  size_t size() const {
+    size_t sz = 0;
+    for (const auto &shard : shards) {
+      sk::utils::SpinLockGuard guard{shard->spinlock};
+      sz += shard->cache.size();
+    }
+    return sz;
+  }
+
+  /// the counters of all shards added up
+  CacheStats stats() const {
+    CacheStats ret;
+    for (const auto &shard : shards) {
+      sk::utils::SpinLockGuard guard{shard->spinlock};
+      ret += shard->cache.stats();
+    }
+    return ret;
+  }
+
+  size_t shard_count() const { return shardMask + 1; }
+
+  private:
+  struct alignas(64) Shard {
+    template <typename... Args>
+    explicit Shard(size_t capacity, const Args &...args) : cache(capacity, args...) {}
+
+    mutable sk::utils::SpinLock spinlock;
+    Cache cache;
+  };
+
+  /// a shard with capacity 0 would drop every put for the keys hashed to it
+  static size_t shardMaskFor(size_t capacity, size_t shardNum) {
+    auto mask = shard_detail::shardMaskFor(shardNum);
+    while (mask > 0 && mask >= capacity) {
+      mask >>= 1;
+    }
+    return mask;
+  }
+
+  template <typename K2>
+  Shard &shardOf(const K2 &key) const {
+    auto h = static_cast<std::uint64_t>(typename Cache::hasher{}(key)) * 0x9E3779B97F4A7C15ULL;
+    return *shards[(h >> 32) & shardMask];
+  }
+
+  size_t shardMask;
+  std::vector<std::unique_ptr<Shard>> shards;
+};
+
+/// Wraps fn so that each result is looked up in cache first and stored there after a miss. The cache key is
+/// built as key_type(args...), so a function of several arguments needs a tuple-like key with a matching hasher.
+/// cache must outlive the wrapper. With a ConcurrentCache the wrapper is thread safe, but two threads missing on
+/// the same key at once both call fn.
+template <typename Cache, typename Fn>
+auto memoize(Fn fn, Cache &cache) {
+  return [fn = std::move(fn), &cache](const auto &...args) -> typename Cache::mapped_type {
+    typename Cache::key_type key(args...);
+    if (auto hit = cache.get(key)) {
+      return std::move(*hit);
+    }
+    typename Cache::mapped_type value = std::invoke(fn, args...);
+    cache.put(std::move(key), value);
+    return value;
+  };
+}
+
+}  // namespace sk::utils::dts
+
+#endif  // SK_DATASTRUCTURE_LRU_CACHE_H
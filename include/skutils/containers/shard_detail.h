@@ -0,0 +1,31 @@
+#ifndef SK_DATASTRUCTURE_SHARD_DETAIL_H
+#define SK_DATASTRUCTURE_SHARD_DETAIL_H
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <thread>
+
+namespace sk::utils::dts::shard_detail {
+
+/// shardNum = 0 picks one shard per hardware thread; the count is rounded up to a power of two and returned
+/// minus one, ready to mask a hash with
+inline size_t shardMaskFor(size_t shardNum) {
+  if (shardNum == 0) {
+    shardNum = std::max<size_t>(std::thread::hardware_concurrency(), 1);
+  }
+  return std::bit_ceil(shardNum) - 1;
+}
+
+/// the shard the calling thread always writes to, so that a thread keeps hitting the same lock and cache lines.
+/// Threads are numbered round-robin on first use, so no two of the first shardMask + 1 threads share a shard
+inline size_t localShardIndex(size_t shardMask) {
+  static std::atomic<size_t> nextThread{0};
+  thread_local const size_t tid = nextThread.fetch_add(1, std::memory_order_relaxed);
+  return tid & shardMask;
+}
+
+}  // namespace sk::utils::dts::shard_detail
+
+#endif  // SK_DATASTRUCTURE_SHARD_DETAIL_H
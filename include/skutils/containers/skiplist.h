@@ -1,52 +1,180 @@
 #ifndef SHUAIKAI_DATASTRUCTURE_SKIP_LIST_H
 #define SHUAIKAI_DATASTRUCTURE_SKIP_LIST_H
 
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 #include <iostream>
-#include <random>
+#include <iterator>
+#include <new>
+#include <numeric>
 #include <stdexcept>
 #include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "skutils/arena.h"
+#include "skutils/noncopyable.h"
 #include "skutils/printer.h"
 #include "skutils/random.h"
 
 namespace sk::utils::dts {
 
+/// The forward pointers live right after the node in the same allocation (see SkipList::create_node), so a
+/// level hop touches one cache line instead of the node plus a separate vector buffer.
 template <typename K, typename V>
-struct SkipListNode {
+struct alignas(void *) SkipListNode {
   K key;
   V val;
 
   int level;
-  std::vector<SkipListNode *> nextNodes;
 
-  explicit SkipListNode(int level, K k = K{}, V v = V{})
-    : key(k), val(v), level(level), nextNodes(vector<SkipListNode *>(level, nullptr)) {}
+  SkipListNode(int level, const K &k, const V &v) : key(k), val(v), level(level) {}
+
+  SkipListNode *&next(int i) { return reinterpret_cast<SkipListNode **>(this + 1)[i]; }
+
+  SkipListNode *next(int i) const { return reinterpret_cast<SkipListNode *const *>(this + 1)[i]; }
 };
 
 template <typename K, typename V>
-class SkipList {
+class SkipList : public NonCopyable {
+  using Node = SkipListNode<K, V>;
+
   public:
-  SkipList() : head(new SkipListNode<K, V>(max_level)) {}
+  /// forward iterator over the nodes in key order
+  template <bool Const>
+  class Iterator {
+    public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = Node;
+    using difference_type = std::ptrdiff_t;
+    using pointer = std::conditional_t<Const, const Node *, Node *>;
+    using reference = std::conditional_t<Const, const Node &, Node &>;
+
+    Iterator() = default;
+
+    explicit Iterator(pointer node) : node_(node) {}
+
+    reference operator*() const { return *node_; }
+
+    pointer operator->() const { return node_; }
+
+    Iterator &operator++() {
+      node_ = node_->next(0);
+      return *this;
+    }
+
+    Iterator operator++(int) {
+      auto tmp = *this;
+      ++*this;
+      return tmp;
+    }
+
+    bool operator==(const Iterator &o) const { return node_ == o.node_; }
+
+    bool operator!=(const Iterator &o) const { return node_ != o.node_; }
+
+    private:
+    pointer node_{nullptr};
+  };
+
+  using iterator = Iterator<false>;
+  using const_iterator = Iterator<true>;
+
+  SkipList() : head(create_node(max_level, K{}, V{})) {}
+
+  ~SkipList();
+
+  Node *find(const K &key) const;
+  V &operator[](const K &key);
+  bool insert(const K &key, const V &val);
+  bool erase(const K &key);
+
+  /// Appends (key, val) pairs sorted by key in O(n): towers are linked to the current tail of each level with
+  /// no searching. Duplicates are skipped, keys not above the current maximum go through insert(). Returns the
+  /// number of inserted pairs.
+  template <typename It>
+  size_t bulk_load(It first, It last);
+
+  template <typename Range>
+  size_t bulk_load(const Range &range) {
+    return bulk_load(std::begin(range), std::end(range));
+  }
+
+  /// sorts the pairs and inserts them in key order, each search starting from the previous path (finger)
+  size_t insert_batch(std::vector<std::pair<K, V>> items);
+
+  /// find() for every key, in input order. The keys are sorted and split over several finger searches that
+  /// advance in turns, prefetching the next node of each so the cache misses overlap.
+  std::vector<Node *> find_batch(const std::vector<K> &keys) const;
+
+  /// first node with key >= `key`
+  iterator lower_bound(const K &key) { return iterator(lower_bound_node(key)); }
+
+  const_iterator lower_bound(const K &key) const { return const_iterator(lower_bound_node(key)); }
+
+  /// first node with key > `key`
+  iterator upper_bound(const K &key) {
+    auto it = lower_bound(key);
+    return (it != end() && !(key < it->key)) ? ++it : it;
+  }
+
+  const_iterator upper_bound(const K &key) const {
+    auto it = lower_bound(key);
+    return (it != end() && !(key < it->key)) ? ++it : it;
+  }
+
+  iterator begin() { return iterator(head->next(0)); }
+
+  iterator end() { return iterator(); }
+
+  const_iterator begin() const { return const_iterator(head->next(0)); }
 
-  SkipListNode<K, V> *find(K key) const;
-  V &operator[](K key);
-  bool insert(K key, V val);
-  bool erase(K key);
+  const_iterator end() const { return const_iterator(); }
 
   int size() const { return node_num; }
 
   bool empty() const { return node_num == 0; }
 
+  /// number of levels currently in use
+  int level() const { return cur_level; }
+
   void dump() const;
 
   private:
   static int get_random_level();
 
+  /// a freed node keeps the free list link where its first forward pointer was
+  static Node *&free_link(void *mem) {
+    return *reinterpret_cast<Node **>(static_cast<std::byte *>(mem) + sizeof(Node));
+  }
+
+  Node *create_node(int level, const K &key, const V &val);
+  void destroy_node(Node *node);
+
+  /// last node with key < `key` on every level in use, the rest of `update` is filled with head
+  Node *find_predecessors(const K &key, Node **update) const;
+
+  Node *lower_bound_node(const K &key) const;
+
+  /// like find_predecessors, but each level starts from the further of the level above and the previous
+  /// path in `update`, which must hold predecessors of a key <= `key`
+  void finger_predecessors(const K &key, Node **update) const;
+
+  /// links a new node after the predecessors in `update`
+  Node *link_after(Node **update, const K &key, const V &val);
+
+  constexpr static const int batch_lanes = 16;
+
   constexpr static const int max_level = 20;
   constexpr static const double factor = 0.5;
   int node_num{};
-  SkipListNode<K, V> *head;
+  int cur_level{1};
+  Arena arena;
+  /// erased nodes by level, reused by later inserts of the same height
+  Node *free_lists[max_level + 1]{};
+  Node *head;
 };
 
 // template <typename K, typename V>
@@ -58,22 +186,232 @@ class SkipList {
 
 template <typename K, typename V>
 int SkipList<K, V>::get_random_level() {
-  int level = 1;
-  while (RANDTOOL.getRandomDouble(0, 1) < 0.5 && level <= max_level) {
-    ++level;
+  return RANDTOOL.getRandomLevel(max_level);
+}
+
+template <typename K, typename V>
+SkipList<K, V>::~SkipList() {
+  auto curr = head;
+  while (curr != nullptr) {
+    auto next = curr->next(0);
+    curr->~Node();
+    curr = next;
   }
-  return level;
 }
 
 template <typename K, typename V>
-SkipListNode<K, V> *SkipList<K, V>::find(K key) const {
+SkipListNode<K, V> *SkipList<K, V>::create_node(int level, const K &key, const V &val) {
+  void *mem = free_lists[level];
+  if (mem != nullptr) {
+    free_lists[level] = free_link(mem);
+  } else {
+    mem = arena.allocate(sizeof(Node) + sizeof(Node *) * level, alignof(Node));
+  }
+  auto node = new (mem) Node(level, key, val);
+  for (int i = 0; i < level; ++i) {
+    node->next(i) = nullptr;
+  }
+  return node;
+}
+
+template <typename K, typename V>
+void SkipList<K, V>::destroy_node(Node *node) {
+  int level = node->level;
+  node->~Node();
+  free_link(node) = free_lists[level];
+  free_lists[level] = node;
+}
+
+template <typename K, typename V>
+SkipListNode<K, V> *SkipList<K, V>::find_predecessors(const K &key, Node **update) const {
+  auto curr = head;
+  for (int i = max_level - 1; i >= cur_level; --i) {
+    update[i] = head;
+  }
+  for (int i = cur_level - 1; i >= 0; --i) {
+    while (curr->next(i) != nullptr && curr->next(i)->key < key) {
+      curr = curr->next(i);
+    }
+    update[i] = curr;
+  }
+  return curr;
+}
+
+template <typename K, typename V>
+SkipListNode<K, V> *SkipList<K, V>::lower_bound_node(const K &key) const {
+  auto curr = head;
+  for (int i = cur_level - 1; i >= 0; --i) {
+    while (curr->next(i) != nullptr && curr->next(i)->key < key) {
+      curr = curr->next(i);
+    }
+  }
+  return curr->next(0);
+}
+
+template <typename K, typename V>
+void SkipList<K, V>::finger_predecessors(const K &key, Node **update) const {
+  auto curr = head;
+  for (int i = cur_level - 1; i >= 0; --i) {
+    if (update[i] != head && (curr == head || curr->key < update[i]->key)) {
+      curr = update[i];
+    }
+    while (curr->next(i) != nullptr && curr->next(i)->key < key) {
+      curr = curr->next(i);
+    }
+    update[i] = curr;
+  }
+}
+
+template <typename K, typename V>
+SkipListNode<K, V> *SkipList<K, V>::link_after(Node **update, const K &key, const V &val) {
+  int level = get_random_level();
+  auto newNode = create_node(level, key, val);
+  for (int i = 0; i < level; ++i) {
+    newNode->next(i) = update[i]->next(i);
+    update[i]->next(i) = newNode;
+  }
+  if (level > cur_level) {
+    cur_level = level;
+  }
+  ++node_num;
+  return newNode;
+}
+
+template <typename K, typename V>
+template <typename It>
+size_t SkipList<K, V>::bulk_load(It first, It last) {
+  // tail[i]: last node on level i
+  Node *tail[max_level];
   auto curr = head;
   for (int i = max_level - 1; i >= 0; --i) {
-    while (curr->nextNodes[i] != nullptr && curr->nextNodes[i]->key < key) {
-      curr = curr->nextNodes[i];
+    while (curr->next(i) != nullptr) {
+      curr = curr->next(i);
+    }
+    tail[i] = curr;
+  }
+  size_t inserted = 0;
+  for (; first != last; ++first) {
+    const auto &[key, val] = *first;
+    if (tail[0] != head && !(tail[0]->key < key)) {
+      if (key < tail[0]->key) {
+        // out of order: regular insert, then move the tails past anything it appended
+        inserted += insert(key, val);
+        for (int i = 0; i < cur_level; ++i) {
+          while (tail[i]->next(i) != nullptr) {
+            tail[i] = tail[i]->next(i);
+          }
+        }
+      }
+      continue;
+    }
+    auto node = link_after(tail, key, val);
+    for (int i = 0; i < node->level; ++i) {
+      tail[i] = node;
+    }
+    ++inserted;
+  }
+  return inserted;
+}
+
+template <typename K, typename V>
+size_t SkipList<K, V>::insert_batch(std::vector<std::pair<K, V>> items) {
+  std::stable_sort(items.begin(), items.end(), [](const auto &a, const auto &b) { return a.first < b.first; });
+  Node *update[max_level];
+  std::fill(update, update + max_level, head);
+  size_t inserted = 0;
+  for (size_t i = 0; i < items.size(); ++i) {
+    const auto &[key, val] = items[i];
+    if (i > 0 && !(items[i - 1].first < key)) {
+      continue;  // first of equal keys wins, as with insert()
+    }
+    finger_predecessors(key, update);
+    auto curr = update[0]->next(0);
+    if (curr != nullptr && curr->key == key) {
+      continue;
+    }
+    auto node = link_after(update, key, val);
+    for (int l = 0; l < node->level; ++l) {
+      update[l] = node;
+    }
+    ++inserted;
+  }
+  return inserted;
+}
+
+template <typename K, typename V>
+std::vector<SkipListNode<K, V> *> SkipList<K, V>::find_batch(const std::vector<K> &keys) const {
+  std::vector<Node *> result(keys.size(), nullptr);
+  if (keys.empty()) {
+    return result;
+  }
+  std::vector<std::uint32_t> order(keys.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::sort(order.begin(), order.end(), [&keys](auto a, auto b) { return keys[a] < keys[b]; });
+
+  // each lane walks a contiguous slice of the sorted keys with its own finger
+  struct Lane {
+    size_t pos;
+    size_t end;
+    int lvl;
+    Node *curr;
+    Node *finger[max_level];
+  };
+  const size_t laneNum = std::min<size_t>(batch_lanes, keys.size());
+  Lane lanes[batch_lanes];
+  for (size_t j = 0; j < laneNum; ++j) {
+    auto &lane = lanes[j];
+    lane.pos = keys.size() * j / laneNum;
+    lane.end = keys.size() * (j + 1) / laneNum;
+    lane.lvl = cur_level - 1;
+    lane.curr = head;
+    std::fill(lane.finger, lane.finger + max_level, head);
+  }
+
+  size_t active = laneNum;
+  while (active > 0) {
+    for (size_t j = 0; j < laneNum; ++j) {
+      auto &lane = lanes[j];
+      if (lane.pos == lane.end) {
+        continue;
+      }
+      const K &key = keys[order[lane.pos]];
+      auto nxt = lane.curr->next(lane.lvl);
+      if (nxt != nullptr && nxt->key < key) {
+        lane.curr = nxt;
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(nxt->next(lane.lvl));
+#endif
+        continue;
+      }
+      lane.finger[lane.lvl] = lane.curr;
+      if (lane.lvl > 0) {
+        --lane.lvl;
+        auto f = lane.finger[lane.lvl];
+        if (f != head && (lane.curr == head || lane.curr->key < f->key)) {
+          lane.curr = f;
+        }
+#if defined(__GNUC__) || defined(__clang__)
+        __builtin_prefetch(lane.curr->next(lane.lvl));
+#endif
+        continue;
+      }
+      if (nxt != nullptr && !(key < nxt->key)) {
+        result[order[lane.pos]] = nxt;
+      }
+      if (++lane.pos == lane.end) {
+        --active;
+        continue;
+      }
+      lane.lvl = cur_level - 1;
+      lane.curr = lane.finger[lane.lvl];
     }
   }
-  curr = curr->nextNodes[0];
+  return result;
+}
+
+template <typename K, typename V>
+SkipListNode<K, V> *SkipList<K, V>::find(const K &key) const {
+  auto curr = lower_bound_node(key);
   if (curr == nullptr || curr->key != key) {
     return nullptr;
   }
@@ -81,7 +419,7 @@ SkipListNode<K, V> *SkipList<K, V>::find(K key) const {
 }
 
 template <typename K, typename V>
-V &SkipList<K, V>::operator[](K key) {
+V &SkipList<K, V>::operator[](const K &key) {
   auto r = this->find(key);
   if (r == nullptr) {
     throw std::runtime_error("Unexists Key");
@@ -90,67 +428,48 @@ V &SkipList<K, V>::operator[](K key) {
 }
 
 template <typename K, typename V>
-bool SkipList<K, V>::insert(K key, V val) {
-  auto curr = head;
-  std::vector<SkipListNode<K, V> *> update(max_level, nullptr);
-  for (int i = max_level - 1; i >= 0; --i) {
-    while (curr->nextNodes[i] != nullptr && curr->nextNodes[i]->key < key) {
-      curr = curr->nextNodes[i];
-    }
-    update[i] = curr;
-  }
-  curr = curr->nextNodes[0];
+bool SkipList<K, V>::insert(const K &key, const V &val) {
+  Node *update[max_level];
+  auto curr = find_predecessors(key, update)->next(0);
   if (curr != nullptr && curr->key == key) {
     return false;
   }
-  int level = get_random_level();
-  auto newNode = new SkipListNode<K, V>(level, key, val);
-  for (int i = 0; i < level; ++i) {
-    newNode->nextNodes[i] = update[i]->nextNodes[i];
-    update[i]->nextNodes[i] = newNode;
-  }
-  ++node_num;
+  link_after(update, key, val);
   return true;
 }
 
 template <typename K, typename V>
-bool SkipList<K, V>::erase(K key) {
+bool SkipList<K, V>::erase(const K &key) {
   if (node_num <= 0) {
     return false;
   }
-  auto curr = head;
-  std::vector<SkipListNode<K, V> *> update(max_level, nullptr);
-  for (int i = max_level - 1; i >= 0; --i) {
-    while (curr->nextNodes[i] != nullptr && curr->nextNodes[i]->key < key) {
-      curr = curr->nextNodes[i];
-    }
-    update[i] = curr;
-  }
-  curr = curr->nextNodes[0];
+  Node *update[max_level];
+  auto curr = find_predecessors(key, update)->next(0);
   if (curr == nullptr || curr->key != key) {
     return false;
   }
-  int level = curr->level;
-  for (int i = 0; i < level; ++i) {
-    update[i]->nextNodes[i] = curr->nextNodes[i];
-    curr->nextNodes[i] = nullptr;
+  for (int i = 0; i < curr->level; ++i) {
+    update[i]->next(i) = curr->next(i);
+  }
+  destroy_node(curr);
+  while (cur_level > 1 && head->next(cur_level - 1) == nullptr) {
+    --cur_level;
   }
-  delete curr;
   --node_num;
   return true;
 }
 
 template <typename K, typename V>
 void SkipList<K, V>::dump() const {
-  for (int i = 0; i < max_level; ++i) {
-    auto p = head->nextNodes[i];
+  for (int i = 0; i < cur_level; ++i) {
+    auto p = head->next(i);
     if (p == nullptr) {
       continue;
     }
     std::cout << sk::utils::format("[LEVEL-{}]: (HEAD)->", i + 1);
     while (p != nullptr) {
       std::cout << sk::utils::format("({},{},[{}])->", p->key, p->val, p->level);
-      p = p->nextNodes[i];
+      p = p->next(i);
     }
     std::cout << "(NULL)\n\n";
   }
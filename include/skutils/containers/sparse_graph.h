@@ -0,0 +1,565 @@
+#ifndef SK_DATASTRUCTURE_SPARSE_GRAPH_H
+#define SK_DATASTRUCTURE_SPARSE_GRAPH_H
+
+#include <algorithm>
+#include <atomic>
+#include <future>
+#include <numeric>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "skutils/containers/graph.h"
+#include "skutils/containers/graph_generators.h"
+#include "skutils/printer.h"
+#include "skutils/threadpool.h"
+
+namespace sk::utils::dts {
+
+namespace graph_detail {
+
+/// node values when only a node count is given: 0..n-1 for integral types
+template <typename ValueType>
+std::vector<ValueType> defaultNodes(int n) {
+  std::vector<ValueType> nodes(n);
+  if constexpr (std::is_integral_v<ValueType>) {
+    std::iota(nodes.begin(), nodes.end(), ValueType{0});
+  }
+  return nodes;
+}
+
+/// fn(chunk, begin, end) for consecutive chunks of [0, n) of at most `grain` items
+template <typename Fn>
+void parallelChunks(size_t n, size_t grain, ThreadPool *pool, Fn &&fn) {
+  const size_t chunks = (n + grain - 1) / grain;
+  auto run = [&fn, n, grain](size_t c) { fn(c, c * grain, std::min(n, (c + 1) * grain)); };
+  if (pool == nullptr || chunks <= 1) {
+    for (size_t c = 0; c < chunks; ++c) {
+      run(c);
+    }
+    return;
+  }
+  std::vector<std::future<void>> fus;
+  fus.reserve(chunks - 1);
+  for (size_t c = 1; c < chunks; ++c) {
+    fus.emplace_back(pool->submit(run, c));
+  }
+  run(0);
+  for (auto &fu : fus) {
+    fu.get();
+  }
+}
+
+inline size_t chunkCount(size_t n, size_t grain) {
+  return (n + grain - 1) / grain;
+}
+
+}  // namespace graph_detail
+
+template <typename ValueType>
+class AdjListGraph;
+
+/// Compressed sparse row graph: the neighbors of node u are targets[offsets[u] .. offsets[u + 1]), so walking
+/// them reads one contiguous run. Memory is O(V + E). The structure is immutable; build it with a Builder, from
+/// raw arrays, or by converting a Graph / AdjListGraph. Undirected graphs store each edge in both directions.
+/// Unweighted graphs (every weight graphConst::wuxiangtuWeight) keep no weight array.
+template <typename ValueType = int>
+class CsrGraph {
+  public:
+  std::vector<ValueType> nodes;
+  bool isYouXiang{false};
+
+  /// collects an edge list, then lays it out in two counting passes
+  class Builder {
+    public:
+    explicit Builder(int n, bool isYouXiangTu = false)
+      : Builder(graph_detail::defaultNodes<ValueType>(n), isYouXiangTu) {}
+
+    explicit Builder(std::vector<ValueType> v, bool isYouXiangTu = false)
+      : nodes(std::move(v)), isYouXiang(isYouXiangTu) {}
+
+    Builder &reserve(size_t edgeNum) {
+      from.reserve(edgeNum);
+      to.reserve(edgeNum);
+      return *this;
+    }
+
+    Builder &addEdge(int u, int v, int weight = graphConst::wuxiangtuWeight);
+
+    /// sortNeighbors orders every row by target, otherwise rows keep insertion order
+    CsrGraph build(bool sortNeighbors = true) &&;
+
+    private:
+    std::vector<ValueType> nodes;
+    bool isYouXiang;
+    std::vector<int> from;
+    std::vector<int> to;
+    /// filled only once a non-default weight shows up
+    std::vector<int> weight;
+    bool weighted{false};
+  };
+
+  CsrGraph() = default;
+
+  /// takes prepared arrays: offsets has size() + 1 entries, weights is empty or parallel to targets
+  CsrGraph(std::vector<ValueType> v, std::vector<size_t> offs, std::vector<int> tgts, std::vector<int> ws = {},
+           bool isYouXiangTu = false)
+    : nodes(std::move(v)),
+      isYouXiang(isYouXiangTu),
+      offsets(std::move(offs)),
+      targets(std::move(tgts)),
+      weights(std::move(ws)) {
+    if (offsets.size() != nodes.size() + 1 || offsets.back() != targets.size()
+        || (!weights.empty() && weights.size() != targets.size())) {
+      throw std::invalid_argument("CsrGraph arrays mismatch");
+    }
+  }
+
+  explicit CsrGraph(const Graph<ValueType> &g);
+
+  /// lays an edge list out directly, counting and placing edges in parallel on `pool`; rows end up sorted
+  static CsrGraph fromEdges(std::vector<ValueType> v, std::span<const Edge> edges, bool isYouXiangTu = false,
+                            ThreadPool *pool = nullptr);
+
+  static CsrGraph fromEdges(int n, std::span<const Edge> edges, bool isYouXiangTu = false,
+                            ThreadPool *pool = nullptr) {
+    return fromEdges(graph_detail::defaultNodes<ValueType>(n), edges, isYouXiangTu, pool);
+  }
+
+  explicit CsrGraph(const AdjListGraph<ValueType> &g);
+
+  int size() const { return static_cast<int>(nodes.size()); }
+
+  bool empty() const { return nodes.empty(); }
+
+  /// stored entries, so an undirected edge counts twice
+  size_t edgeCount() const { return targets.size(); }
+
+  int degree(int u) const { return static_cast<int>(offsets[u + 1] - offsets[u]); }
+
+  std::span<const int> neighbors(int u) const {
+    return {targets.data() + offsets[u], targets.data() + offsets[u + 1]};
+  }
+
+  /// empty for unweighted graphs
+  std::span<const int> weightsOf(int u) const {
+    if (weights.empty()) {
+      return {};
+    }
+    return {weights.data() + offsets[u], weights.data() + offsets[u + 1]};
+  }
+
+  bool isWeighted() const { return !weights.empty(); }
+
+  /// index of u's first entry; entries of u are [offset(u), offset(u + 1))
+  size_t offset(int u) const { return offsets[u]; }
+
+  int target(size_t e) const { return targets[e]; }
+
+  int edgeWeight(size_t e) const { return weights.empty() ? graphConst::wuxiangtuWeight : weights[e]; }
+
+  /// fn(v, weight) for every entry of u
+  template <typename Fn>
+  void forEachNeighbor(int u, Fn &&fn) const {
+    for (size_t e = offsets[u]; e < offsets[u + 1]; ++e) {
+      fn(targets[e], edgeWeight(e));
+    }
+  }
+
+  /// graph with every edge reversed, for pull-style traversals of directed graphs
+  CsrGraph transpose() const;
+
+  /// dense form; parallel edges collapse to the last one
+  Graph<ValueType> toMatrix() const;
+
+  std::string toString() const;
+
+  private:
+  std::vector<size_t> offsets{0};
+  std::vector<int> targets;
+  std::vector<int> weights;
+};
+
+/// Adjacency-list graph for graphs that still grow: addNode and addEdge are amortized O(1). Convert to CsrGraph
+/// once the graph is complete to get contiguous neighbor runs.
+template <typename ValueType = int>
+class AdjListGraph {
+  public:
+  struct Neighbor {
+    int to;
+    int weight;
+  };
+
+  std::vector<ValueType> nodes;
+  std::vector<std::vector<Neighbor>> adj;
+  bool isYouXiang;
+
+  AdjListGraph(bool isYouXiangTu = false) : isYouXiang(isYouXiangTu) {}
+
+  AdjListGraph(std::vector<ValueType> v, bool isYouXiangTu = false)
+    : nodes(std::move(v)), adj(nodes.size()), isYouXiang(isYouXiangTu) {}
+
+  explicit AdjListGraph(const Graph<ValueType> &g) : AdjListGraph(g.nodes, g.isYouXiang) {
+    for (int i = 0; i < g.size(); i++) {
+      for (int j = 0; j < g.size(); j++) {
+        if (g.edges[i][j] != graphConst::dummyValue) {
+          adj[i].push_back({j, g.edges[i][j]});
+        }
+      }
+    }
+  }
+
+  explicit AdjListGraph(const CsrGraph<ValueType> &g) : AdjListGraph(g.nodes, g.isYouXiang) {
+    for (int u = 0; u < g.size(); u++) {
+      adj[u].reserve(g.degree(u));
+      g.forEachNeighbor(u, [&](int v, int w) { adj[u].push_back({v, w}); });
+    }
+  }
+
+  int size() const { return static_cast<int>(nodes.size()); }
+
+  bool empty() const { return nodes.empty(); }
+
+  size_t edgeCount() const {
+    size_t m = 0;
+    for (const auto &row : adj) {
+      m += row.size();
+    }
+    return m;
+  }
+
+  int degree(int u) const { return static_cast<int>(adj[u].size()); }
+
+  const std::vector<Neighbor> &neighbors(int u) const { return adj[u]; }
+
+  AdjListGraph &addNode(ValueType val) {
+    nodes.emplace_back(std::move(val));
+    adj.emplace_back();
+    return *this;
+  }
+
+  AdjListGraph &addEdge(int from, int to, int value = graphConst::wuxiangtuWeight) {
+    if (from >= size() || to >= size()) {
+      throw std::out_of_range("node unexist");
+    }
+    adj[from].push_back({to, value});
+    if (!isYouXiang && from != to) {
+      adj[to].push_back({from, value});
+    }
+    return *this;
+  }
+
+  template <typename Fn>
+  void forEachNeighbor(int u, Fn &&fn) const {
+    for (const auto &nb : adj[u]) {
+      fn(nb.to, nb.weight);
+    }
+  }
+
+  Graph<ValueType> toMatrix() const {
+    Graph<ValueType> g(nodes, isYouXiang);
+    for (int u = 0; u < size(); u++) {
+      for (const auto &nb : adj[u]) {
+        g.edges[u][nb.to] = nb.weight;
+      }
+    }
+    return g;
+  }
+
+  std::string toString() const {
+    std::stringstream ss;
+    ss << "[nodes]:\n\t" << sk::utils::toString(nodes) << "\n";
+    ss << "[edges]:\n";
+    for (int u = 0; u < size(); u++) {
+      ss << "\t" << u << ":";
+      for (const auto &nb : adj[u]) {
+        ss << " " << nb.to << "(" << nb.weight << ")";
+      }
+      ss << "\n";
+    }
+    return ss.str();
+  }
+};
+
+template <typename ValueType>
+typename CsrGraph<ValueType>::Builder &CsrGraph<ValueType>::Builder::addEdge(int u, int v, int w) {
+  if (u < 0 || v < 0 || u >= static_cast<int>(nodes.size()) || v >= static_cast<int>(nodes.size())) {
+    throw std::out_of_range("node unexist");
+  }
+  if (w != graphConst::wuxiangtuWeight && !weighted) {
+    weighted = true;
+    weight.assign(from.size(), graphConst::wuxiangtuWeight);
+  }
+  from.push_back(u);
+  to.push_back(v);
+  if (weighted) {
+    weight.push_back(w);
+  }
+  return *this;
+}
+
+template <typename ValueType>
+CsrGraph<ValueType> CsrGraph<ValueType>::Builder::build(bool sortNeighbors) && {
+  const size_t n = nodes.size();
+  std::vector<size_t> offs(n + 1, 0);
+  for (size_t i = 0; i < from.size(); ++i) {
+    ++offs[from[i] + 1];
+    if (!isYouXiang && from[i] != to[i]) {
+      ++offs[to[i] + 1];
+    }
+  }
+  std::partial_sum(offs.begin(), offs.end(), offs.begin());
+
+  std::vector<int> tgts(offs.back());
+  std::vector<int> ws(weighted ? offs.back() : 0);
+  std::vector<size_t> cursor(offs.begin(), offs.end() - 1);
+  auto place = [&](int u, int v, size_t i) {
+    auto e = cursor[u]++;
+    tgts[e] = v;
+    if (weighted) {
+      ws[e] = weight[i];
+    }
+  };
+  for (size_t i = 0; i < from.size(); ++i) {
+    place(from[i], to[i], i);
+    if (!isYouXiang && from[i] != to[i]) {
+      place(to[i], from[i], i);
+    }
+  }
+  std::vector<int>().swap(from);
+  std::vector<int>().swap(to);
+  std::vector<int>().swap(weight);
+
+  if (sortNeighbors) {
+    std::vector<std::pair<int, int>> row;
+    for (size_t u = 0; u < n; ++u) {
+      auto b = offs[u];
+      auto e = offs[u + 1];
+      if (!weighted) {
+        std::sort(tgts.begin() + b, tgts.begin() + e);
+        continue;
+      }
+      row.clear();
+      for (auto i = b; i < e; ++i) {
+        row.emplace_back(tgts[i], ws[i]);
+      }
+      std::sort(row.begin(), row.end());
+      for (auto i = b; i < e; ++i) {
+        tgts[i] = row[i - b].first;
+        ws[i] = row[i - b].second;
+      }
+    }
+  }
+  return CsrGraph(std::move(nodes), std::move(offs), std::move(tgts), std::move(ws), isYouXiang);
+}
+
+template <typename ValueType>
+CsrGraph<ValueType> CsrGraph<ValueType>::fromEdges(std::vector<ValueType> v, std::span<const Edge> edges,
+                                                   bool isYouXiangTu, ThreadPool *pool) {
+  using graph_detail::parallelChunks;
+  constexpr size_t EDGE_GRAIN = 1 << 16;
+  constexpr size_t ROW_GRAIN = 1 << 12;
+  const size_t n = v.size();
+  const bool both = !isYouXiangTu;
+  const bool weighted = std::any_of(edges.begin(), edges.end(),
+                                    [](const Edge &e) { return e.weight != graphConst::wuxiangtuWeight; });
+  for (const auto &e : edges) {
+    if (e.from < 0 || e.to < 0 || static_cast<size_t>(e.from) >= n || static_cast<size_t>(e.to) >= n) {
+      throw std::out_of_range("node unexist");
+    }
+  }
+
+  // lock-prefixed RMWs also stop the cache misses from overlapping, so a serial build sticks to plain increments
+  const bool shared = pool != nullptr && edges.size() > EDGE_GRAIN;
+  auto bump = [shared](size_t &slot) {
+    return shared ? std::atomic_ref<size_t>(slot).fetch_add(1, std::memory_order_relaxed) : slot++;
+  };
+  std::vector<size_t> offs(n + 1, 0);
+  parallelChunks(edges.size(), EDGE_GRAIN, pool, [&](size_t, size_t b, size_t e) {
+    for (auto i = b; i < e; ++i) {
+      bump(offs[edges[i].from + 1]);
+      if (both && edges[i].from != edges[i].to) {
+        bump(offs[edges[i].to + 1]);
+      }
+    }
+  });
+  std::partial_sum(offs.begin(), offs.end(), offs.begin());
+
+  std::vector<int> tgts(offs.back());
+  std::vector<int> ws(weighted ? offs.back() : 0);
+  std::vector<size_t> cursor(offs.begin(), offs.end() - 1);
+  parallelChunks(edges.size(), EDGE_GRAIN, pool, [&](size_t, size_t b, size_t e) {
+    auto place = [&](int from, int to, int w) {
+      auto pos = bump(cursor[from]);
+      tgts[pos] = to;
+      if (weighted) {
+        ws[pos] = w;
+      }
+    };
+    for (auto i = b; i < e; ++i) {
+      place(edges[i].from, edges[i].to, edges[i].weight);
+      if (both && edges[i].from != edges[i].to) {
+        place(edges[i].to, edges[i].from, edges[i].weight);
+      }
+    }
+  });
+
+  // placement order depends on scheduling, sorting the rows makes the result deterministic
+  parallelChunks(n, ROW_GRAIN, pool, [&](size_t, size_t b, size_t e) {
+    std::vector<std::pair<int, int>> row;
+    for (auto u = b; u < e; ++u) {
+      if (!weighted) {
+        std::sort(tgts.begin() + offs[u], tgts.begin() + offs[u + 1]);
+        continue;
+      }
+      row.clear();
+      for (auto i = offs[u]; i < offs[u + 1]; ++i) {
+        row.emplace_back(tgts[i], ws[i]);
+      }
+      std::sort(row.begin(), row.end());
+      for (auto i = offs[u]; i < offs[u + 1]; ++i) {
+        tgts[i] = row[i - offs[u]].first;
+        ws[i] = row[i - offs[u]].second;
+      }
+    }
+  });
+  return CsrGraph(std::move(v), std::move(offs), std::move(tgts), std::move(ws), isYouXiangTu);
+}
+
+template <typename ValueType>
+CsrGraph<ValueType>::CsrGraph(const Graph<ValueType> &g) : nodes(g.nodes), isYouXiang(g.isYouXiang) {
+  const int n = g.size();
+  bool weighted = false;
+  offsets.assign(n + 1, 0);
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      if (g.edges[i][j] != graphConst::dummyValue) {
+        ++offsets[i + 1];
+        weighted |= g.edges[i][j] != graphConst::wuxiangtuWeight;
+      }
+    }
+  }
+  std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+  targets.reserve(offsets.back());
+  if (weighted) {
+    weights.reserve(offsets.back());
+  }
+  for (int i = 0; i < n; i++) {
+    for (int j = 0; j < n; j++) {
+      if (g.edges[i][j] != graphConst::dummyValue) {
+        targets.push_back(j);
+        if (weighted) {
+          weights.push_back(g.edges[i][j]);
+        }
+      }
+    }
+  }
+}
+
+template <typename ValueType>
+CsrGraph<ValueType>::CsrGraph(const AdjListGraph<ValueType> &g) : nodes(g.nodes), isYouXiang(g.isYouXiang) {
+  const int n = g.size();
+  bool weighted = false;
+  offsets.assign(n + 1, 0);
+  for (int u = 0; u < n; u++) {
+    offsets[u + 1] = offsets[u] + g.adj[u].size();
+    for (const auto &nb : g.adj[u]) {
+      weighted |= nb.weight != graphConst::wuxiangtuWeight;
+    }
+  }
+  targets.reserve(offsets.back());
+  if (weighted) {
+    weights.reserve(offsets.back());
+  }
+  for (int u = 0; u < n; u++) {
+    for (const auto &nb : g.adj[u]) {
+      targets.push_back(nb.to);
+      if (weighted) {
+        weights.push_back(nb.weight);
+      }
+    }
+  }
+}
+
+template <typename ValueType>
+CsrGraph<ValueType> CsrGraph<ValueType>::transpose() const {
+  if (!isYouXiang) {
+    return *this;
+  }
+  const size_t n = nodes.size();
+  std::vector<size_t> offs(n + 1, 0);
+  for (auto v : targets) {
+    ++offs[v + 1];
+  }
+  std::partial_sum(offs.begin(), offs.end(), offs.begin());
+  std::vector<int> tgts(targets.size());
+  std::vector<int> ws(weights.size());
+  std::vector<size_t> cursor(offs.begin(), offs.end() - 1);
+  // rows are scanned in order, so every reversed row comes out sorted by source
+  for (size_t u = 0; u < n; ++u) {
+    for (auto e = offsets[u]; e < offsets[u + 1]; ++e) {
+      auto pos = cursor[targets[e]]++;
+      tgts[pos] = static_cast<int>(u);
+      if (!weights.empty()) {
+        ws[pos] = weights[e];
+      }
+    }
+  }
+  return CsrGraph(nodes, std::move(offs), std::move(tgts), std::move(ws), true);
+}
+
+template <typename ValueType>
+Graph<ValueType> CsrGraph<ValueType>::toMatrix() const {
+  Graph<ValueType> g(nodes, isYouXiang);
+  for (int u = 0; u < size(); u++) {
+    forEachNeighbor(u, [&](int v, int w) { g.edges[u][v] = w; });
+  }
+  return g;
+}
+
+template <typename ValueType>
+std::string CsrGraph<ValueType>::toString() const {
+  std::stringstream ss;
+  ss << "[nodes]:\n\t" << sk::utils::toString(nodes) << "\n";
+  ss << "[edges]:\n";
+  for (int u = 0; u < size(); u++) {
+    ss << "\t" << u << ":";
+    forEachNeighbor(u, [&](int v, int w) { ss << " " << v << "(" << w << ")"; });
+    ss << "\n";
+  }
+  return ss.str();
+}
+
+/// buildRandomGraph for any representation, e.g. buildRandomGraph<CsrGraph<int>>(1'000'000): n * 3 G(n, m)
+/// edges, and the sparse forms never allocate an n x n matrix
+template <typename GraphType>
+GraphType buildRandomGraph(int n = 10, bool isYouXiang = false, bool useDefaultWeight = true, int start = 1,
+                           int end = 100) {
+  if constexpr (std::is_same_v<GraphType, Graph<int>>) {
+    return buildRandomGraph(n, isYouXiang, useDefaultWeight, start, end);
+  } else {
+    std::vector<int> vertex = RANDTOOL.getRandomIntVector(n, start, end);
+    auto edges = erdosRenyiEdges(n, static_cast<size_t>(n) * 3, RANDTOOL.engine()(), nullptr, true);
+    if (!useDefaultWeight) {
+      randomizeWeights(edges, start, end, RANDTOOL.engine()());
+    }
+    if constexpr (std::is_same_v<GraphType, CsrGraph<int>>) {
+      return CsrGraph<int>::fromEdges(std::move(vertex), edges, isYouXiang);
+    } else {
+      static_assert(std::is_same_v<GraphType, AdjListGraph<int>>, "unsupported graph type");
+      AdjListGraph<int> g(std::move(vertex), isYouXiang);
+      for (const auto &e : edges) {
+        g.addEdge(e.from, e.to, e.weight);
+      }
+      return g;
+    }
+  }
+}
+
+}  // namespace sk::utils::dts
+
+#endif  // SK_DATASTRUCTURE_SPARSE_GRAPH_H
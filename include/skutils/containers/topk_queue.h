@@ -2,16 +2,31 @@
 #define SK_DATASTRUCTURE_TOP_K_QUEUE
 
 #include <algorithm>
+#include <atomic>
+#include <functional>
+#include <iterator>
+#include <memory>
 #include <mutex>
 #include <queue>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
+#include "skutils/containers/shard_detail.h"
 #include "skutils/printer.h"
 #include "skutils/random.h"
 #include "skutils/spinlock.h"
 
 namespace sk::utils::dts {
 
+/// whether T can be kept in a lock-free std::atomic (std::atomic<T> itself is ill-formed otherwise)
+template <typename T, typename = void>
+struct is_lock_free_atomic : std::false_type {};
+
+template <typename T>
+struct is_lock_free_atomic<T, std::enable_if_t<std::is_trivially_copyable_v<T>>>
+  : std::bool_constant<std::atomic<T>::is_always_lock_free> {};
+
 template <typename T, typename Comp>
 struct reverse_comp {
   struct reversed_type {
@@ -22,73 +37,268 @@ struct reverse_comp {
   };
 };
 
-template <typename T, typename Comp = std::less<T>>
+/// Keeps the k elements with the largest keys (by Comp) pushed from any number of threads.
+///
+/// Key is a projection applied once per pushed element; the key is stored next to the element, so the heap only
+/// ever compares cached keys. Use it when the order depends on something expensive to compute (a file size, a
+/// parsed field). With the default std::identity the elements are compared directly and stored once.
+///
+/// Pushes go to one of several shards picked by the calling thread, each holding its own top-k in a small
+/// heap behind a SpinLock, so workers rarely touch the same lock; pop() merges the shards. Once a shard is
+/// full, its smallest key is a lower bound for the global top-k: the largest such bound is published in an
+/// atomic threshold and elements not above it are dropped without locking. The threshold needs a lock-free
+/// std::atomic of the key type; for other keys every push takes its shard lock.
+template <typename T, typename Key = std::identity, typename Comp = std::less<>>
 class topk_queue {
+  public:
+  using key_type = std::decay_t<std::invoke_result_t<Key&, const T&>>;
+
   private:
+  static constexpr bool IDENTITY = std::is_same_v<Key, std::identity>;
+  static constexpr bool FAST_REJECT = is_lock_free_atomic<key_type>::value;
+
+  /// what the heaps hold: the element itself, or its cached key and the element
+  using Slot = std::conditional_t<IDENTITY, T, std::pair<key_type, T>>;
+
+  static const key_type& keyOf(const Slot& s) {
+    if constexpr (IDENTITY) {
+      return s;
+    } else {
+      return s.first;
+    }
+  }
+
+  static T&& valueOf(Slot& s) {
+    if constexpr (IDENTITY) {
+      return std::move(s);
+    } else {
+      return std::move(s.second);
+    }
+  }
+
+  using ReversedComp = typename reverse_comp<key_type, Comp>::reversed_type;
+
+  struct SlotComp {
+    bool operator()(const Slot& a, const Slot& b) const { return ReversedComp()(keyOf(a), keyOf(b)); }
+  };
+
+  struct alignas(64) Shard {
+    sk::utils::SpinLock spinlock;
+    /// heap with the smallest kept key on top
+    std::vector<Slot> heap;
+  };
+
+  struct Threshold {
+    std::atomic<bool> valid{false};
+    /// set by the one shard allowed to store the first value, which has no old value to compare against
+    std::atomic<bool> seeded{false};
+    std::atomic<key_type> value{};
+  };
+
+  struct NoThreshold {};
+
   size_t cap{};
+  size_t shardMask{};
+  std::unique_ptr<Shard[]> shards;
+  std::conditional_t<FAST_REJECT, Threshold, NoThreshold> threshold;
+  [[no_unique_address]] Key key;
 
-  using ReversedComp = typename reverse_comp<T, Comp>::reversed_type;
-  std::priority_queue<T, std::vector<T>, ReversedComp> pq;
+  /// each thread keeps writing to the same shard
+  Shard& localShard() { return shards[shard_detail::localShardIndex(shardMask)]; }
 
-  sk::utils::SpinLock spinlock;
+  /// raises the threshold to `bound` unless it is already higher; it never moves backwards
+  void publish(const key_type& bound) {
+    if constexpr (FAST_REJECT) {
+      if (!threshold.valid.load(std::memory_order_acquire)) {
+        if (threshold.seeded.exchange(true, std::memory_order_acq_rel)) {
+          return;  // another shard is seeding, this shard publishes again on its next replacement
+        }
+        threshold.value.store(bound, std::memory_order_relaxed);
+        threshold.valid.store(true, std::memory_order_release);
+        return;
+      }
+      auto cur = threshold.value.load(std::memory_order_relaxed);
+      while (Comp()(cur, bound)
+             && !threshold.value.compare_exchange_weak(cur, bound, std::memory_order_relaxed)) {}
+    }
+  }
+
+  /// copies the heaps and the threshold; cap and shardMask must already match o's
+  void copyShards(const topk_queue& o) {
+    for (size_t i = 0; i <= shardMask; ++i) {
+      sk::utils::SpinLockGuard guard{o.shards[i].spinlock};
+      shards[i].heap = o.shards[i].heap;
+    }
+    if constexpr (FAST_REJECT) {
+      threshold.value.store(o.threshold.value.load());
+      threshold.seeded.store(o.threshold.seeded.load());
+      threshold.valid.store(o.threshold.valid.load());
+    }
+  }
+
+  void pushSlot(Slot&& slot) {
+    auto& shard = localShard();
+    sk::utils::SpinLockGuard guard{shard.spinlock};
+    auto& heap = shard.heap;
+    if (heap.size() < cap) {
+      heap.push_back(std::move(slot));
+      std::push_heap(heap.begin(), heap.end(), SlotComp());
+      if (heap.size() == cap) {
+        publish(keyOf(heap.front()));
+      }
+    } else if (SlotComp()(slot, heap.front())) {
+      std::pop_heap(heap.begin(), heap.end(), SlotComp());
+      heap.back() = std::move(slot);
+      std::push_heap(heap.begin(), heap.end(), SlotComp());
+      publish(keyOf(heap.front()));
+    } else {
+      // do nothing
+    }
+  }
 
   public:
-  explicit topk_queue(size_t capacity) : cap(capacity) {}
+  /// shards = 0 picks one per hardware thread
+  explicit topk_queue(size_t capacity, size_t shardNum = 0) : topk_queue(capacity, Key(), shardNum) {}
+
+  topk_queue(size_t capacity, Key projection, size_t shardNum = 0)
+    : cap(capacity),
+      shardMask(shard_detail::shardMaskFor(shardNum)),
+      shards(std::make_unique<Shard[]>(shardMask + 1)),
+      key(std::move(projection)) {}
 
-  topk_queue(const topk_queue& q) : cap(q.cap), pq(q.pq) {}
+  topk_queue(const topk_queue& o)
+    : cap(o.cap), shardMask(o.shardMask), shards(std::make_unique<Shard[]>(shardMask + 1)), key(o.key) {
+    copyShards(o);
+  }
 
-  topk_queue(topk_queue&& o) noexcept : cap(o.cap), pq(std::move(o.pq)) {}
+  topk_queue(topk_queue&& o) noexcept
+    : cap(o.cap),
+      shardMask(o.shardMask),
+      shards(std::exchange(o.shards, std::make_unique<Shard[]>(o.shardMask + 1))),
+      key(std::move(o.key)) {
+    if constexpr (FAST_REJECT) {
+      threshold.value.store(o.threshold.value.load());
+      threshold.seeded.store(o.threshold.seeded.exchange(false));
+      threshold.valid.store(o.threshold.valid.exchange(false));
+    }
+  }
 
   topk_queue& operator=(const topk_queue& o) {
     if (&o != this) {
-      this->cap = pq.cap;
-      this->pq = o.pq;
+      cap = o.cap;
+      shardMask = o.shardMask;
+      key = o.key;
+      shards = std::make_unique<Shard[]>(shardMask + 1);
+      copyShards(o);
     }
     return *this;
   }
 
+  /// the moved-from queue is left empty with the same capacity and shard count, still usable
   topk_queue& operator=(topk_queue&& o) noexcept {
-    this->cap = o.cap;
-    this->pq = o.pq;
+    if (&o != this) {
+      cap = o.cap;
+      shardMask = o.shardMask;
+      shards = std::exchange(o.shards, std::make_unique<Shard[]>(o.shardMask + 1));
+      key = std::move(o.key);
+      if constexpr (FAST_REJECT) {
+        threshold.value.store(o.threshold.value.load());
+        threshold.seeded.store(o.threshold.seeded.exchange(false));
+        threshold.valid.store(o.threshold.valid.exchange(false));
+      }
+    }
     return *this;
   }
 
   ~topk_queue() = default;
 
   void push(const T& val) {
-    sk::utils::SpinLockGuard guard{spinlock};
-    if (pq.size() < cap) {
-      pq.push(val);
-    } else if (ReversedComp()(val, pq.top())) {
-      pq.push(val);
-      pq.pop();
+    if (cap == 0) {
+      return;
+    }
+    if constexpr (IDENTITY) {
+      if constexpr (FAST_REJECT) {
+        if (threshold.valid.load(std::memory_order_acquire)
+            && !Comp()(threshold.value.load(std::memory_order_relaxed), val)) {
+          return;
+        }
+      }
+      pushSlot(Slot(val));
     } else {
-      // do nothing
+      push_with_key(std::invoke(key, val), val);
+    }
+  }
+
+  /// pushes with a key computed elsewhere, which must equal what the projection would give
+  void push_with_key(key_type k, const T& val) requires(!IDENTITY) {
+    if (cap == 0) {
+      return;
+    }
+    if constexpr (FAST_REJECT) {
+      if (threshold.valid.load(std::memory_order_acquire)
+          && !Comp()(threshold.value.load(std::memory_order_relaxed), k)) {
+        return;
+      }
     }
+    pushSlot(Slot(std::move(k), val));
   }
 
+  const Key& projection() const { return key; }
+
+  /// the kept elements, largest key first; the queue is left empty
   std::vector<T> pop() {
     std::vector<T> ret;
-    {
-      sk::utils::SpinLockGuard guard{spinlock};
-      while (!pq.empty()) {
-        ret.emplace_back(pq.top());
-        pq.pop();
-      }
+    auto slots = popSlots();
+    ret.reserve(slots.size());
+    for (auto& s : slots) {
+      ret.push_back(valueOf(s));
+    }
+    return ret;
+  }
+
+  /// like pop(), with each element's cached key
+  std::vector<std::pair<key_type, T>> pop_with_keys() {
+    std::vector<std::pair<key_type, T>> ret;
+    auto slots = popSlots();
+    ret.reserve(slots.size());
+    for (auto& s : slots) {
+      key_type k = keyOf(s);
+      ret.emplace_back(std::move(k), valueOf(s));
+    }
+    return ret;
+  }
+
+  private:
+  std::vector<Slot> popSlots() {
+    std::vector<Slot> ret;
+    for (size_t i = 0; i <= shardMask; ++i) {
+      sk::utils::SpinLockGuard guard{shards[i].spinlock};
+      auto& heap = shards[i].heap;
+      ret.insert(ret.end(), std::make_move_iterator(heap.begin()), std::make_move_iterator(heap.end()));
+      heap.clear();
     }
-    std::reverse(ret.begin(), ret.end());
+    if constexpr (FAST_REJECT) {
+      threshold.valid.store(false, std::memory_order_release);
+      threshold.seeded.store(false, std::memory_order_release);
+    }
+    auto keep = std::min(cap, ret.size());
+    std::partial_sort(ret.begin(), ret.begin() + keep, ret.end(), SlotComp());
+    ret.resize(keep);
     return ret;
   }
 };
 
-template <typename T, typename Comp = std::less<>>
+template <typename T, typename Key = std::identity, typename Comp = std::less<>>
 class topbottomk_queue {
   private:
-  topk_queue<T, Comp> max_queue;
-  topk_queue<T, typename reverse_comp<T, Comp>::reversed_type> min_queue;
+  using key_type = typename topk_queue<T, Key, Comp>::key_type;
+
+  topk_queue<T, Key, Comp> max_queue;
+  topk_queue<T, Key, typename reverse_comp<key_type, Comp>::reversed_type> min_queue;
 
   public:
-  explicit topbottomk_queue(size_t capacity) : max_queue(capacity), min_queue(capacity) {}
+  explicit topbottomk_queue(size_t capacity, Key projection = Key())
+    : max_queue(capacity, projection), min_queue(capacity, projection) {}
 
   topbottomk_queue(const topbottomk_queue& o) : max_queue(o.max_queue), min_queue(o.min_queue) {}
 
@@ -111,16 +321,27 @@ class topbottomk_queue {
 
   ~topbottomk_queue() = default;
 
+  /// the key is computed once and shared by both queues
   void push(const T& val) {
-    max_queue.push(val);
-    min_queue.push(val);
+    if constexpr (std::is_same_v<Key, std::identity>) {
+      max_queue.push(val);
+      min_queue.push(val);
+    } else {
+      key_type k = std::invoke(max_queue.projection(), val);
+      max_queue.push_with_key(k, val);
+      min_queue.push_with_key(std::move(k), val);
+    }
   }
 
   std::vector<T> pop_top() { return max_queue.pop(); }
 
   std::vector<T> pop_bottom() { return min_queue.pop(); }
+
+  std::vector<std::pair<key_type, T>> pop_top_with_keys() { return max_queue.pop_with_keys(); }
+
+  std::vector<std::pair<key_type, T>> pop_bottom_with_keys() { return min_queue.pop_with_keys(); }
 };
 
 }  // namespace sk::utils::dts
 
-#endif
\ No newline at end of file
+#endif
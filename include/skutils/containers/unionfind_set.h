@@ -1,141 +1,147 @@
 #ifndef SHUAIKAI_DATASTRUCTURE_UNION_FIND_SET_H
 #define SHUAIKAI_DATASTRUCTURE_UNION_FIND_SET_H
 
-#include <map>
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <numeric>
+#include <span>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <unordered_map>
+#include <vector>
 
 #include "graph.h"
+#include "sparse_graph.h"
+#include "skutils/threadpool.h"
 
 namespace sk::utils::dts {
 
-template <typename T, typename Less = std::less<T>>
-class UnionFindSet {
-  private:
-  int cnt;
-  std::map<T, T, Less> parent;
-  Less lesser;
-
-  bool equal(const T &a, const T &b) const { return !lesser(a, b) && !lesser(b, a); }
+namespace unionfind_detail {
 
-  public:
-  UnionFindSet() : cnt(0), lesser(Less()) {}
+constexpr size_t BATCH_GRAIN = 1 << 16;
 
-  explicit UnionFindSet(Graph<T> g) : cnt(g.size()) {
-    for (auto val : g.nodes) {
-      parent.emplace(val, val);
+/// root of x, halving the path with CAS; safe while other threads find or link on the same array
+inline int casFind(int *parent, int x) {
+  while (true) {
+    int p = std::atomic_ref<int>(parent[x]).load(std::memory_order_relaxed);
+    if (p == x) {
+      return x;
     }
-    for (int i = 0; i < g.size(); i++) {
-      if (g.isYouXiang) {
-        for (int j = 0; j < g.size(); j++) {
-          if (g.edges[i][j] != graphConst::dummyValue) {
-            connect(g.nodes[i], g.nodes[j]);
-          }
-        }
-      } else {
-        for (int j = 0; j < i; j++) {
-          if (g.edges[i][j] != graphConst::dummyValue) {
-            connect(g.nodes[i], g.nodes[j]);
-          }
-        }
-      }
+    int gp = std::atomic_ref<int>(parent[p]).load(std::memory_order_relaxed);
+    if (gp != p) {
+      std::atomic_ref<int>(parent[x]).compare_exchange_weak(p, gp, std::memory_order_relaxed);
     }
+    x = gp;
   }
+}
 
-  int count() const { return cnt; }
-
-  void add(T val) {
-    auto [it, yes] = parent.emplace(val, val);
-    if (yes) {
-      ++cnt;
+/// links the larger root under the smaller one with a single CAS, true if this call merged two sets
+inline bool casLink(int *parent, int a, int b) {
+  while (true) {
+    a = casFind(parent, a);
+    b = casFind(parent, b);
+    if (a == b) {
+      return false;
     }
-  }
-
-  void add(T key, T val) {
-    auto [it1, yes1] = parent.emplace(key, key);
-    if (yes1) {
-      ++cnt;
+    if (a < b) {
+      std::swap(a, b);
     }
-    auto [it2, yes2] = parent.emplace(val, val);
-    if (yes2) {
-      ++cnt;
+    int expected = a;
+    if (std::atomic_ref<int>(parent[a]).compare_exchange_strong(expected, b, std::memory_order_relaxed)) {
+      return true;
     }
-    connect(key, val);
   }
+}
 
-  T find(T key) {
-    if (parent.find(key) == parent.end()) {
-      throw std::out_of_range(formatStr("key {} Unexist.", key));
+inline bool casSameSet(int *parent, int a, int b) {
+  while (true) {
+    a = casFind(parent, a);
+    b = casFind(parent, b);
+    if (a == b) {
+      return true;
     }
-    T p = parent[key];
-    if (equal(p, key)) {  // equal要求const参数，传递parent[key]会导致map类型变为const map，进而无法引用
-      return key;
+    // a still being a root means the two were apart at some point during the call
+    if (std::atomic_ref<int>(parent[a]).load(std::memory_order_relaxed) == a) {
+      return false;
     }
-    return find(p);
   }
+}
 
-  void connect(T key1, T key2) {
-    T r1 = find(key1);
-    T r2 = find(key2);
-    if (!equal(r1, r2)) {
-      parent[r1] = r2;
-      --cnt;
+/// every tree as root-(child-(...),child), one line per root, children in index order; O(n) and iterative
+template <typename Name>
+std::string describe(const std::vector<int> &parent, Name &&name) {
+  const int n = static_cast<int>(parent.size());
+  std::vector<int> offs(n + 1, 0);
+  for (int i = 0; i < n; i++) {
+    offs[parent[i] + 1] += parent[i] != i;
+  }
+  std::partial_sum(offs.begin(), offs.end(), offs.begin());
+  std::vector<int> kids(offs.back());
+  std::vector<int> cursor(offs.begin(), offs.end() - 1);
+  for (int i = 0; i < n; i++) {
+    if (parent[i] != i) {
+      kids[cursor[parent[i]]++] = i;
     }
   }
-
-  std::string toString() const {
-    if (cnt == 0) {
-      return std::string{"[]"};
+  std::stringstream ss;
+  std::vector<std::pair<int, int>> stack;  // node, next child
+  for (int r = 0; r < n; r++) {
+    if (parent[r] != r) {
+      continue;
     }
-    std::vector<T> top;
-    for (auto [k, v] : parent) {
-      if (equal(k, v)) {
-        top.emplace_back(k);
+    ss << name(r);
+    stack.emplace_back(r, offs[r]);
+    while (!stack.empty()) {
+      auto [u, next] = stack.back();
+      if (next == offs[u + 1]) {
+        ss << (offs[u] == offs[u + 1] ? "" : ")");
+        stack.pop_back();
+        continue;
       }
+      ss << (next == offs[u] ? "-(" : ",") << name(kids[next]);
+      ++stack.back().second;
+      stack.emplace_back(kids[next], offs[kids[next]]);
     }
-    std::stringstream ss;
-    for (auto n : top) {
-      ss << toStringHelper(n) << "\n";
-    }
-    std::string ret = ss.str();
-    return ret;
+    ss << "\n";
   }
+  return ss.str();
+}
 
-  std::string toStringHelper(T a) const {
-    std::stringstream ss;
-    ss << formatStr("{}", a) << "-(";
-    for (auto [k, v] : parent) {
-      if (equal(v, a) && !equal(k, a)) {
-        ss << toStringHelper(k) << ",";
-      }
-    }
-    std::string ret = ss.str();
-    if (ret.back() == ',') {
-      ret.pop_back();
-      ret += ")";
-    } else {
-      ret.pop_back();
-      ret.pop_back();
-    }
-    return ret;
-  }
-};
+}  // namespace unionfind_detail
+
+template <typename T, typename Hash = std::hash<T>, typename Eq = std::equal_to<T>>
+class UnionFindSet;
 
+/// Union-find over the nodes 0..size()-1: find halves the path it walks and connect links by rank, so any
+/// sequence of m operations costs O(m α(n)). Both are iterative, long chains cannot overflow the stack.
 template <>
 class UnionFindSet<int> {
   private:
+  template <typename, typename, typename>
+  friend class UnionFindSet;
+
   int cnt;
   std::vector<int> parent;
+  /// upper bound of the tree height, at most log2(n)
+  std::vector<std::uint8_t> rank;
 
-  public:
-  explicit UnionFindSet(int n) : cnt(n), parent(n) {
-    for (int i = 0; i < n; i++) {
-      parent[i] = i;
+  template <typename G>
+  void connectEdges(const G &g) {
+    for (int u = 0; u < g.size(); u++) {
+      g.forEachNeighbor(u, [&](int v, int) {
+        if (g.isYouXiang || v < u) {
+          connect(u, v);
+        }
+      });
     }
   }
 
-  explicit UnionFindSet(Graph<int> g) : cnt(g.size()), parent(cnt) {
-    for (int i = 0; i < cnt; i++) {
-      parent[i] = i;
-    }
+  public:
+  explicit UnionFindSet(int n = 0) : cnt(n), parent(n), rank(n, 0) { std::iota(parent.begin(), parent.end(), 0); }
+
+  explicit UnionFindSet(Graph<int> g) : UnionFindSet(g.size()) {
     int len = g.size();
     for (int i = 0; i < len; i++) {
       if (g.isYouXiang) {
@@ -155,69 +161,286 @@ class UnionFindSet<int> {
     }
   }
 
+  /// nodes are the indices 0..size()-1, whatever their values
+  explicit UnionFindSet(const CsrGraph<int> &g) : UnionFindSet(g.size()) { connectEdges(g); }
+
+  explicit UnionFindSet(const AdjListGraph<int> &g) : UnionFindSet(g.size()) { connectEdges(g); }
+
   int count() const { return cnt; }
 
+  int size() const { return static_cast<int>(parent.size()); }
+
+  /// appends a singleton set, returns its node
+  int add() {
+    parent.push_back(size());
+    rank.push_back(0);
+    ++cnt;
+    return parent.back();
+  }
+
   int find(int a) {
-    // 标准的采用路径压缩算法，以尽量减少树的高度
-    if (parent[a] != a) {
-      parent[a] = find(parent[a]);
+    // 路径减半: 沿途每个点指向祖父, 与完全压缩同阶, 但只需一趟且不用递归
+    while (parent[a] != a) {
+      parent[a] = parent[parent[a]];
+      a = parent[a];
     }
-    return parent[a];
+    return a;
   }
 
   UnionFindSet &connect(int a, int b) {
     int ra = find(a);
     int rb = find(b);
     if (ra != rb) {
+      if (rank[ra] < rank[rb]) {
+        std::swap(ra, rb);
+      }
       parent[rb] = ra;
+      rank[ra] += rank[ra] == rank[rb];
       cnt--;
     }
     return *this;
   }
 
   void normalize() {
-    for (int i = 0; i < parent.size(); i++) {
-      if (parent[i] != i) {
-        parent[i] = find(parent[i]);
-      }
+    for (int i = 0; i < size(); i++) {
+      parent[i] = find(i);
     }
   }
 
   bool isConnected(int a, int b) { return find(a) == find(b); }
 
-  std::string toString() const {
-    std::vector<int> top;
-    for (int i = 0; i < parent.size(); i++) {
-      if (parent[i] == i) {
-        top.push_back(i);
+  /// connects every pair. With a pool the pairs are linked in parallel chunks by CAS, larger root under smaller
+  /// as in ConcurrentUnionFindSet, which ignores ranks; every tree is then flattened under its root in O(n) and
+  /// the ranks rebuilt (1 for a root with children, 0 otherwise), so later connect() calls keep the rank bound.
+  UnionFindSet &connectBatch(std::span<const std::pair<int, int>> pairs, ThreadPool *pool = nullptr) {
+    using namespace unionfind_detail;
+    if (pool == nullptr || pairs.size() <= BATCH_GRAIN) {
+      // the first two hops of the pairs ahead are prefetched in stages, so their cache misses overlap
+      constexpr size_t AHEAD = 16;
+      for (size_t i = 0; i < pairs.size(); ++i) {
+#if defined(__GNUC__) || defined(__clang__)
+        if (i + AHEAD < pairs.size()) {
+          __builtin_prefetch(&parent[pairs[i + AHEAD].first]);
+          __builtin_prefetch(&parent[pairs[i + AHEAD].second]);
+        }
+        if (i + AHEAD / 2 < pairs.size()) {
+          __builtin_prefetch(&parent[parent[pairs[i + AHEAD / 2].first]]);
+          __builtin_prefetch(&parent[parent[pairs[i + AHEAD / 2].second]]);
+        }
+#endif
+        connect(pairs[i].first, pairs[i].second);
       }
+      return *this;
     }
-    std::stringstream ss;
-    for (auto n : top) {
-      ss << toStringHelper(n) << "\n";
+    std::vector<int> merged(graph_detail::chunkCount(pairs.size(), BATCH_GRAIN), 0);
+    graph_detail::parallelChunks(pairs.size(), BATCH_GRAIN, pool, [&](size_t c, size_t b, size_t e) {
+      for (auto i = b; i < e; ++i) {
+        merged[c] += casLink(parent.data(), pairs[i].first, pairs[i].second);
+      }
+    });
+    cnt -= std::accumulate(merged.begin(), merged.end(), 0);
+    graph_detail::parallelChunks(parent.size(), BATCH_GRAIN, pool, [&](size_t, size_t b, size_t e) {
+      for (auto i = b; i < e; ++i) {
+        int r = casFind(parent.data(), static_cast<int>(i));
+        std::atomic_ref<int>(parent[i]).store(r, std::memory_order_relaxed);
+        rank[i] = 0;
+      }
+    });
+    for (int i = 0; i < size(); i++) {
+      if (parent[i] != i) {
+        rank[parent[i]] = 1;
+      }
     }
-    std::string ret = ss.str();
+    return *this;
+  }
+
+  /// isConnected for every pair, 1 or 0; with a pool the queries run in parallel chunks
+  std::vector<std::uint8_t> isConnected(std::span<const std::pair<int, int>> pairs, ThreadPool *pool = nullptr) {
+    std::vector<std::uint8_t> ret(pairs.size());
+    graph_detail::parallelChunks(pairs.size(), unionfind_detail::BATCH_GRAIN, pool, [&](size_t, size_t b, size_t e) {
+      for (auto i = b; i < e; ++i) {
+        ret[i] = unionfind_detail::casSameSet(parent.data(), pairs[i].first, pairs[i].second);
+      }
+    });
     return ret;
   }
 
-  std::string toStringHelper(int a) const {
-    std::stringstream ss;
-    ss << a << "-(";
-    for (int i = 0; i < parent.size(); i++) {
-      if (parent[i] == a && i != a) {
-        ss << toStringHelper(i) << ",";
+  /// labels[v] is the smallest node of v's set, in O(n); flattens every path on the way
+  std::vector<int> components() {
+    // labels[r] of a root doubles as the label of its set until r itself is reached
+    std::vector<int> labels(size(), -1);
+    for (int v = 0; v < size(); v++) {
+      int r = find(v);
+      parent[v] = r;
+      if (labels[r] < 0) {
+        labels[r] = v;
+      }
+      labels[v] = labels[r];
+    }
+    return labels;
+  }
+
+  std::string toString() const {
+    return unionfind_detail::describe(parent, [](int i) { return i; });
+  }
+};
+
+/// Union-find over arbitrary hashable values: each value is hashed once to a dense index and the sets live in a
+/// UnionFindSet<int>.
+template <typename T, typename Hash, typename Eq>
+class UnionFindSet {
+  private:
+  std::unordered_map<T, int, Hash, Eq> index;
+  std::vector<T> values;
+  UnionFindSet<int> core;
+
+  int indexOf(const T &key) const {
+    auto it = index.find(key);
+    if (it == index.end()) {
+      throw std::out_of_range(sk::utils::format("key {} Unexist.", key));
+    }
+    return it->second;
+  }
+
+  int emplace(const T &val) {
+    auto [it, yes] = index.emplace(val, static_cast<int>(values.size()));
+    if (yes) {
+      values.push_back(val);
+      core.add();
+    }
+    return it->second;
+  }
+
+  std::vector<int> emplaceAll(const std::vector<T> &nodes) {
+    index.reserve(nodes.size());
+    values.reserve(nodes.size());
+    std::vector<int> ids;
+    ids.reserve(nodes.size());
+    for (const auto &val : nodes) {
+      ids.push_back(emplace(val));
+    }
+    return ids;
+  }
+
+  /// works for CsrGraph and AdjListGraph; an undirected edge is stored twice, so only v < u is used
+  template <typename G>
+  void connectEdges(const G &g) {
+    auto ids = emplaceAll(g.nodes);
+    for (int u = 0; u < g.size(); u++) {
+      g.forEachNeighbor(u, [&](int v, int) {
+        if (g.isYouXiang || v < u) {
+          core.connect(ids[u], ids[v]);
+        }
+      });
+    }
+  }
+
+  public:
+  UnionFindSet() = default;
+
+  explicit UnionFindSet(Graph<T> g) {
+    auto ids = emplaceAll(g.nodes);
+    for (int i = 0; i < g.size(); i++) {
+      for (int j = 0; j < (g.isYouXiang ? g.size() : i); j++) {
+        if (g.edges[i][j] != graphConst::dummyValue) {
+          core.connect(ids[i], ids[j]);
+        }
       }
     }
-    std::string ret = ss.str();
-    if (ret.back() == ',') {
-      ret.pop_back();
-      ret += ")";
-    } else {
-      ret.pop_back();
-      ret.pop_back();
+  }
+
+  explicit UnionFindSet(const CsrGraph<T> &g) { connectEdges(g); }
+
+  explicit UnionFindSet(const AdjListGraph<T> &g) { connectEdges(g); }
+
+  int count() const { return core.count(); }
+
+  void add(T val) { emplace(val); }
+
+  void add(T key, T val) {
+    int a = emplace(key);
+    int b = emplace(val);
+    core.connect(a, b);
+  }
+
+  T find(T key) { return values[core.find(indexOf(key))]; }
+
+  void connect(T key1, T key2) { core.connect(indexOf(key1), indexOf(key2)); }
+
+  bool isConnected(T key1, T key2) { return core.isConnected(indexOf(key1), indexOf(key2)); }
+
+  std::string toString() const {
+    if (count() == 0) {
+      return std::string{"[]"};
     }
+    return unionfind_detail::describe(core.parent, [this](int i) { return sk::utils::format("{}", values[i]); });
+  }
+};
+
+/// Lock-free union-find for many threads connecting at once (Anderson, Woll; Jayanti, Tarjan). find halves the
+/// path with CAS, and connect links one root under the other with a single CAS on the root's parent, retrying
+/// from the new roots when a concurrent link won. Roots are linked by index, larger under smaller, rather than by
+/// rank: no second word per node has to change atomically with the parent, and every root is the smallest node
+/// of its set, so components() does not depend on how the threads interleaved.
+class ConcurrentUnionFindSet {
+  public:
+  explicit ConcurrentUnionFindSet(int n = 0) : parent(n) { std::iota(parent.begin(), parent.end(), 0); }
+
+  int size() const { return static_cast<int>(parent.size()); }
+
+  int find(int x) { return unionfind_detail::casFind(parent.data(), x); }
+
+  /// true if this call merged two sets
+  bool connect(int a, int b) { return unionfind_detail::casLink(parent.data(), a, b); }
+
+  bool isConnected(int a, int b) { return unionfind_detail::casSameSet(parent.data(), a, b); }
+
+  /// connects every pair, in parallel chunks with a pool; returns how many sets were merged
+  int connectBatch(std::span<const std::pair<int, int>> pairs, ThreadPool *pool = nullptr) {
+    using namespace unionfind_detail;
+    std::vector<int> merged(graph_detail::chunkCount(pairs.size(), BATCH_GRAIN), 0);
+    graph_detail::parallelChunks(pairs.size(), BATCH_GRAIN, pool, [&](size_t c, size_t b, size_t e) {
+      for (auto i = b; i < e; ++i) {
+        merged[c] += casLink(parent.data(), pairs[i].first, pairs[i].second);
+      }
+    });
+    return std::accumulate(merged.begin(), merged.end(), 0);
+  }
+
+  std::vector<std::uint8_t> isConnected(std::span<const std::pair<int, int>> pairs, ThreadPool *pool = nullptr) {
+    std::vector<std::uint8_t> ret(pairs.size());
+    graph_detail::parallelChunks(pairs.size(), unionfind_detail::BATCH_GRAIN, pool, [&](size_t, size_t b, size_t e) {
+      for (auto i = b; i < e; ++i) {
+        ret[i] = unionfind_detail::casSameSet(parent.data(), pairs[i].first, pairs[i].second);
+      }
+    });
     return ret;
   }
+
+  /// number of sets, O(n) scan; exact once no connect is running
+  int count() const {
+    int cnt = 0;
+    for (int i = 0; i < size(); i++) {
+      cnt += std::atomic_ref<int>(parent[i]).load(std::memory_order_relaxed) == i;
+    }
+    return cnt;
+  }
+
+  /// labels[v] is the smallest node of v's set; flattens every path, so call it after the connects are done
+  std::vector<int> components(ThreadPool *pool = nullptr) {
+    std::vector<int> labels(size());
+    graph_detail::parallelChunks(size(), 1 << 12, pool, [&](size_t, size_t b, size_t e) {
+      for (auto v = static_cast<int>(b); v < static_cast<int>(e); ++v) {
+        labels[v] = find(v);
+        std::atomic_ref<int>(parent[v]).store(labels[v], std::memory_order_relaxed);
+      }
+    });
+    return labels;
+  }
+
+  private:
+  /// shared through atomic_ref, which needs a non-const int even for loads
+  mutable std::vector<int> parent;
 };
 
 }  // namespace sk::utils::dts
@@ -0,0 +1,213 @@
+#ifndef SHUAIKAI_UTILS_EPOCH_H
+#define SHUAIKAI_UTILS_EPOCH_H
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+#include "noncopyable.h"
+
+namespace sk::utils {
+
+/// Epoch-based reclamation for lock-free containers.
+///
+/// Readers pin the current global epoch with a Guard for as long as they hold raw pointers into a shared
+/// structure. A writer that unlinks a node retires it instead of deleting it; the node is freed once the global
+/// epoch has advanced twice past the retirement, which can only happen after every thread pinned at that time
+/// has left its critical section.
+class EpochManager : public NonCopyable {
+  public:
+  /// pins the calling thread while alive, guards may nest
+  class Guard {
+    public:
+    explicit Guard(EpochManager& mgr) : mgr_(mgr) { mgr_.enter(); }
+
+    ~Guard() { mgr_.leave(); }
+
+    Guard(const Guard&) = delete;
+    Guard& operator=(const Guard&) = delete;
+
+    private:
+    EpochManager& mgr_;
+  };
+
+  static EpochManager& instance() {
+    static EpochManager mgr;
+    return mgr;
+  }
+
+  Guard pin() { return Guard(*this); }
+
+  /// frees `p` with `deleter` once no pinned thread can still see it
+  void retire(void* p, void (*deleter)(void*)) {
+    auto& rec = local();
+    rec.limbo.push_back({p, deleter, globalEpoch_.load(std::memory_order_acquire)});
+    if (rec.limbo.size() >= COLLECT_THRESHOLD) {
+      collect(rec);
+    }
+  }
+
+  template <typename T>
+  void retire(T* p) {
+    retire(p, [](void* q) { delete static_cast<T*>(q); });
+  }
+
+  /// tries to advance the epoch and frees what has become safe, returns the calling thread's pending count
+  size_t collect() {
+    auto& rec = local();
+    collect(rec);
+    return rec.limbo.size();
+  }
+
+  std::uint64_t epoch() const { return globalEpoch_.load(std::memory_order_acquire); }
+
+  ~EpochManager() {
+    for (auto* rec = records_.load(); rec != nullptr;) {
+      auto* next = rec->next;
+      freeAll(rec->limbo);
+      delete rec;
+      rec = next;
+    }
+    freeAll(orphans_);
+  }
+
+  private:
+  static constexpr size_t COLLECT_THRESHOLD = 64;
+  static constexpr std::uint64_t ACTIVE = 1;
+
+  struct Retired {
+    void* ptr;
+    void (*deleter)(void*);
+    std::uint64_t epoch;
+  };
+
+  /// one per live thread, reused after the thread exits; state is (epoch << 1) | ACTIVE while pinned
+  struct alignas(64) Record {
+    std::atomic<std::uint64_t> state{0};
+    std::atomic<bool> inUse{true};
+    Record* next{nullptr};
+    int nest{0};
+    std::vector<Retired> limbo;
+  };
+
+  /// releases the record when its thread exits
+  struct LocalHandle {
+    EpochManager* mgr{nullptr};
+    Record* rec{nullptr};
+
+    ~LocalHandle() {
+      if (rec != nullptr) {
+        mgr->release(rec);
+      }
+    }
+  };
+
+  EpochManager() = default;
+
+  Record& local() {
+    thread_local LocalHandle handle;
+    if (handle.rec == nullptr) {
+      handle.mgr = this;
+      handle.rec = acquire();
+    }
+    return *handle.rec;
+  }
+
+  Record* acquire() {
+    for (auto* rec = records_.load(std::memory_order_acquire); rec != nullptr; rec = rec->next) {
+      bool expected = false;
+      if (!rec->inUse.load(std::memory_order_relaxed) && rec->inUse.compare_exchange_strong(expected, true)) {
+        return rec;
+      }
+    }
+    auto* rec = new Record;
+    rec->next = records_.load(std::memory_order_relaxed);
+    while (!records_.compare_exchange_weak(rec->next, rec, std::memory_order_acq_rel)) {}
+    return rec;
+  }
+
+  void release(Record* rec) {
+    {
+      std::lock_guard<std::mutex> lock(orphanMtx_);
+      orphans_.insert(orphans_.end(), rec->limbo.begin(), rec->limbo.end());
+    }
+    rec->limbo.clear();
+    rec->nest = 0;
+    rec->state.store(0, std::memory_order_release);
+    rec->inUse.store(false, std::memory_order_release);
+  }
+
+  void enter() {
+    auto& rec = local();
+    if (rec.nest++ > 0) {
+      return;
+    }
+    // re-check after publishing, so the epoch we announce is never behind the global one by more than the
+    // advance that might have raced with us
+    while (true) {
+      auto e = globalEpoch_.load(std::memory_order_seq_cst);
+      rec.state.store((e << 1) | ACTIVE, std::memory_order_seq_cst);
+      if (globalEpoch_.load(std::memory_order_seq_cst) == e) {
+        break;
+      }
+    }
+  }
+
+  void leave() {
+    auto& rec = local();
+    if (--rec.nest == 0) {
+      rec.state.store(0, std::memory_order_release);
+    }
+  }
+
+  /// advances the global epoch if every pinned thread has observed it
+  bool tryAdvance() {
+    auto e = globalEpoch_.load(std::memory_order_seq_cst);
+    for (auto* rec = records_.load(std::memory_order_acquire); rec != nullptr; rec = rec->next) {
+      auto s = rec->state.load(std::memory_order_seq_cst);
+      if ((s & ACTIVE) != 0 && (s >> 1) != e) {
+        return false;
+      }
+    }
+    return globalEpoch_.compare_exchange_strong(e, e + 1, std::memory_order_seq_cst);
+  }
+
+  void collect(Record& rec) {
+    tryAdvance();
+    auto e = globalEpoch_.load(std::memory_order_acquire);
+    freeUpTo(rec.limbo, e);
+    std::unique_lock<std::mutex> lock(orphanMtx_, std::try_to_lock);
+    if (lock.owns_lock() && !orphans_.empty()) {
+      freeUpTo(orphans_, e);
+    }
+  }
+
+  static void freeUpTo(std::vector<Retired>& limbo, std::uint64_t globalEpoch) {
+    size_t kept = 0;
+    for (auto& r : limbo) {
+      if (r.epoch + 2 <= globalEpoch) {
+        r.deleter(r.ptr);
+      } else {
+        limbo[kept++] = r;
+      }
+    }
+    limbo.resize(kept);
+  }
+
+  static void freeAll(std::vector<Retired>& limbo) {
+    for (auto& r : limbo) {
+      r.deleter(r.ptr);
+    }
+    limbo.clear();
+  }
+
+  std::atomic<std::uint64_t> globalEpoch_{2};
+  std::atomic<Record*> records_{nullptr};
+  std::mutex orphanMtx_;
+  std::vector<Retired> orphans_;
+};
+
+}  // namespace sk::utils
+
+#endif  // SHUAIKAI_UTILS_EPOCH_H
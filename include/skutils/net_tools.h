@@ -2,18 +2,258 @@
 #define SHUAIKAI_UTILS_NET_TOOLS_H
 
 #include <curl/curl.h>
+#if defined(_WIN32)
+#include <process.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
 #include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
 #include <filesystem>
 #include <fstream>
+#include <functional>
 #include <future>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <sstream>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "logger.h"
+#include "sha256.h"
 #include "string_utils.h"
 
 namespace fs = std::filesystem;
 
+/// Runs curl transfers on one I/O thread around a single curl_multi handle.
+///
+/// Every transfer added to the same multi handle shares its connection cache and DNS cache, so requests to one host
+/// reuse a TCP / TLS connection, and HTTP/2 streams are multiplexed over it when the server supports it. Easy handles
+/// are pooled and reset between transfers. At most max_concurrency transfers run at once, the rest wait in FIFO
+/// order. Callbacks run on the I/O thread: they should be short and must not block on another transfer; slow work
+/// such as fsync or hashing a file goes to Offload(), which runs it on one worker thread owned by the engine.
+class CurlMultiEngine {
+  public:
+  /// configures the pooled handle: URL, callbacks, headers; runs on the I/O thread
+  using Setup = std::function<void(CURL*)>;
+  /// the curl result and the HTTP status, 0 if the transfer failed before getting one
+  using Done = std::function<void(CURL*, CURLcode, std::int64_t)>;
+
+  explicit CurlMultiEngine(size_t max_concurrency = DEFAULT_CONCURRENCY)
+    : max_concurrency_(std::max<size_t>(max_concurrency, 1)) {
+    curl_global_init(CURL_GLOBAL_DEFAULT);
+    multi_ = curl_multi_init();
+    curl_multi_setopt(multi_, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+    io_ = std::thread([this] { Loop(); });
+    worker_ = std::thread([this] { WorkLoop(); });
+  }
+
+  CurlMultiEngine(const CurlMultiEngine&) = delete;
+  CurlMultiEngine& operator=(const CurlMultiEngine&) = delete;
+
+  /// unfinished transfers and offloaded work are dropped, their futures see a broken promise
+  ~CurlMultiEngine() {
+    stop_ = true;
+    curl_multi_wakeup(multi_);
+    io_.join();
+    {
+      std::lock_guard<std::mutex> lock(work_mtx_);
+      stop_work_ = true;
+    }
+    work_cv_.notify_all();
+    worker_.join();  // work that is still running may Perform(), so the multi handle outlives the worker
+    for (auto* easy : idle_) {
+      curl_easy_cleanup(easy);
+    }
+    curl_multi_cleanup(multi_);
+  }
+
+  /// the process wide engine behind AsyncDownloader
+  static CurlMultiEngine& Instance() {
+    static CurlMultiEngine engine;
+    return engine;
+  }
+
+  void SetMaxConcurrency(size_t max_concurrency) {
+    max_concurrency_ = std::max<size_t>(max_concurrency, 1);
+    curl_multi_wakeup(multi_);
+  }
+
+  size_t MaxConcurrency() const { return max_concurrency_; }
+
+  void Perform(Setup setup, Done done) {
+    {
+      std::lock_guard<std::mutex> lock(mtx_);
+      pending_.push_back(std::make_unique<Transfer>(Transfer{std::move(setup), std::move(done)}));
+    }
+    curl_multi_wakeup(multi_);
+  }
+
+  /// runs blocking work on the engine's worker thread, one job at a time in FIFO order
+  void Offload(std::function<void()> work) {
+    {
+      std::lock_guard<std::mutex> lock(work_mtx_);
+      work_.push_back(std::move(work));
+    }
+    work_cv_.notify_one();
+  }
+
+  constexpr static size_t DEFAULT_CONCURRENCY = 8;
+
+  private:
+  struct Transfer {
+    Setup setup;
+    Done done;
+  };
+
+  void Loop() {
+    while (!stop_) {
+      StartPending();
+      int running = 0;
+      curl_multi_perform(multi_, &running);
+      int left = 0;
+      while (CURLMsg* msg = curl_multi_info_read(multi_, &left)) {
+        if (msg->msg == CURLMSG_DONE) {
+          Finish(msg->easy_handle, msg->data.result);
+        }
+      }
+      curl_multi_poll(multi_, nullptr, 0, POLL_TIMEOUT_MS, nullptr);
+    }
+    for (auto& [easy, transfer] : active_) {
+      curl_multi_remove_handle(multi_, easy);
+      curl_easy_cleanup(easy);
+    }
+  }
+
+  void StartPending() {
+    std::vector<std::unique_ptr<Transfer>> failed;
+    while (true) {
+      std::unique_ptr<Transfer> transfer;
+      {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (pending_.empty() || active_.size() >= max_concurrency_) {
+          break;
+        }
+        transfer = std::move(pending_.front());
+        pending_.pop_front();
+      }
+      // outside the lock: setup may queue follow-up work through Perform()
+      CURL* easy = AcquireHandle();
+      if (easy == nullptr) {
+        failed.push_back(std::move(transfer));
+        continue;
+      }
+      curl_easy_setopt(easy, CURLOPT_PIPEWAIT, 1L);  // wait for a multiplexable connection rather than open one
+      curl_easy_setopt(easy, CURLOPT_HTTP_VERSION, CURL_HTTP_VERSION_2TLS);
+      bool added = false;
+      try {
+        transfer->setup(easy);
+        added = curl_multi_add_handle(multi_, easy) == CURLM_OK;
+      } catch (const std::exception& e) {
+        SK_ERROR("curl setup callback threw: {}", e.what());
+      }
+      if (!added) {
+        curl_easy_reset(easy);
+        idle_.push_back(easy);
+        failed.push_back(std::move(transfer));
+        continue;
+      }
+      active_.emplace_back(easy, std::move(transfer));
+    }
+    for (auto& transfer : failed) {
+      try {
+        transfer->done(nullptr, CURLE_FAILED_INIT, 0);
+      } catch (const std::exception& e) {
+        SK_ERROR("curl completion callback threw: {}", e.what());
+      }
+    }
+  }
+
+  void Finish(CURL* easy, CURLcode result) {
+    curl_multi_remove_handle(multi_, easy);
+    auto it = std::find_if(active_.begin(), active_.end(), [easy](const auto& a) { return a.first == easy; });
+    auto transfer = std::move(it->second);
+    active_.erase(it);
+    long http_code = 0;  // CURLINFO_RESPONSE_CODE writes a long
+    curl_easy_getinfo(easy, CURLINFO_RESPONSE_CODE, &http_code);
+    try {
+      transfer->done(easy, result, static_cast<std::int64_t>(http_code));
+    } catch (const std::exception& e) {
+      SK_ERROR("curl completion callback threw: {}", e.what());
+    }
+    curl_easy_reset(easy);
+    idle_.push_back(easy);
+  }
+
+  void WorkLoop() {
+    while (true) {
+      std::function<void()> work;
+      {
+        std::unique_lock<std::mutex> lock(work_mtx_);
+        work_cv_.wait(lock, [this] { return stop_work_ || !work_.empty(); });
+        if (stop_work_) {
+          return;
+        }
+        work = std::move(work_.front());
+        work_.pop_front();
+      }
+      try {
+        work();
+      } catch (const std::exception& e) {
+        SK_ERROR("curl offloaded work threw: {}", e.what());
+      }
+    }
+  }
+
+  CURL* AcquireHandle() {
+    if (idle_.empty()) {
+      return curl_easy_init();
+    }
+    CURL* easy = idle_.back();
+    idle_.pop_back();
+    return easy;
+  }
+
+  constexpr static int POLL_TIMEOUT_MS = 1000;
+
+  CURLM* multi_;
+  std::atomic<size_t> max_concurrency_;
+  std::atomic<bool> stop_{false};
+  std::mutex mtx_;
+  std::deque<std::unique_ptr<Transfer>> pending_;
+  // touched by the I/O thread only
+  std::vector<std::pair<CURL*, std::unique_ptr<Transfer>>> active_;
+  std::vector<CURL*> idle_;
+  std::thread io_;
+  std::mutex work_mtx_;
+  std::condition_variable work_cv_;
+  std::deque<std::function<void()>> work_;
+  bool stop_work_{false};
+  std::thread worker_;
+};
+
+/// Options of AsyncDownloader::DownloadSegmented.
+struct SegmentedDownloadOptions {
+  size_t segments{4};                    // 最多同时下载的分段数
+  std::int64_t min_segment_size{1 << 20};  // 分段不小于这个字节数, 小文件只用一段
+  std::string sha256;                    // 期望的摘要(十六进制, 可带 "sha256:" 前缀), 空串时不校验
+};
+
 class AsyncDownloader {
   public:
   enum class STATUS {
@@ -26,6 +266,11 @@ class AsyncDownloader {
     UNKNOWN
   };
 
+  // HttpDiskCache 离线模式下没有缓存
+  constexpr static std::int64_t OFFLINE_MISS_CODE = -4;
+  // 下载完成但摘要与期望值不符, 文件已被删除
+  constexpr static std::int64_t CHECKSUM_FAIL_CODE = -5;
+
   static STATUS CheckHttpStatusCode(std::int64_t status_code) {
     if (status_code < 0) {
       return STATUS::CURL_FAILED;
@@ -40,50 +285,132 @@ class AsyncDownloader {
     }
   }
 
+  // 同时进行的传输数上限, 其余的排队
+  static void SetMaxConcurrency(size_t max_concurrency) {
+    CurlMultiEngine::Instance().SetMaxConcurrency(max_concurrency);
+  }
+
   // 下载到内存（返回字符串）
   static std::future<std::pair<std::string, std::int64_t>> FetchAsString(const std::string& url) {
-    return std::async(std::launch::async, [url]() {
-      CURL* curl = curl_easy_init();
-      if (!curl) {
-        return std::pair<std::string, std::int64_t>{"CURL_INIT_FAILED", CURL_INIT_FAIL_CODE};
-      }
+    auto promise = std::make_shared<std::promise<std::pair<std::string, std::int64_t>>>();
+    auto fut = promise->get_future();
+    FetchConditional(url, "", [promise](Response response) {
+      promise->set_value({std::move(response.body), response.code});
+    });
+    return fut;
+  }
 
-      std::string response;
-      SetupCommonOptions(curl, url);
-      curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteStringCallback);
-      curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
-      auto ret_code = ExecuteRequest(curl);
-      curl_easy_cleanup(curl);
+  struct Response {
+    std::string body;
+    std::int64_t code{0};
+    std::string etag;
+  };
 
-      return std::pair<std::string, std::int64_t>{response, ret_code};
-    });
+  // 条件请求: etag 非空时带上 If-None-Match, 服务端未变化时返回 304 且没有 body
+  static std::future<Response> FetchConditional(const std::string& url, const std::string& etag) {
+    auto promise = std::make_shared<std::promise<Response>>();
+    auto fut = promise->get_future();
+    FetchConditional(url, etag, [promise](Response response) { promise->set_value(std::move(response)); });
+    return fut;
   }
 
-  // 下载到本地文件
-  static std::future<std::pair<bool, std::int64_t>> DownloadToFile(const std::string& url, const fs::path& filepath) {
-    return std::async(std::launch::async, [url, filepath]() {
-      CURL* curl = curl_easy_init();
-      bool success = false;
-      if (!curl) {
-        return std::pair<bool, std::int64_t>{false, CURL_INIT_FAIL_CODE};
-      }
+  // 回调版本, on_done 在 I/O 线程上执行
+  static void FetchConditional(const std::string& url, const std::string& etag, std::function<void(Response)> on_done) {
+    struct State {
+      Response response;
+      curl_slist* headers{nullptr};
 
-      auto ensured_filepath = EnsuredFilePath(url, filepath);
-      std::ofstream file(ensured_filepath, std::ios::binary);
-      if (!file.is_open()) {
-        return std::pair<bool, std::int64_t>{false, INNER_FAIL_CODE};
-      }
+      ~State() { curl_slist_free_all(headers); }
+    };
+    auto state = std::make_shared<State>();
+    CurlMultiEngine::Instance().Perform(
+      [state, url, etag](CURL* curl) {
+        if (!etag.empty()) {
+          state->headers = curl_slist_append(state->headers, ("If-None-Match: " + etag).c_str());
+        }
+        SetupCommonOptions(curl, url);
+        curl_easy_setopt(curl, CURLOPT_HTTPHEADER, state->headers);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteStringCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &state->response.body);
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, EtagHeaderCallback);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, &state->response.etag);
+      },
+      [state, on_done = std::move(on_done)](CURL*, CURLcode result, std::int64_t http_code) {
+        state->response.code = ResultCode(result, http_code);
+        on_done(std::move(state->response));
+      });
+  }
 
-      SetupCommonOptions(curl, url);
-      curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteFileCallback);
-      curl_easy_setopt(curl, CURLOPT_WRITEDATA, &file);
+  // 下载到本地文件
+  static std::future<std::pair<bool, std::int64_t>> DownloadToFile(const std::string& url, const fs::path& filepath) {
+    auto promise = std::make_shared<std::promise<std::pair<bool, std::int64_t>>>();
+    auto fut = promise->get_future();
+    DownloadToFile(url, filepath, [promise](bool ok, std::int64_t code) { promise->set_value({ok, code}); });
+    return fut;
+  }
 
-      auto ret_code = ExecuteRequest(curl);
-      file.close();
+  // 回调版本, on_done 在 I/O 线程上执行(文件打不开时在调用线程上)
+  static void DownloadToFile(const std::string& url, const fs::path& filepath,
+                             std::function<void(bool, std::int64_t)> on_done) {
+    fs::path final_path;
+    try {
+      final_path = EnsuredFilePath(url, filepath);
+    } catch (const fs::filesystem_error& e) {
+      SK_ERROR("Cannot create {}: {}", filepath.string(), e.what());
+      on_done(false, INNER_FAIL_CODE);
+      return;
+    }
+    DownloadToResolvedFile(url, final_path, std::move(on_done));
+  }
 
-      curl_easy_cleanup(curl);
-      return std::pair<bool, std::int64_t>{(ret_code / 100 == 2), ret_code};
-    });
+  // 分段并行下载: 先用 HEAD 探测大小, ETag, Last-Modified 和 Accept-Ranges, 预分配文件后发出多个 Range 请求,
+  // 各自用 pwrite 写到自己的偏移. 进度记在旁边的 <file>.part 里, 失败后再次调用只下载缺的字节.
+  // 服务端不支持 Range 或大小未知时退化成 DownloadToFile. 最后按 options.sha256 校验整个文件
+  static std::future<std::pair<bool, std::int64_t>> DownloadSegmented(const std::string& url, const fs::path& filepath,
+                                                                      SegmentedDownloadOptions options = {}) {
+    auto job = std::make_shared<SegmentedJob>();
+    auto fut = job->promise.get_future();
+    job->url = url;
+    job->options = std::move(options);
+    try {
+      job->path = EnsuredFilePath(url, filepath);
+    } catch (const fs::filesystem_error& e) {
+      SK_ERROR("Cannot create {}: {}", filepath.string(), e.what());
+      job->promise.set_value({false, INNER_FAIL_CODE});
+      return fut;
+    }
+#if defined(_WIN32)
+    DownloadWhole(job);  // 没有 pwrite, 整个文件顺序下载
+#else
+    CurlMultiEngine::Instance().Perform(
+      [job](CURL* curl) {
+        SetupCommonOptions(curl, job->url);
+        curl_easy_setopt(curl, CURLOPT_NOBODY, 1L);
+        curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, ProbeHeaderCallback);
+        curl_easy_setopt(curl, CURLOPT_HEADERDATA, job.get());
+      },
+      [job](CURL* curl, CURLcode result, std::int64_t http_code) {
+        curl_off_t length = -1;
+        char* effective_url = nullptr;
+        if (curl != nullptr) {
+          curl_easy_getinfo(curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &length);
+          curl_easy_getinfo(curl, CURLINFO_EFFECTIVE_URL, &effective_url);
+        }
+        if (result != CURLE_OK) {
+          job->promise.set_value({false, ResultCode(result, http_code)});  // 连不上, 保留进度下次续传
+          return;
+        }
+        if (http_code / 100 != 2 || !job->accept_ranges || length < 0) {
+          DownloadWhole(job);
+          return;
+        }
+        job->length = length;
+        // 重定向只在探测时走一次, 分段直接请求最终地址
+        job->range_url = effective_url != nullptr ? effective_url : job->url;
+        OffIoThread([job] { StartSegments(job); });
+      });
+#endif
+    return fut;
   }
 
   private:
@@ -96,16 +423,12 @@ class AsyncDownloader {
     curl_easy_setopt(curl, CURLOPT_TIMEOUT, 300L);             // 整体超时 300 秒
   }
 
-  // 执行请求并处理错误
-  static std::int64_t ExecuteRequest(CURL* curl) {
-    CURLcode res = curl_easy_perform(curl);
-    if (res != CURLE_OK) {
-      SK_ERROR("CURL error: {}", curl_easy_strerror(res));
-      return CURL_EXEC_FAIL_CODE;
+  // 传输结果转换成返回码
+  static std::int64_t ResultCode(CURLcode result, std::int64_t http_code) {
+    if (result != CURLE_OK) {
+      SK_ERROR("CURL error: {}", curl_easy_strerror(result));
+      return result == CURLE_FAILED_INIT ? CURL_INIT_FAIL_CODE : CURL_EXEC_FAIL_CODE;
     }
-
-    std::int64_t http_code = 0;
-    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &http_code);
     return http_code;
   }
 
@@ -123,6 +446,361 @@ class AsyncDownloader {
     return total;
   }
 
+  // 每个响应(包括重定向前的)都从状态行开始, 只保留最后一个响应的 ETag
+  static size_t EtagHeaderCallback(char* buffer, size_t size, size_t nitems, std::string* etag) {
+    size_t total = size * nitems;
+    std::string_view line(buffer, total);
+    if (sk::utils::str::startWith(line, "HTTP/")) {
+      etag->clear();
+    } else if (auto value = HeaderValue(line, "etag")) {
+      *etag = *value;
+    }
+    return total;
+  }
+
+  // 头部行 "name: value" 的值, name 用小写给出, 比较时不区分大小写
+  static std::optional<std::string> HeaderValue(std::string_view line, std::string_view name) {
+    if (line.size() <= name.size() || line[name.size()] != ':' ||
+        !std::equal(name.begin(), name.end(), line.begin(),
+                    [](char a, char b) { return a == std::tolower(static_cast<unsigned char>(b)); })) {
+      return std::nullopt;
+    }
+    return sk::utils::str::trim(line.substr(name.size() + 1), " \t\r\n");
+  }
+
+  struct SegmentedJob {
+    // [begin, end) 中已经写好了前 done 个字节
+    struct Segment {
+      std::int64_t begin;
+      std::int64_t end;
+      std::int64_t done;
+    };
+
+    std::string url;
+    std::string range_url;
+    fs::path path;
+    SegmentedDownloadOptions options;
+    std::promise<std::pair<bool, std::int64_t>> promise;
+    // HEAD 的结果
+    std::string etag;
+    std::string last_modified;
+    bool accept_ranges{false};
+    std::int64_t length{-1};
+    // 以下在准备和收尾时只由文件线程访问, 分段传输期间只由 I/O 线程访问
+    int fd{-1};
+    std::vector<Segment> segments;
+    size_t running{0};
+    std::int64_t failure{0};   // 第一个失败分段的返回码
+    std::int64_t unsaved{0};   // 上次保存进度之后写入的字节数
+
+    ~SegmentedJob() { CloseFile(); }
+
+    // If-Range 用的校验值: 强 ETag, 否则 Last-Modified; 都没有时为空, 无法判断文件是否变过
+    std::string Validator() const {
+      if (!etag.empty() && !sk::utils::str::startWith(etag, "W/")) {
+        return etag;
+      }
+      return last_modified;
+    }
+
+    void CloseFile() {
+#if !defined(_WIN32)
+      if (fd >= 0) {
+        close(fd);
+        fd = -1;
+      }
+#endif
+    }
+  };
+
+  // 一个分段传输的写回调状态
+  struct SegmentWriter {
+    SegmentedJob* job;
+    size_t index;
+    CURL* curl{nullptr};
+    curl_slist* headers{nullptr};
+    bool checked{false};  // 已确认是 206
+    bool discard{false};  // 错误响应的 body, 丢弃
+
+    ~SegmentWriter() { curl_slist_free_all(headers); }
+  };
+
+  constexpr static std::int64_t HTTP_PARTIAL_CONTENT = 206;
+  // 每写入这么多字节保存一次进度, 进程被杀时最多重下这么多
+  constexpr static std::int64_t PROGRESS_SAVE_BYTES = 4 << 20;
+
+  static fs::path ProgressPath(const fs::path& path) { return fs::path(path.string() + ".part"); }
+
+  // 预分配, fsync 和整个文件的摘要可能要几秒, 交给引擎的工作线程(即下文的文件线程), 不能卡住所有传输共用的 I/O 线程
+  static void OffIoThread(std::function<void()> work) { CurlMultiEngine::Instance().Offload(std::move(work)); }
+
+  // 校验摘要后交付结果; 在文件线程上调用
+  static void Complete(SegmentedJob& job, bool ok, std::int64_t code) {
+    std::string_view expected = job.options.sha256;
+    if (sk::utils::str::startWith(expected, "sha256:")) {
+      expected.remove_prefix(7);
+    }
+    if (ok && !expected.empty()) {
+      auto digest = sk::utils::Sha256::ofFile(job.path);
+      auto same = [](char a, char b) { return a == std::tolower(static_cast<unsigned char>(b)); };
+      if (!digest || !std::equal(digest->begin(), digest->end(), expected.begin(), expected.end(), same)) {
+        SK_ERROR("Checksum mismatch for {}: expected {}, got {}", job.path.string(), expected, digest.value_or(""));
+        std::error_code ec;
+        fs::remove(job.path, ec);
+        ok = false;
+        code = CHECKSUM_FAIL_CODE;
+      }
+    }
+    job.promise.set_value({ok, code});
+  }
+
+  /// DownloadToFile to a path already resolved by EnsuredFilePath; resolving it again would turn an
+  /// extensionless file that does not exist yet into a directory
+  static void DownloadToResolvedFile(const std::string& url, const fs::path& final_path,
+                                     std::function<void(bool, std::int64_t)> on_done) {
+    auto file = std::make_shared<std::ofstream>(final_path, std::ios::binary);
+    if (!file->is_open()) {
+      SK_ERROR("Cannot create {}", final_path.string());
+      on_done(false, INNER_FAIL_CODE);
+      return;
+    }
+
+    CurlMultiEngine::Instance().Perform(
+      [file, url](CURL* curl) {
+        SetupCommonOptions(curl, url);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteFileCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, file.get());
+      },
+      [file, on_done = std::move(on_done)](CURL*, CURLcode result, std::int64_t http_code) {
+        file->close();
+        auto ret_code = ResultCode(result, http_code);
+        on_done(ret_code / 100 == 2, ret_code);
+      });
+  }
+
+  static void DownloadWhole(const std::shared_ptr<SegmentedJob>& job) {
+    std::error_code ec;
+    fs::remove(ProgressPath(job->path), ec);
+    DownloadToResolvedFile(job->url, job->path, [job](bool ok, std::int64_t code) {
+      OffIoThread([job, ok, code] { Complete(*job, ok, code); });
+    });
+  }
+
+  static size_t ProbeHeaderCallback(char* buffer, size_t size, size_t nitems, SegmentedJob* job) {
+    size_t total = size * nitems;
+    std::string_view line(buffer, total);
+    if (sk::utils::str::startWith(line, "HTTP/")) {
+      job->etag.clear();
+      job->last_modified.clear();
+      job->accept_ranges = false;
+    } else if (auto etag = HeaderValue(line, "etag")) {
+      job->etag = *etag;
+    } else if (auto last_modified = HeaderValue(line, "last-modified")) {
+      job->last_modified = *last_modified;
+    } else if (auto ranges = HeaderValue(line, "accept-ranges")) {
+      job->accept_ranges = *ranges == "bytes";
+    }
+    return total;
+  }
+
+#if !defined(_WIN32)
+  // 按 segments 和 min_segment_size 均分 [0, length)
+  static void PlanSegments(SegmentedJob& job) {
+    auto min_size = std::max<std::int64_t>(job.options.min_segment_size, 1);
+    auto n = std::clamp<std::int64_t>((job.length + min_size - 1) / min_size, 0,
+                                      std::max<std::int64_t>(static_cast<std::int64_t>(job.options.segments), 1));
+    job.segments.clear();
+    for (std::int64_t i = 0; i < n; ++i) {
+      job.segments.push_back({job.length * i / n, job.length * (i + 1) / n, 0});
+    }
+  }
+
+  // 进度文件: url, 校验值, 长度各一行, 之后每行一个分段 "begin end done"
+  static void SaveProgress(SegmentedJob& job) {
+    job.unsaved = 0;
+    auto path = ProgressPath(job.path);
+    auto tmp = fs::path(path.string() + ".tmp");
+    {
+      std::ofstream out(tmp, std::ios::trunc);
+      out << job.url << '\n' << job.Validator() << '\n' << job.length << '\n';
+      for (const auto& seg : job.segments) {
+        out << seg.begin << ' ' << seg.end << ' ' << seg.done << '\n';
+      }
+      if (!out) {
+        return;
+      }
+    }
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+  }
+
+  // 进度文件与这次探测到的 url, 校验值, 长度都一致且分段完整覆盖文件时才续传;
+  // 服务端既没给强 ETag 也没给 Last-Modified 时, 长度不变的新文件会和旧分段拼在一起, 所以不续传
+  static bool LoadProgress(SegmentedJob& job) {
+    auto validator = job.Validator();
+    if (validator.empty()) {
+      return false;
+    }
+    std::ifstream in(ProgressPath(job.path));
+    std::string url;
+    std::string stored;
+    std::int64_t length = -1;
+    if (!std::getline(in, url) || !std::getline(in, stored) || !(in >> length) || url != job.url ||
+        stored != validator || length != job.length) {
+      return false;
+    }
+    std::error_code ec;
+    if (fs::file_size(job.path, ec) != static_cast<std::uintmax_t>(length) || ec) {
+      return false;
+    }
+    std::vector<SegmentedJob::Segment> segments;
+    std::int64_t next = 0;
+    for (SegmentedJob::Segment seg{}; in >> seg.begin >> seg.end >> seg.done;) {
+      if (seg.begin != next || seg.end <= seg.begin || seg.done < 0 || seg.done > seg.end - seg.begin) {
+        return false;
+      }
+      next = seg.end;
+      segments.push_back(seg);
+    }
+    if (next != length) {
+      return false;
+    }
+    job.segments = std::move(segments);
+    return true;
+  }
+
+  // 在文件线程上准备好文件和进度后发出各分段
+  static void StartSegments(const std::shared_ptr<SegmentedJob>& job) {
+    bool resumed = LoadProgress(*job);
+    if (!resumed) {
+      PlanSegments(*job);
+    }
+    job->fd = open(job->path.c_str(), O_RDWR | O_CREAT, 0644);
+    int err = 0;
+    if (job->fd < 0 || (!resumed && ftruncate(job->fd, job->length) != 0)) {
+      err = errno;
+    }
+#if defined(__linux__)
+    // 提前占住磁盘空间, 空间不足时马上失败而不是写到一半. posix_fallocate 直接返回错误码, 不设置 errno
+    else if (!resumed && job->length > 0) {
+      err = posix_fallocate(job->fd, 0, job->length);
+    }
+#endif
+    if (err != 0) {
+      SK_ERROR("Cannot allocate {} bytes for {}: {}", job->length, job->path.string(), std::strerror(err));
+      job->CloseFile();
+      job->promise.set_value({false, INNER_FAIL_CODE});
+      return;
+    }
+    if (resumed) {
+      SK_LOG("Resuming {} from {}", job->path.string(), ProgressPath(job->path).string());
+    }
+    SaveProgress(*job);
+    std::vector<size_t> missing;
+    for (size_t i = 0; i < job->segments.size(); ++i) {
+      if (job->segments[i].done < job->segments[i].end - job->segments[i].begin) {
+        missing.push_back(i);
+      }
+    }
+    // 先数完再发出: 第一个分段可能在 I/O 线程上结束时, 这里还没发完
+    job->running = missing.size();
+    for (auto i : missing) {
+      StartSegment(job, i);
+    }
+    if (missing.empty()) {
+      FinishSegments(job);
+    }
+  }
+
+  static void StartSegment(const std::shared_ptr<SegmentedJob>& job, size_t index) {
+    auto writer = std::make_shared<SegmentWriter>(SegmentWriter{job.get(), index});
+    CurlMultiEngine::Instance().Perform(
+      [job, writer](CURL* curl) {
+        const auto& seg = job->segments[writer->index];
+        writer->curl = curl;
+        SetupCommonOptions(curl, job->range_url);
+        auto range = std::to_string(seg.begin + seg.done) + "-" + std::to_string(seg.end - 1);
+        curl_easy_setopt(curl, CURLOPT_RANGE, range.c_str());
+        // 文件在两次请求之间变了时, 服务端回 200 整个文件, 写回调会拒绝它
+        if (auto validator = job->Validator(); !validator.empty()) {
+          writer->headers = curl_slist_append(writer->headers, ("If-Range: " + validator).c_str());
+          curl_easy_setopt(curl, CURLOPT_HTTPHEADER, writer->headers);
+        }
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, WriteSegmentCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, writer.get());
+      },
+      [job, writer](CURL*, CURLcode result, std::int64_t http_code) {
+        const auto& seg = job->segments[writer->index];
+        auto ret_code = ResultCode(result, http_code);
+        if (ret_code != HTTP_PARTIAL_CONTENT || seg.done != seg.end - seg.begin) {
+          SK_ERROR("Segment {} of {} failed: {}", writer->index, job->url, ret_code);
+          if (job->failure == 0) {
+            job->failure = ret_code == HTTP_PARTIAL_CONTENT ? CURL_EXEC_FAIL_CODE : ret_code;
+          }
+        }
+        if (--job->running == 0) {
+          OffIoThread([job] { FinishSegments(job); });
+        }
+      });
+  }
+
+  static size_t WriteSegmentCallback(void* contents, size_t size, size_t nmemb, SegmentWriter* writer) {
+    size_t total = size * nmemb;
+    if (!writer->checked) {
+      long http_code = 0;  // CURLINFO_RESPONSE_CODE writes a long
+      curl_easy_getinfo(writer->curl, CURLINFO_RESPONSE_CODE, &http_code);
+      if (http_code / 100 == 2 && http_code != HTTP_PARTIAL_CONTENT) {
+        return 0;  // 忽略了 Range 的整个文件, 写下去会错位
+      }
+      writer->discard = http_code != HTTP_PARTIAL_CONTENT;
+      writer->checked = true;
+    }
+    if (writer->discard) {
+      return total;
+    }
+    auto& job = *writer->job;
+    auto& seg = job.segments[writer->index];
+    if (seg.begin + seg.done + static_cast<std::int64_t>(total) > seg.end) {
+      return 0;
+    }
+    const char* data = static_cast<const char*>(contents);
+    for (size_t written = 0; written < total;) {
+      auto n = pwrite(job.fd, data + written, total - written, seg.begin + seg.done + written);
+      if (n < 0 && errno != EINTR) {
+        SK_ERROR("Cannot write {}: {}", job.path.string(), std::strerror(errno));
+        return 0;
+      }
+      if (n == 0) {
+        SK_ERROR("Cannot write {}: no bytes written", job.path.string());
+        return 0;
+      }
+      if (n > 0) {
+        written += static_cast<size_t>(n);
+      }
+    }
+    seg.done += static_cast<std::int64_t>(total);
+    job.unsaved += static_cast<std::int64_t>(total);
+    if (job.unsaved >= PROGRESS_SAVE_BYTES) {
+      SaveProgress(job);
+    }
+    return total;
+  }
+
+  // 所有分段都结束后在文件线程上调用; 有失败时保留进度文件以便续传
+  static void FinishSegments(const std::shared_ptr<SegmentedJob>& job) {
+    bool synced = fsync(job->fd) == 0;
+    job->CloseFile();
+    if (job->failure != 0 || !synced) {
+      SaveProgress(*job);
+      job->promise.set_value({false, job->failure != 0 ? job->failure : INNER_FAIL_CODE});
+      return;
+    }
+    std::error_code ec;
+    fs::remove(ProgressPath(job->path), ec);
+    Complete(*job, true, HTTP_PARTIAL_CONTENT);
+  }
+#endif
+
   static fs::path EnsuredFilePath(const std::string& url, const fs::path& filepath) {
     bool is_directory = false;
     if (fs::exists(filepath)) {
@@ -143,7 +821,7 @@ class AsyncDownloader {
   }
 
   static std::string ExtractFilenameFromUrl(const std::string& url) {
-    return *(sk::utils::str::split(url, "/").end() - 1);
+    return std::string(sk::utils::str::split_view(url, '/').back());
   }
 
   constexpr static std::int64_t CURL_INIT_FAIL_CODE = -1;
@@ -151,4 +829,172 @@ class AsyncDownloader {
   constexpr static std::int64_t INNER_FAIL_CODE = -3;
 };
 
+/// On-disk cache of HTTP GET responses, one file per key holding the key, the ETag, the fetch time and the body.
+///
+/// Fetch() answers from the file while it is younger than ttl. An older entry is revalidated with
+/// If-None-Match, and a 304 reply only refreshes its fetch time. When the request fails, is rate limited (403 / 429)
+/// or hits a server error, a stale entry is still served. Offline mode never touches the network and answers a
+/// missing entry with OFFLINE_MISS_CODE.
+class HttpDiskCache {
+  public:
+  struct Entry {
+    std::string body;
+    std::string etag;
+    std::int64_t fetched_at{0};  // seconds since epoch
+  };
+
+  explicit HttpDiskCache(fs::path directory, std::chrono::seconds ttl = std::chrono::hours(1), bool offline = false)
+    : directory_(std::move(directory)), ttl_(ttl), offline_(offline) {}
+
+  /// $XDG_CACHE_HOME/<app>, ~/.cache/<app>, or %LOCALAPPDATA%\<app> on Windows
+  static fs::path DefaultDirectory(const std::string& app) {
+#if defined(_WIN32)
+    const char* base = std::getenv("LOCALAPPDATA");
+    return base != nullptr ? fs::path(base) / app : fs::temp_directory_path() / app;
+#else
+    if (const char* xdg = std::getenv("XDG_CACHE_HOME"); xdg != nullptr && *xdg != '\0') {
+      return fs::path(xdg) / app;
+    }
+    const char* home = std::getenv("HOME");
+    return home != nullptr ? fs::path(home) / ".cache" / app : fs::temp_directory_path() / app;
+#endif
+  }
+
+  /// ttl = 0 revalidates on every Fetch()
+  void SetTtl(std::chrono::seconds ttl) { ttl_ = ttl; }
+
+  void SetOffline(bool offline) { offline_ = offline; }
+
+  /// the key percent-encoded, so distinct keys never share a file
+  static std::string EncodeKey(const std::string& key) {
+    constexpr std::string_view HEX = "0123456789ABCDEF";
+    std::string name;
+    name.reserve(key.size());
+    for (char c : key) {
+      auto u = static_cast<unsigned char>(c);
+      if (std::isalnum(u) != 0 || c == '-' || c == '.') {
+        name += c;
+      } else {
+        name += '%';
+        name += HEX[u >> 4];
+        name += HEX[u & 0xF];
+      }
+    }
+    return name;
+  }
+
+  fs::path PathOf(const std::string& key) const { return directory_ / (EncodeKey(key) + ".cache"); }
+
+  /// an entry whose stored key differs (a case-insensitive file system folding two keys together) is a miss
+  std::optional<Entry> Load(const std::string& key) const {
+    std::ifstream in(PathOf(key), std::ios::binary);
+    if (!in.is_open()) {
+      return std::nullopt;
+    }
+    Entry entry;
+    std::string stored_key;
+    std::string fetched_at;
+    if (!std::getline(in, stored_key) || stored_key != EncodeKey(key) || !std::getline(in, entry.etag) ||
+        !std::getline(in, fetched_at)) {
+      return std::nullopt;
+    }
+    try {
+      entry.fetched_at = std::stoll(fetched_at);
+    } catch (const std::exception&) {
+      return std::nullopt;
+    }
+    std::stringstream body;
+    body << in.rdbuf();
+    entry.body = body.str();
+    return entry;
+  }
+
+  /// writes a temporary file and renames it over the old entry, so readers never see half an entry
+  bool Store(const std::string& key, const Entry& entry) const {
+    std::error_code ec;
+    fs::create_directories(directory_, ec);
+    auto path = PathOf(key);
+    auto tmp = path;
+    // thread ids are only unique within a process, so the pid keeps two processes off the same temp file
+#if defined(_WIN32)
+    tmp += ".tmp" + std::to_string(_getpid());
+#else
+    tmp += ".tmp" + std::to_string(getpid());
+#endif
+    tmp += "." + std::to_string(std::hash<std::thread::id>{}(std::this_thread::get_id()));
+    {
+      std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+      if (!out.is_open()) {
+        SK_WARN("Cannot write cache file {}", tmp.string());
+        return false;
+      }
+      out << EncodeKey(key) << '\n' << entry.etag << '\n' << entry.fetched_at << '\n' << entry.body;
+      if (!out.good()) {
+        return false;
+      }
+    }
+    fs::rename(tmp, path, ec);
+    if (ec) {
+      fs::remove(tmp, ec);
+      return false;
+    }
+    return true;
+  }
+
+  bool IsFresh(const Entry& entry) const { return Now() - entry.fetched_at < ttl_.count(); }
+
+  /// same shape as AsyncDownloader::FetchAsString; a cached or revalidated body comes back with code 200
+  std::future<std::pair<std::string, std::int64_t>> Fetch(const std::string& key, const std::string& url) const {
+    auto entry = Load(key);
+    if (offline_ || (entry.has_value() && IsFresh(*entry))) {
+      std::promise<std::pair<std::string, std::int64_t>> ready;
+      ready.set_value(entry.has_value() ? std::pair<std::string, std::int64_t>{std::move(entry->body), HTTP_OK}
+                                        : std::pair<std::string, std::int64_t>{"", AsyncDownloader::OFFLINE_MISS_CODE});
+      return ready.get_future();
+    }
+    // the callback keeps its own copy of the cache settings, the future may outlive *this
+    auto promise = std::make_shared<std::promise<std::pair<std::string, std::int64_t>>>();
+    auto fut = promise->get_future();
+    auto etag = entry.has_value() ? entry->etag : "";
+    auto on_done = [cache = *this, key, url, entry = std::move(entry), promise](AsyncDownloader::Response r) mutable {
+      promise->set_value(cache.Resolve(key, url, std::move(entry), std::move(r)));
+    };
+    AsyncDownloader::FetchConditional(url, etag, std::move(on_done));
+    return fut;
+  }
+
+  private:
+  /// turns the reply to a (conditional) request into the answer, updating the file on the way
+  std::pair<std::string, std::int64_t> Resolve(const std::string& key, const std::string& url,
+                                               std::optional<Entry> entry, AsyncDownloader::Response response) const {
+    if (response.code == HTTP_NOT_MODIFIED && entry.has_value()) {
+      entry->fetched_at = Now();
+      Store(key, *entry);
+      return {std::move(entry->body), HTTP_OK};
+    }
+    if (response.code / 100 == 2) {
+      Store(key, Entry{response.body, response.etag, Now()});
+      return {std::move(response.body), response.code};
+    }
+    bool transient = response.code < 0 || response.code == 403 || response.code == 429 || response.code >= 500;
+    if (transient && entry.has_value()) {
+      SK_WARN("Fetch {} failed with {}, serving the cached copy", url, response.code);
+      return {std::move(entry->body), HTTP_OK};
+    }
+    return {std::move(response.body), response.code};
+  }
+
+  static std::int64_t Now() {
+    return std::chrono::duration_cast<std::chrono::seconds>(std::chrono::system_clock::now().time_since_epoch())
+      .count();
+  }
+
+  constexpr static std::int64_t HTTP_OK = 200;
+  constexpr static std::int64_t HTTP_NOT_MODIFIED = 304;
+
+  fs::path directory_;
+  std::chrono::seconds ttl_;
+  bool offline_;
+};
+
 #endif  // SHUAIKAI_UTILS_NET_TOOLS_H
@@ -14,7 +14,7 @@
 
 #define GUARD_LOG sk::utils::SpinLockGuard guard(sk::utils::GlobalInfo::getInstance().globalLogSpinLock)
 
-#define REPLACED_SEP(s) sk::utils::str::replace((s), ",", ELEM_SEP)
+#define REPLACED_SEP(s) sk::utils::str::replace_all((s), ",", ELEM_SEP)
 
 /// MARK: COLOR
 
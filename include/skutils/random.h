@@ -1,11 +1,22 @@
 #ifndef SK_UTILS_RANDOM_UTILS_H
 #define SK_UTILS_RANDOM_UTILS_H
 
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <functional>
+#include <future>
+#include <limits>
 #include <random>
+#include <span>
+#include <string>
+#include <thread>
 #include <vector>
 
 #include "noncopyable.h"
 #include "printer.h"
+#include "threadpool.h"
 
 namespace sk::utils {
 
@@ -15,9 +26,303 @@ namespace sk::utils {
 #define CHARSET_NUMBER sk::utils::RandomUtil::number
 #define CHARSET_SPECIFIC sk::utils::RandomUtil::specific
 
-// Sigleton
+/// xoshiro256++ (Blackman & Vigna), a UniformRandomBitGenerator with 256 bits of state and a 2^128 jump for
+/// non-overlapping streams. Several times faster than std::mt19937_64 and much smaller.
+class Xoshiro256pp {
+  public:
+  using result_type = std::uint64_t;
+
+  explicit Xoshiro256pp(std::uint64_t seed = 0x9E3779B97F4A7C15ull) { this->seed(seed); }
+
+  static constexpr result_type min() { return 0; }
+
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  void seed(std::uint64_t seed) {
+    // expand the seed with splitmix64, as recommended by the authors
+    for (auto& word : s_) {
+      seed += 0x9E3779B97F4A7C15ull;
+      std::uint64_t z = seed;
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      word = z ^ (z >> 31);
+    }
+  }
+
+  result_type operator()() {
+    const std::uint64_t result = std::rotl(s_[0] + s_[3], 23) + s_[0];
+    const std::uint64_t t = s_[1] << 17;
+    s_[2] ^= s_[0];
+    s_[3] ^= s_[1];
+    s_[1] ^= s_[2];
+    s_[0] ^= s_[3];
+    s_[2] ^= t;
+    s_[3] = std::rotl(s_[3], 45);
+    return result;
+  }
+
+  /// equivalent to 2^128 calls of operator(), gives a new non-overlapping stream
+  void jump() {
+    constexpr std::uint64_t JUMP[] = {0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull, 0xa9582618e03fc9aaull,
+                                      0x39abdc4529b1661cull};
+    std::uint64_t t[4] = {0, 0, 0, 0};
+    for (auto j : JUMP) {
+      for (int b = 0; b < 64; ++b) {
+        if (j & (1ull << b)) {
+          for (int i = 0; i < 4; ++i) {
+            t[i] ^= s_[i];
+          }
+        }
+        (*this)();
+      }
+    }
+    for (int i = 0; i < 4; ++i) {
+      s_[i] = t[i];
+    }
+  }
+
+  /// unbiased integer in [0, range)
+  std::uint64_t bounded(std::uint64_t range);
+
+  /// uniform double in [0, 1)
+  double uniform() { return static_cast<double>((*this)() >> 11) * 0x1.0p-53; }
+
+  const std::uint64_t* state() const { return s_; }
+
+  private:
+  std::uint64_t s_[4]{};
+};
+
+/// Four xoshiro256++ streams, each one jump() apart, stepped together in struct-of-arrays layout so that the
+/// update compiles to SIMD lanes. operator() hands the lanes out one at a time for scalar consumers.
+class Xoshiro256ppX4 {
+  public:
+  using result_type = std::uint64_t;
+  static constexpr size_t LANES = 4;
+
+  explicit Xoshiro256ppX4(std::uint64_t seed) {
+    Xoshiro256pp base(seed);
+    for (size_t lane = 0; lane < LANES; ++lane) {
+      for (int w = 0; w < 4; ++w) {
+        s_[w][lane] = base.state()[w];
+      }
+      base.jump();
+    }
+  }
+
+  static constexpr result_type min() { return 0; }
+
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  /// writes one value per lane
+  void next(std::uint64_t* out) {
+    for (size_t i = 0; i < LANES; ++i) {
+      out[i] = std::rotl(s_[0][i] + s_[3][i], 23) + s_[0][i];
+    }
+    for (size_t i = 0; i < LANES; ++i) {
+      const std::uint64_t t = s_[1][i] << 17;
+      s_[2][i] ^= s_[0][i];
+      s_[3][i] ^= s_[1][i];
+      s_[1][i] ^= s_[2][i];
+      s_[0][i] ^= s_[3][i];
+      s_[2][i] ^= t;
+      s_[3][i] = std::rotl(s_[3][i], 45);
+    }
+  }
+
+  result_type operator()() {
+    if (idx_ == LANES) {
+      next(buf_);
+      idx_ = 0;
+    }
+    return buf_[idx_++];
+  }
+
+  private:
+  alignas(32) std::uint64_t s_[4][LANES];
+  alignas(32) std::uint64_t buf_[LANES]{};
+  size_t idx_{LANES};
+};
+
+namespace detail {
+
+/// unbiased integer in [0, range) from any 64-bit generator, Lemire's multiply-shift with rejection
+template <typename Gen>
+std::uint64_t lemireBounded(Gen& gen, std::uint64_t range) {
+#if defined(__SIZEOF_INT128__)
+  auto m = static_cast<unsigned __int128>(gen()) * range;
+  auto low = static_cast<std::uint64_t>(m);
+  if (low < range) {
+    const std::uint64_t threshold = (0 - range) % range;
+    while (low < threshold) {
+      m = static_cast<unsigned __int128>(gen()) * range;
+      low = static_cast<std::uint64_t>(m);
+    }
+  }
+  return static_cast<std::uint64_t>(m >> 64);
+#else
+  const std::uint64_t threshold = (0 - range) % range;
+  std::uint64_t r = 0;
+  do {
+    r = gen();
+  } while (r < threshold);
+  return r % range;
+#endif
+}
+
+/// lemireBounded on an already drawn x, with threshold = (0 - range) % range; false when x falls in the
+/// rejected band and has to be redrawn
+inline bool lemireMap(std::uint64_t x, std::uint64_t range, std::uint64_t threshold, std::uint64_t& out) {
+#if defined(__SIZEOF_INT128__)
+  auto m = static_cast<unsigned __int128>(x) * range;
+  out = static_cast<std::uint64_t>(m >> 64);
+  return static_cast<std::uint64_t>(m) >= threshold;
+#else
+  out = x % range;
+  return x >= threshold;
+#endif
+}
+
+inline double toUnitDouble(std::uint64_t x) {
+  return static_cast<double>(x >> 11) * 0x1.0p-53;
+}
+
+/// Maps random bytes onto a charset without modulo bias: bytes >= limit (the top 256 % size values) are
+/// rejected, so every char is hit by exactly 256 / size byte values. One 64-bit draw yields up to 8 chars.
+struct CharsetTable {
+  std::array<char, 256> lut{};
+  unsigned limit{0};
+
+  explicit CharsetTable(std::string_view charset) {
+    if (charset.empty() || charset.size() > 256) {
+      return;
+    }
+    limit = 256 - 256 % charset.size();
+    for (unsigned b = 0; b < limit; b += charset.size()) {
+      std::copy(charset.begin(), charset.end(), lut.begin() + b);
+    }
+  }
+
+  template <typename Gen>
+  void fill(char* out, size_t n, Gen& gen) const {
+    size_t i = 0;
+    while (i < n) {
+      auto x = gen();
+      for (int k = 0; k < 8 && i < n; ++k, x >>= 8) {
+        auto b = static_cast<unsigned>(x & 0xFF);
+        if (b < limit) {
+          out[i++] = lut[b];
+        }
+      }
+    }
+  }
+};
+
+template <typename Gen>
+void fillInts(std::span<int> out, int lower, int upper, Gen& gen) {
+  if (upper < lower) {
+    std::swap(lower, upper);
+  }
+  auto range = static_cast<std::uint64_t>(static_cast<std::int64_t>(upper) - lower) + 1;
+  for (auto& v : out) {
+    v = static_cast<int>(lower + static_cast<std::int64_t>(lemireBounded(gen, range)));
+  }
+}
+
+/// bounds a whole batch of lanes at once; only a lane that lands in the rejected band is redrawn on its own
+inline void fillInts(std::span<int> out, int lower, int upper, Xoshiro256ppX4& gen) {
+  if (upper < lower) {
+    std::swap(lower, upper);
+  }
+  auto range = static_cast<std::uint64_t>(static_cast<std::int64_t>(upper) - lower) + 1;
+  const std::uint64_t threshold = (0 - range) % range;
+  size_t i = 0;
+  alignas(32) std::uint64_t raw[Xoshiro256ppX4::LANES];
+  for (; i + Xoshiro256ppX4::LANES <= out.size(); i += Xoshiro256ppX4::LANES) {
+    gen.next(raw);
+    for (size_t k = 0; k < Xoshiro256ppX4::LANES; ++k) {
+      std::uint64_t r = 0;
+      if (!lemireMap(raw[k], range, threshold, r)) {
+        r = lemireBounded(gen, range);
+      }
+      out[i + k] = static_cast<int>(lower + static_cast<std::int64_t>(r));
+    }
+  }
+  for (; i < out.size(); ++i) {
+    out[i] = static_cast<int>(lower + static_cast<std::int64_t>(lemireBounded(gen, range)));
+  }
+}
+
+inline void fillDoubles(std::span<double> out, double lower, double upper, Xoshiro256ppX4& gen) {
+  const double width = upper - lower;
+  size_t i = 0;
+  alignas(32) std::uint64_t raw[Xoshiro256ppX4::LANES];
+  for (; i + Xoshiro256ppX4::LANES <= out.size(); i += Xoshiro256ppX4::LANES) {
+    gen.next(raw);
+    for (size_t k = 0; k < Xoshiro256ppX4::LANES; ++k) {
+      out[i + k] = toUnitDouble(raw[k]) * width + lower;
+    }
+  }
+  for (; i < out.size(); ++i) {
+    out[i] = toUnitDouble(gen()) * width + lower;
+  }
+}
+
+inline void fillChars(std::span<char> out, std::string_view charset, Xoshiro256ppX4& gen) {
+  if (charset.size() > 256) {
+    for (auto& c : out) {
+      c = charset[lemireBounded(gen, charset.size())];
+    }
+    return;
+  }
+  CharsetTable(charset).fill(out.data(), out.size(), gen);
+}
+
+/// seed of the chunk-th stream of a reproducible generation
+inline std::uint64_t streamSeed(std::uint64_t seed, std::uint64_t chunk) {
+  std::uint64_t z = seed + (chunk + 1) * 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+/// Splits `out` into fixed-size chunks, each with its own stream derived from (seed, chunk index), so the
+/// output depends only on the seed and not on how many threads run the chunks.
+template <typename T, typename ChunkFn>
+void forEachSeededChunk(std::span<T> out, std::uint64_t seed, ThreadPool* pool, ChunkFn fn) {
+  static constexpr size_t CHUNK = 1 << 16;
+  const size_t chunks = (out.size() + CHUNK - 1) / CHUNK;
+  auto run = [out, seed, &fn](size_t c) {
+    Xoshiro256ppX4 gen(streamSeed(seed, c));
+    fn(out.subspan(c * CHUNK, std::min(CHUNK, out.size() - c * CHUNK)), gen);
+  };
+  if (pool == nullptr || chunks <= 1) {
+    for (size_t c = 0; c < chunks; ++c) {
+      run(c);
+    }
+    return;
+  }
+  std::vector<std::future<void>> fus;
+  fus.reserve(chunks);
+  for (size_t c = 0; c < chunks; ++c) {
+    fus.emplace_back(pool->submit(run, c));
+  }
+  for (auto& fu : fus) {
+    fu.get();
+  }
+}
+
+}  // namespace detail
+
+inline std::uint64_t Xoshiro256pp::bounded(std::uint64_t range) {
+  return detail::lemireBounded(*this, range);
+}
+
+// Sigleton, but every thread draws from its own engine, so it is safe to use from any thread.
 class RandomUtil : NonCopyable {
   public:
+  using Engine = Xoshiro256pp;
+
   int getRandomInt(int lower = 0, int upper = 100);
   double getRandomDouble(double lower = 0.0, double upper = 100.0);
 
@@ -25,12 +330,34 @@ class RandomUtil : NonCopyable {
   std::vector<int> getRandomIntVector(size_t size, int lower = 0, int upper = 100);
   std::vector<double> getRandomDoubleVector(size_t size, double lower = 0.0, double upper = 100.0);
 
+  void fill(std::span<int> out, int lower = 0, int upper = 100);
+  void fill(std::span<double> out, double lower = 0.0, double upper = 100.0);
+
+  /// Reproducible bulk generation: the output depends only on `seed`, whether or not a pool is given and
+  /// whatever its size, so a multi-GB dataset can be regenerated exactly. Chunks run on `pool` if provided.
+  void fill(std::span<int> out, int lower, int upper, std::uint64_t seed, ThreadPool* pool = nullptr);
+  void fill(std::span<double> out, double lower, double upper, std::uint64_t seed, ThreadPool* pool = nullptr);
+  void fill(std::span<char> out, const std::string& charset, std::uint64_t seed, ThreadPool* pool = nullptr);
+
+  /// reseeds the calling thread's engine, making its following draws reproducible
+  void seed(std::uint64_t seed) { engine().seed(seed); }
+
+  /// geometric level in [1, maxLevel] with p = 1/2 (skip lists), from a single draw
+  int getRandomLevel(int maxLevel);
+
   bool coinOnce();
 
   std::string getRandomName();
   std::string getRandomEmail();
   std::string getRandomPhoneNumber();
 
+  /// the calling thread's engine
+  static Engine& engine() {
+    thread_local Engine eng{std::random_device{}() ^ (static_cast<std::uint64_t>(std::random_device{}()) << 32)
+                            ^ std::hash<std::thread::id>{}(std::this_thread::get_id())};
+    return eng;
+  }
+
   static RandomUtil& getInstance() {
     static RandomUtil pool;
     return pool;
@@ -47,9 +374,6 @@ class RandomUtil : NonCopyable {
 
   private:
   RandomUtil() = default;
-  std::mt19937 _gen{std::random_device{}()};
-  std::uniform_int_distribution<int> _intDistro{0, 10000};
-  std::uniform_real_distribution<double> _doubleDistro{0.0, 1.0};
 };
 
 inline const std::string RandomUtil::upperAlpha{"ABCDEFGHIJKLMNOPQRSTUVWXYZ"};
@@ -58,55 +382,139 @@ inline const std::string RandomUtil::number{"0123456789"};
 inline const std::string RandomUtil::specific{"~!@#$%^&*()_+-/="};
 
 inline int RandomUtil::getRandomInt(int lower, int upper) {
-  return _intDistro(_gen) % (upper - lower + 1) + lower;
+  if (upper < lower) {
+    std::swap(lower, upper);
+  }
+  auto range = static_cast<std::uint64_t>(static_cast<std::int64_t>(upper) - lower) + 1;
+  return static_cast<int>(lower + static_cast<std::int64_t>(engine().bounded(range)));
 }
 
 inline double RandomUtil::getRandomDouble(double lower, double upper) {
-  return _doubleDistro(_gen) * (upper - lower) + lower;
+  return engine().uniform() * (upper - lower) + lower;
+}
+
+inline void RandomUtil::fill(std::span<int> out, int lower, int upper) {
+  if (out.size() < 64) {
+    detail::fillInts(out, lower, upper, engine());
+    return;
+  }
+  Xoshiro256ppX4 gen(engine()());
+  detail::fillInts(out, lower, upper, gen);
+}
+
+inline void RandomUtil::fill(std::span<double> out, double lower, double upper) {
+  if (out.size() < 64) {
+    auto& eng = engine();
+    for (auto& v : out) {
+      v = eng.uniform() * (upper - lower) + lower;
+    }
+    return;
+  }
+  Xoshiro256ppX4 gen(engine()());
+  detail::fillDoubles(out, lower, upper, gen);
+}
+
+inline void RandomUtil::fill(std::span<int> out, int lower, int upper, std::uint64_t seed, ThreadPool* pool) {
+  detail::forEachSeededChunk(out, seed, pool, [lower, upper](std::span<int> chunk, Xoshiro256ppX4& gen) {
+    detail::fillInts(chunk, lower, upper, gen);
+  });
+}
+
+inline void RandomUtil::fill(std::span<double> out, double lower, double upper, std::uint64_t seed,
+                             ThreadPool* pool) {
+  detail::forEachSeededChunk(out, seed, pool, [lower, upper](std::span<double> chunk, Xoshiro256ppX4& gen) {
+    detail::fillDoubles(chunk, lower, upper, gen);
+  });
+}
+
+inline void RandomUtil::fill(std::span<char> out, const std::string& charset, std::uint64_t seed, ThreadPool* pool) {
+  if (charset.empty()) {
+    return;
+  }
+  detail::forEachSeededChunk(out, seed, pool, [&charset](std::span<char> chunk, Xoshiro256ppX4& gen) {
+    detail::fillChars(chunk, charset, gen);
+  });
 }
 
 inline std::vector<int> RandomUtil::getRandomIntVector(size_t size, int lower, int upper) {
   std::vector<int> vc(size);
-  for (int i = 0; i < size; i++) {
-    vc[i] = getRandomInt(lower, upper);
-  }
+  fill(vc, lower, upper);
   return vc;
 }
 
 inline std::vector<double> RandomUtil::getRandomDoubleVector(size_t size, double lower, double upper) {
   std::vector<double> vc(size);
-  for (int i = 0; i < size; i++) {
-    vc[i] = getRandomDouble(lower, upper);
-  }
+  fill(vc, lower, upper);
   return vc;
 }
 
+inline int RandomUtil::getRandomLevel(int maxLevel) {
+  // each trailing zero bit is one more coin flip that came up tails
+  auto level = 1 + std::countr_zero(engine()());
+  return level < maxLevel ? level : maxLevel;
+}
+
 inline std::string RandomUtil::getRandomString(size_t length, const std::string& charset) {
-  auto len = charset.length();
-  std::string ret;
-  for (int i = 0; i < length; i++) {
-    ret += charset[getRandomInt(0, len - 1)];
+  if (charset.empty()) {
+    return {};
+  }
+  std::string ret(length, '\0');
+  auto& eng = engine();
+  if (length < 64 || charset.size() > 256) {
+    for (auto& c : ret) {
+      c = charset[eng.bounded(charset.size())];
+    }
+  } else {
+    detail::CharsetTable(charset).fill(ret.data(), length, eng);
   }
   return ret;
 }
 
 inline bool RandomUtil::coinOnce() {
-  return _doubleDistro(_gen) < 0.5;
+  return (engine()() >> 63) != 0;
 }
 
 inline std::string RandomUtil::getRandomName() {
-  return sk::utils::format("{}{} {}{}", getRandomString(1, upperAlpha), getRandomString(getRandomInt(2, 5), lowerAlpha),
-                           getRandomString(1, upperAlpha), getRandomString(getRandomInt(2, 4), lowerAlpha));
+  auto& eng = engine();
+  std::string ret;
+  ret.reserve(12);
+  ret += upperAlpha[eng.bounded(upperAlpha.size())];
+  for (auto n = 2 + eng.bounded(4); n > 0; --n) {
+    ret += lowerAlpha[eng.bounded(lowerAlpha.size())];
+  }
+  ret += ' ';
+  ret += upperAlpha[eng.bounded(upperAlpha.size())];
+  for (auto n = 2 + eng.bounded(3); n > 0; --n) {
+    ret += lowerAlpha[eng.bounded(lowerAlpha.size())];
+  }
+  return ret;
 }
 
 inline std::string RandomUtil::getRandomEmail() {
-  std::vector<std::string> domin = {"cn", "us", "com", "org", "edu", "edu.cn", "edu.us"};
-  return sk::utils::format("{}@{}.{}", getRandomString(getRandomInt(5, 9), upperAlpha + lowerAlpha + number),
-                           getRandomString(getRandomInt(2, 4), lowerAlpha), domin[getRandomInt(0, domin.size() - 1)]);
+  static const std::string alnum = upperAlpha + lowerAlpha + number;
+  static const char* const domin[] = {"cn", "us", "com", "org", "edu", "edu.cn", "edu.us"};
+  auto& eng = engine();
+  std::string ret;
+  ret.reserve(24);
+  for (auto n = 5 + eng.bounded(5); n > 0; --n) {
+    ret += alnum[eng.bounded(alnum.size())];
+  }
+  ret += '@';
+  for (auto n = 2 + eng.bounded(3); n > 0; --n) {
+    ret += lowerAlpha[eng.bounded(lowerAlpha.size())];
+  }
+  ret += '.';
+  ret += domin[eng.bounded(std::size(domin))];
+  return ret;
 }
 
 inline std::string RandomUtil::getRandomPhoneNumber() {
-  return sk::utils::format("1{}", getRandomString(10, number));
+  auto& eng = engine();
+  std::string ret(11, '1');
+  for (size_t i = 1; i < ret.size(); ++i) {
+    ret[i] = number[eng.bounded(number.size())];
+  }
+  return ret;
 }
 
 }  // namespace sk::utils
@@ -0,0 +1,154 @@
+#ifndef SK_UTILS_SHA256_H
+#define SK_UTILS_SHA256_H
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace sk::utils {
+
+/// Incremental SHA-256 (FIPS 180-4), for verifying downloads against published digests.
+class Sha256 {
+  public:
+  Sha256() = default;
+
+  Sha256 &update(const void *data, size_t len) {
+    const auto *p = static_cast<const std::uint8_t *>(data);
+    total_ += len;
+    if (buffered_ > 0) {
+      size_t take = std::min(len, BLOCK - buffered_);
+      std::memcpy(buf_.data() + buffered_, p, take);
+      buffered_ += take;
+      p += take;
+      len -= take;
+      if (buffered_ < BLOCK) {
+        return *this;
+      }
+      compress(buf_.data());
+      buffered_ = 0;
+    }
+    for (; len >= BLOCK; p += BLOCK, len -= BLOCK) {
+      compress(p);
+    }
+    std::memcpy(buf_.data(), p, len);
+    buffered_ = len;
+    return *this;
+  }
+
+  Sha256 &update(std::string_view s) { return update(s.data(), s.size()); }
+
+  /// pads and finishes; the object must not be updated afterwards
+  std::array<std::uint8_t, 32> digest() {
+    const std::uint64_t bits = total_ * 8;
+    const std::uint8_t one = 0x80;
+    update(&one, 1);
+    const std::uint8_t zero = 0;
+    while (buffered_ != BLOCK - 8) {
+      update(&zero, 1);
+    }
+    std::uint8_t len[8];
+    for (int i = 0; i < 8; ++i) {
+      len[i] = static_cast<std::uint8_t>(bits >> (56 - 8 * i));
+    }
+    update(len, 8);
+    std::array<std::uint8_t, 32> out{};
+    for (int i = 0; i < 8; ++i) {
+      for (int j = 0; j < 4; ++j) {
+        out[4 * i + j] = static_cast<std::uint8_t>(h_[i] >> (24 - 8 * j));
+      }
+    }
+    return out;
+  }
+
+  /// lowercase hex, the form GitHub and sha256sum print
+  std::string hexDigest() {
+    static constexpr char HEX[] = "0123456789abcdef";
+    std::string ret;
+    for (auto b : digest()) {
+      ret += HEX[b >> 4];
+      ret += HEX[b & 0xF];
+    }
+    return ret;
+  }
+
+  static std::string of(std::string_view s) { return Sha256().update(s).hexDigest(); }
+
+  /// nullopt if the file cannot be read
+  static std::optional<std::string> ofFile(const std::filesystem::path &path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in.is_open()) {
+      return std::nullopt;
+    }
+    Sha256 sha;
+    std::vector<char> chunk(1 << 16);
+    while (in.read(chunk.data(), static_cast<std::streamsize>(chunk.size())) || in.gcount() > 0) {
+      sha.update(chunk.data(), static_cast<size_t>(in.gcount()));
+    }
+    return sha.hexDigest();
+  }
+
+  private:
+  static constexpr size_t BLOCK = 64;
+
+  static constexpr std::uint32_t K[64] = {
+    0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+    0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+    0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+    0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+    0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+    0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+    0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+    0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2};
+
+  void compress(const std::uint8_t *block) {
+    std::uint32_t w[64];
+    for (int i = 0; i < 16; ++i) {
+      w[i] = (std::uint32_t{block[4 * i]} << 24) | (std::uint32_t{block[4 * i + 1]} << 16) |
+             (std::uint32_t{block[4 * i + 2]} << 8) | std::uint32_t{block[4 * i + 3]};
+    }
+    for (int i = 16; i < 64; ++i) {
+      auto s0 = std::rotr(w[i - 15], 7) ^ std::rotr(w[i - 15], 18) ^ (w[i - 15] >> 3);
+      auto s1 = std::rotr(w[i - 2], 17) ^ std::rotr(w[i - 2], 19) ^ (w[i - 2] >> 10);
+      w[i] = w[i - 16] + s0 + w[i - 7] + s1;
+    }
+    auto [a, b, c, d, e, f, g, h] = h_;
+    for (int i = 0; i < 64; ++i) {
+      auto t1 = h + (std::rotr(e, 6) ^ std::rotr(e, 11) ^ std::rotr(e, 25)) + ((e & f) ^ (~e & g)) + K[i] + w[i];
+      auto t2 = (std::rotr(a, 2) ^ std::rotr(a, 13) ^ std::rotr(a, 22)) + ((a & b) ^ (a & c) ^ (b & c));
+      h = g;
+      g = f;
+      f = e;
+      e = d + t1;
+      d = c;
+      c = b;
+      b = a;
+      a = t1 + t2;
+    }
+    h_[0] += a;
+    h_[1] += b;
+    h_[2] += c;
+    h_[3] += d;
+    h_[4] += e;
+    h_[5] += f;
+    h_[6] += g;
+    h_[7] += h;
+  }
+
+  std::array<std::uint32_t, 8> h_{0x6a09e667, 0xbb67ae85, 0x3c6ef372, 0xa54ff53a,
+                                  0x510e527f, 0x9b05688c, 0x1f83d9ab, 0x5be0cd19};
+  std::array<std::uint8_t, BLOCK> buf_{};
+  size_t buffered_{0};
+  std::uint64_t total_{0};
+};
+
+}  // namespace sk::utils
+
+#endif  // SK_UTILS_SHA256_H
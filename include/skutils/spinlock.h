@@ -2,6 +2,7 @@
 #define SHUAIKAI_SPINLOCK_H
 
 #include <atomic>
+#include <thread>
 
 #include "noncopyable.h"
 
@@ -9,16 +10,26 @@ namespace sk::utils {
 
 class SpinLock : public NonCopyable {
   private:
+  static constexpr int SPIN_LIMIT = 64;
+
   std::atomic_flag flag;
 
   public:
   SpinLock() : flag{false} {}
 
+  /// waits on plain loads so the cache line is not bounced between waiters, and yields the core once the holder
+  /// looks descheduled, which matters as soon as there are more threads than cores
   void lock() {
-    while (flag.test_and_set(std::memory_order_acquire)) {}
+    for (int spins = 0; flag.test_and_set(std::memory_order_acquire);) {
+      while (flag.test(std::memory_order_relaxed)) {
+        if (++spins >= SPIN_LIMIT) {
+          std::this_thread::yield();
+        }
+      }
+    }
   }
 
-  void unlock() { flag.clear(); }
+  void unlock() { flag.clear(std::memory_order_release); }
 };
 
 class SpinLockGuard {
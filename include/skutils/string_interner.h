@@ -0,0 +1,137 @@
+#ifndef SK_UTILS_STRING_INTERNER_H
+#define SK_UTILS_STRING_INTERNER_H
+
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <mutex>
+#include <shared_mutex>
+#include <stdexcept>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "arena.h"
+#include "noncopyable.h"
+
+namespace sk::utils::str {
+
+/// Maps each distinct string to a dense id and one canonical copy in an arena. Views returned by view() and
+/// internView() stay valid for the interner's lifetime, and two equal strings always get the same data pointer,
+/// so interned strings can be compared and hashed by id or pointer. Not thread-safe, see ShardedInterner.
+class Interner : public NonCopyable {
+  public:
+  using Id = std::uint32_t;
+  static constexpr Id npos = std::numeric_limits<Id>::max();
+
+  /// at most maxSize distinct strings are accepted, ids are in [0, maxSize) and npos is never handed out
+  explicit Interner(size_t blockSize = Arena::DEFAULT_BLOCK_SIZE, Id maxSize = npos)
+    : arena_(blockSize), maxSize_(maxSize) {}
+
+  /// throws std::length_error once maxSize strings are interned
+  Id intern(std::string_view s) {
+    auto it = ids_.find(s);
+    if (it != ids_.end()) {
+      return it->second;
+    }
+    if (strings_.size() >= maxSize_) {
+      throw std::length_error("Interner id space exhausted");
+    }
+    auto id = static_cast<Id>(strings_.size());
+    auto stored = arena_.copy(s);
+    strings_.push_back(stored);
+    ids_.emplace(stored, id);
+    return id;
+  }
+
+  std::string_view internView(std::string_view s) { return strings_[intern(s)]; }
+
+  /// id of an already interned string, npos if unknown
+  Id find(std::string_view s) const {
+    auto it = ids_.find(s);
+    return it == ids_.end() ? npos : it->second;
+  }
+
+  std::string_view view(Id id) const { return strings_[id]; }
+
+  size_t size() const { return strings_.size(); }
+
+  bool empty() const { return strings_.empty(); }
+
+  size_t bytesUsed() const { return arena_.bytesUsed(); }
+
+  private:
+  Arena arena_;
+  Id maxSize_;
+  std::vector<std::string_view> strings_;
+  std::unordered_map<std::string_view, Id> ids_;
+};
+
+/// Thread-safe interner: strings are spread over independently locked shards by hash, and the shard index is
+/// kept in the low bits of the id.
+template <size_t Shards = 16>
+class ShardedInterner : public NonCopyable {
+  static_assert(Shards > 0 && (Shards & (Shards - 1)) == 0, "Shards should be a power of 2");
+
+  public:
+  using Id = Interner::Id;
+  static constexpr Id npos = Interner::npos;
+
+  Id intern(std::string_view s) {
+    auto idx = shardOf(s);
+    auto& shard = shards_[idx];
+    {
+      std::shared_lock<std::shared_mutex> lock(shard.mtx);
+      auto local = shard.interner.find(s);
+      if (local != npos) {
+        return toId(local, idx);
+      }
+    }
+    std::unique_lock<std::shared_mutex> lock(shard.mtx);
+    return toId(shard.interner.intern(s), idx);
+  }
+
+  /// the canonical view can be used without any lock, the arena never moves it
+  std::string_view internView(std::string_view s) { return view(intern(s)); }
+
+  Id find(std::string_view s) const {
+    auto idx = shardOf(s);
+    const auto& shard = shards_[idx];
+    std::shared_lock<std::shared_mutex> lock(shard.mtx);
+    auto local = shard.interner.find(s);
+    return local == npos ? npos : toId(local, idx);
+  }
+
+  std::string_view view(Id id) const {
+    const auto& shard = shards_[id & (Shards - 1)];
+    std::shared_lock<std::shared_mutex> lock(shard.mtx);
+    return shard.interner.view(id / Shards);
+  }
+
+  size_t size() const {
+    size_t sz = 0;
+    for (const auto& shard : shards_) {
+      std::shared_lock<std::shared_mutex> lock(shard.mtx);
+      sz += shard.interner.size();
+    }
+    return sz;
+  }
+
+  private:
+  struct alignas(64) Shard {
+    mutable std::shared_mutex mtx;
+    /// local ids stay below npos / Shards so that local * Shards + shard cannot wrap or reach npos
+    Interner interner{Arena::DEFAULT_BLOCK_SIZE, npos / static_cast<Id>(Shards)};
+  };
+
+  static size_t shardOf(std::string_view s) { return std::hash<std::string_view>{}(s) & (Shards - 1); }
+
+  static Id toId(Id local, size_t shard) { return local * static_cast<Id>(Shards) + static_cast<Id>(shard); }
+
+  std::array<Shard, Shards> shards_;
+};
+
+}  // namespace sk::utils::str
+
+#endif  // SK_UTILS_STRING_INTERNER_H
@@ -0,0 +1,424 @@
+#ifndef SK_UTILS_STRING_SEARCH_H
+#define SK_UTILS_STRING_SEARCH_H
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <initializer_list>
+#include <optional>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SK_STR_SIMD_X86 1
+#include <immintrin.h>
+#else
+#define SK_STR_SIMD_X86 0
+#endif
+
+namespace sk::utils::str {
+
+namespace detail {
+
+/// MARK: Scalar kernels
+
+inline char asciiLower(char c) {
+  return (c >= 'A' && c <= 'Z') ? static_cast<char>(c | 0x20) : c;
+}
+
+inline bool asciiIEqual(const char* a, const char* b, size_t n) {
+  for (size_t i = 0; i < n; ++i) {
+    if (asciiLower(a[i]) != asciiLower(b[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+inline size_t findScalar(const char* s, size_t n, const char* needle, size_t k) {
+  return std::string_view(s, n).find(std::string_view(needle, k));
+}
+
+inline size_t ifindScalar(const char* s, size_t n, const char* needle, size_t k) {
+  if (k > n) {
+    return std::string_view::npos;
+  }
+  for (size_t i = 0; i + k <= n; ++i) {
+    if (asciiIEqual(s + i, needle, k)) {
+      return i;
+    }
+  }
+  return std::string_view::npos;
+}
+
+/// MARK: SIMD kernels
+/// Filter candidates by comparing the first and last needle byte against a whole block at once, then verify
+/// the middle only for the few positions where both match (W. Mula, "SIMD-friendly algorithms for substring
+/// searching"). For the case-insensitive kernels letters are compared with 0x20 or-ed in, and every candidate
+/// is verified with a full ASCII case-insensitive compare.
+
+#if SK_STR_SIMD_X86
+
+inline char foldMask(char c) {
+  return ((c | 0x20) >= 'a' && (c | 0x20) <= 'z') ? 0x20 : 0;
+}
+
+inline size_t findSse2(const char* s, size_t n, const char* needle, size_t k) {
+  if (k > n) {
+    return std::string_view::npos;
+  }
+  const __m128i first = _mm_set1_epi8(needle[0]);
+  const __m128i last = _mm_set1_epi8(needle[k - 1]);
+  size_t i = 0;
+  for (; i + k - 1 + 16 <= n; i += 16) {
+    const __m128i bf = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+    const __m128i bl = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + k - 1));
+    auto mask =
+      static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, bf), _mm_cmpeq_epi8(last, bl))));
+    while (mask != 0) {
+      auto bit = static_cast<size_t>(__builtin_ctz(mask));
+      if (k <= 2 || std::memcmp(s + i + bit + 1, needle + 1, k - 2) == 0) {
+        return i + bit;
+      }
+      mask &= mask - 1;
+    }
+  }
+  auto r = findScalar(s + i, n - i, needle, k);
+  return r == std::string_view::npos ? r : r + i;
+}
+
+__attribute__((target("avx2"))) inline size_t findAvx2(const char* s, size_t n, const char* needle, size_t k) {
+  if (k > n) {
+    return std::string_view::npos;
+  }
+  const __m256i first = _mm256_set1_epi8(needle[0]);
+  const __m256i last = _mm256_set1_epi8(needle[k - 1]);
+  size_t i = 0;
+  for (; i + k - 1 + 32 <= n; i += 32) {
+    const __m256i bf = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i));
+    const __m256i bl = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + k - 1));
+    auto mask = static_cast<uint32_t>(
+      _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, bf), _mm256_cmpeq_epi8(last, bl))));
+    while (mask != 0) {
+      auto bit = static_cast<size_t>(__builtin_ctz(mask));
+      if (k <= 2 || std::memcmp(s + i + bit + 1, needle + 1, k - 2) == 0) {
+        return i + bit;
+      }
+      mask &= mask - 1;
+    }
+  }
+  auto r = findSse2(s + i, n - i, needle, k);
+  return r == std::string_view::npos ? r : r + i;
+}
+
+inline size_t ifindSse2(const char* s, size_t n, const char* needle, size_t k) {
+  if (k > n) {
+    return std::string_view::npos;
+  }
+  const __m128i foldFirst = _mm_set1_epi8(foldMask(needle[0]));
+  const __m128i foldLast = _mm_set1_epi8(foldMask(needle[k - 1]));
+  const __m128i first = _mm_set1_epi8(static_cast<char>(needle[0] | foldMask(needle[0])));
+  const __m128i last = _mm_set1_epi8(static_cast<char>(needle[k - 1] | foldMask(needle[k - 1])));
+  size_t i = 0;
+  for (; i + k - 1 + 16 <= n; i += 16) {
+    const __m128i bf = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i)), foldFirst);
+    const __m128i bl = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i + k - 1)), foldLast);
+    auto mask =
+      static_cast<uint32_t>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(first, bf), _mm_cmpeq_epi8(last, bl))));
+    while (mask != 0) {
+      auto bit = static_cast<size_t>(__builtin_ctz(mask));
+      if (asciiIEqual(s + i + bit, needle, k)) {
+        return i + bit;
+      }
+      mask &= mask - 1;
+    }
+  }
+  auto r = ifindScalar(s + i, n - i, needle, k);
+  return r == std::string_view::npos ? r : r + i;
+}
+
+__attribute__((target("avx2"))) inline size_t ifindAvx2(const char* s, size_t n, const char* needle, size_t k) {
+  if (k > n) {
+    return std::string_view::npos;
+  }
+  const __m256i foldFirst = _mm256_set1_epi8(foldMask(needle[0]));
+  const __m256i foldLast = _mm256_set1_epi8(foldMask(needle[k - 1]));
+  const __m256i first = _mm256_set1_epi8(static_cast<char>(needle[0] | foldMask(needle[0])));
+  const __m256i last = _mm256_set1_epi8(static_cast<char>(needle[k - 1] | foldMask(needle[k - 1])));
+  size_t i = 0;
+  for (; i + k - 1 + 32 <= n; i += 32) {
+    const __m256i bf = _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i)), foldFirst);
+    const __m256i bl =
+      _mm256_or_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i + k - 1)), foldLast);
+    auto mask = static_cast<uint32_t>(
+      _mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(first, bf), _mm256_cmpeq_epi8(last, bl))));
+    while (mask != 0) {
+      auto bit = static_cast<size_t>(__builtin_ctz(mask));
+      if (asciiIEqual(s + i + bit, needle, k)) {
+        return i + bit;
+      }
+      mask &= mask - 1;
+    }
+  }
+  auto r = ifindSse2(s + i, n - i, needle, k);
+  return r == std::string_view::npos ? r : r + i;
+}
+
+#endif  // SK_STR_SIMD_X86
+
+/// MARK: Dispatch
+
+using FindKernel = size_t (*)(const char*, size_t, const char*, size_t);
+
+enum class SimdLevel { SCALAR, SSE2, AVX2 };
+
+inline SimdLevel detectSimdLevel() {
+#if SK_STR_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx2")) {
+    return SimdLevel::AVX2;
+  }
+  return SimdLevel::SSE2;
+#else
+  return SimdLevel::SCALAR;
+#endif
+}
+
+inline SimdLevel simdLevel() {
+  static const SimdLevel level = detectSimdLevel();
+  return level;
+}
+
+inline FindKernel findKernel(SimdLevel level) {
+  switch (level) {
+#if SK_STR_SIMD_X86
+    case SimdLevel::AVX2: return findAvx2;
+    case SimdLevel::SSE2: return findSse2;
+#endif
+    default: return findScalar;
+  }
+}
+
+inline FindKernel ifindKernel(SimdLevel level) {
+  switch (level) {
+#if SK_STR_SIMD_X86
+    case SimdLevel::AVX2: return ifindAvx2;
+    case SimdLevel::SSE2: return ifindSse2;
+#endif
+    default: return ifindScalar;
+  }
+}
+
+}  // namespace detail
+
+/// MARK: Substring search
+
+/// Same result as std::string_view::find, using the widest kernel the CPU supports.
+inline size_t find(std::string_view str, std::string_view substr, size_t pos = 0) {
+  if (pos > str.length()) {
+    return std::string_view::npos;
+  }
+  if (substr.empty()) {
+    return pos;
+  }
+  if (substr.length() == 1) {
+    const auto* hit = static_cast<const char*>(std::memchr(str.data() + pos, substr[0], str.length() - pos));
+    return hit == nullptr ? std::string_view::npos : static_cast<size_t>(hit - str.data());
+  }
+  static const auto kernel = detail::findKernel(detail::simdLevel());
+  auto r = kernel(str.data() + pos, str.length() - pos, substr.data(), substr.length());
+  return r == std::string_view::npos ? r : r + pos;
+}
+
+/// ASCII case-insensitive find
+inline size_t ifind(std::string_view str, std::string_view substr, size_t pos = 0) {
+  if (pos > str.length()) {
+    return std::string_view::npos;
+  }
+  if (substr.empty()) {
+    return pos;
+  }
+  static const auto kernel = detail::ifindKernel(detail::simdLevel());
+  auto r = kernel(str.data() + pos, str.length() - pos, substr.data(), substr.length());
+  return r == std::string_view::npos ? r : r + pos;
+}
+
+inline bool icontains(std::string_view str, std::string_view substr) {
+  return ifind(str, substr) != std::string_view::npos;
+}
+
+/// non-overlapping, case-insensitive occurrences
+inline int icount(std::string_view str, std::string_view substr) {
+  if (substr.empty()) {
+    return 0;
+  }
+  int cnt = 0;
+  size_t pos = 0;
+  while ((pos = ifind(str, substr, pos)) != std::string_view::npos) {
+    ++cnt;
+    pos += substr.length();
+  }
+  return cnt;
+}
+
+/// MARK: AhoCorasick
+
+/// Matches many patterns in one pass over the text. Bytes are compressed into the classes that actually appear
+/// in the patterns, so the DFA table stays small enough to live in L1 for typical keyword/extension lists.
+class AhoCorasick {
+  public:
+  struct Match {
+    size_t pos;      // start of the match in the text
+    size_t pattern;  // index of the matched pattern
+  };
+
+  template <typename StringRange>
+  explicit AhoCorasick(const StringRange& patterns, bool ignoreCase = false) : ignoreCase_(ignoreCase) {
+    for (const auto& p : patterns) {
+      patterns_.emplace_back(p);
+    }
+    build();
+  }
+
+  AhoCorasick(std::initializer_list<std::string_view> patterns, bool ignoreCase = false) : ignoreCase_(ignoreCase) {
+    for (const auto& p : patterns) {
+      patterns_.emplace_back(p);
+    }
+    build();
+  }
+
+  size_t size() const { return patterns_.size(); }
+
+  const std::string& pattern(size_t idx) const { return patterns_[idx]; }
+
+  /// calls fn(Match) for every (overlapping) occurrence, in order of match end; stops early if fn returns false
+  template <typename F>
+  void forEach(std::string_view text, F&& fn) const {
+    int32_t state = 0;
+    for (size_t i = 0; i < text.length(); ++i) {
+      state = next(state, text[i]);
+      for (int32_t s = hasOutput_[state] ? state : -1; s >= 0; s = dictLink_[s]) {
+        if (output_[s] >= 0) {
+          auto id = static_cast<size_t>(output_[s]);
+          if (!fn(Match{i + 1 - patterns_[id].length(), id})) {
+            return;
+          }
+        }
+      }
+    }
+  }
+
+  std::optional<Match> find(std::string_view text) const {
+    std::optional<Match> ret;
+    forEach(text, [&ret](const Match& m) {
+      ret = m;
+      return false;
+    });
+    return ret;
+  }
+
+  bool contains(std::string_view text) const { return find(text).has_value(); }
+
+  size_t count(std::string_view text) const {
+    size_t cnt = 0;
+    forEach(text, [&cnt](const Match&) { return ++cnt, true; });
+    return cnt;
+  }
+
+  /// whether any pattern is a suffix of text, e.g. matching a file name against an extension list
+  bool endsWithAny(std::string_view text) const {
+    int32_t state = 0;
+    for (char c : text) {
+      state = next(state, c);
+    }
+    return hasOutput_[state] != 0;
+  }
+
+  private:
+  int32_t next(int32_t state, char c) const { return delta_[state * classes_ + classOf_[static_cast<uint8_t>(c)]]; }
+
+  void build() {
+    // byte classes: 0 is every byte never seen in a pattern
+    for (const auto& p : patterns_) {
+      for (char c : p) {
+        auto b = static_cast<uint8_t>(ignoreCase_ ? detail::asciiLower(c) : c);
+        if (classOf_[b] == 0) {
+          classOf_[b] = static_cast<uint16_t>(classes_++);
+        }
+      }
+    }
+    if (ignoreCase_) {
+      for (int c = 'A'; c <= 'Z'; ++c) {
+        classOf_[c] = classOf_[c | 0x20];
+      }
+    }
+
+    // trie
+    delta_.assign(classes_, -1);
+    output_.assign(1, -1);
+    for (size_t id = 0; id < patterns_.size(); ++id) {
+      if (patterns_[id].empty()) {
+        continue;
+      }
+      int32_t state = 0;
+      for (char c : patterns_[id]) {
+        auto idx = state * classes_ + classOf_[static_cast<uint8_t>(c)];
+        if (delta_[idx] < 0) {
+          delta_[idx] = static_cast<int32_t>(output_.size());
+          output_.push_back(-1);
+          delta_.resize(delta_.size() + classes_, -1);
+        }
+        state = delta_[idx];
+      }
+      if (output_[state] < 0) {
+        output_[state] = static_cast<int32_t>(id);
+      }
+    }
+
+    // failure links, turned into a complete DFA in BFS order
+    auto states = output_.size();
+    std::vector<int32_t> fail(states, 0);
+    dictLink_.assign(states, -1);
+    hasOutput_.assign(states, 0);
+    std::queue<int32_t> q;
+    for (size_t c = 0; c < classes_; ++c) {
+      auto& slot = delta_[c];
+      if (slot < 0) {
+        slot = 0;
+      } else {
+        q.push(slot);
+      }
+    }
+    while (!q.empty()) {
+      auto s = q.front();
+      q.pop();
+      auto f = fail[s];
+      dictLink_[s] = output_[f] >= 0 ? f : dictLink_[f];
+      hasOutput_[s] = static_cast<uint8_t>(output_[s] >= 0 || dictLink_[s] >= 0);
+      for (size_t c = 0; c < classes_; ++c) {
+        auto& slot = delta_[s * classes_ + c];
+        if (slot < 0) {
+          slot = delta_[f * classes_ + c];
+        } else {
+          fail[slot] = delta_[f * classes_ + c];
+          q.push(slot);
+        }
+      }
+    }
+  }
+
+  bool ignoreCase_;
+  std::vector<std::string> patterns_;
+  std::array<uint16_t, 256> classOf_{};
+  size_t classes_{1};
+  std::vector<int32_t> delta_;     // states x classes_
+  std::vector<int32_t> output_;    // pattern ending exactly at the state, -1 if none
+  std::vector<int32_t> dictLink_;  // nearest proper suffix state with an output
+  std::vector<uint8_t> hasOutput_;
+};
+
+}  // namespace sk::utils::str
+
+#endif  // SK_UTILS_STRING_SEARCH_H
@@ -2,13 +2,22 @@
 #define SK_UTILS_STRING_UTILS_H
 
 #include <algorithm>
+#include <array>
 #include <cctype>
+#include <cstring>
 #include <functional>
+#include <initializer_list>
+#include <iterator>
 #include <regex>
 #include <string>
 #include <string_view>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
 #include <vector>
 
+#include "string_search.h"
+
 namespace sk::utils::str {
 inline bool startWith(std::string_view str, std::string_view prefix) {
 #if __cplusplus >= 202002L
@@ -58,13 +67,26 @@ inline bool isspace(std::string_view s) {
 }
 
 inline bool contains(std::string_view str, std::string_view substr) {
-  return str.find(substr) != std::string::npos;
+  return find(str, substr) != std::string::npos;
 }
 
+/// non-overlapping occurrences; an empty substr counts as 0, like replace_all ignores an empty `from`
 inline int constexpr count(std::string_view str, std::string_view substr) {
   int cnt = 0;
   size_t pos = 0;
   auto sublength = substr.length();
+  if (sublength == 0) {
+    return 0;
+  }
+#ifdef __cpp_lib_is_constant_evaluated
+  if (!std::is_constant_evaluated()) {
+    while ((pos = find(str, substr, pos)) != std::string::npos) {
+      cnt++;
+      pos += sublength;
+    }
+    return cnt;
+  }
+#endif
   while ((pos = str.find(substr, pos)) != std::string::npos) {
     cnt++;
     pos += sublength;
@@ -72,86 +94,291 @@ inline int constexpr count(std::string_view str, std::string_view substr) {
   return cnt;
 }
 
-template <typename IterMoter>
-inline auto _split(std::string_view str, IterMoter itermoter) -> typename std::enable_if<
-  std::is_same<decltype(itermoter(std::declval<std::string_view>())), std::pair<bool, decltype(str.length())>>::value,
-  std::vector<std::string>>::type {
-  auto len = str.length();
-  decltype(len) idx = 0;
-  decltype(len) starter = 0;
-  std::vector<std::string> ret;
-  while (idx < len) {
-    auto [isDelim, idxInstance] = itermoter(str.substr(idx, len - idx + 1));
-    if (isDelim) {
-      if (idx > starter) {
-        ret.emplace_back(str.substr(starter, idx - starter));
+/// MARK: SplitView
+
+/// Finders return the {position, length} of the next delimiter at or after `pos`, or {npos, 0} if there is none.
+
+struct CharFinder {
+  char delim;
+
+  std::pair<size_t, size_t> operator()(std::string_view str, size_t pos) const {
+    // memchr is vectorized by every mainstream libc
+    const auto* hit = static_cast<const char*>(std::memchr(str.data() + pos, delim, str.length() - pos));
+    if (hit == nullptr) {
+      return {std::string_view::npos, 0};
+    }
+    return {static_cast<size_t>(hit - str.data()), 1};
+  }
+};
+
+struct StringFinder {
+  std::string_view delim;
+
+  std::pair<size_t, size_t> operator()(std::string_view str, size_t pos) const {
+    if (delim.empty()) {
+      return {std::string_view::npos, 0};
+    }
+    return {str.find(delim, pos), delim.length()};
+  }
+};
+
+struct CharSetFinder {
+  std::array<bool, 256> table{};
+
+  template <typename CharRange>
+  explicit CharSetFinder(const CharRange& delims) {
+    for (char c : delims) {
+      table[static_cast<unsigned char>(c)] = true;
+    }
+  }
+
+  std::pair<size_t, size_t> operator()(std::string_view str, size_t pos) const {
+    for (auto len = str.length(); pos < len; ++pos) {
+      if (table[static_cast<unsigned char>(str[pos])]) {
+        return {pos, 1};
+      }
+    }
+    return {std::string_view::npos, 0};
+  }
+};
+
+struct StringSetFinder {
+  std::vector<std::string> delims;  // sorted descending, so "llo" is tried before "ll"
+  std::array<bool, 256> first{};
+
+  template <typename StringRange>
+  explicit StringSetFinder(const StringRange& ds) {
+    for (const auto& d : ds) {
+      if (!std::string_view(d).empty()) {
+        delims.emplace_back(d);
       }
-      idx += idxInstance;
-      starter = idx;
-    } else {
-      ++idx;
+    }
+    std::sort(delims.begin(), delims.end(), std::greater<>());
+    for (const auto& d : delims) {
+      first[static_cast<unsigned char>(d[0])] = true;
     }
   }
-  if (starter < len) {
-    ret.emplace_back(str.substr(starter, len - starter + 1));
+
+  std::pair<size_t, size_t> operator()(std::string_view str, size_t pos) const {
+    for (auto len = str.length(); pos < len; ++pos) {
+      if (!first[static_cast<unsigned char>(str[pos])]) {
+        continue;
+      }
+      auto rest = str.substr(pos);
+      for (const auto& d : delims) {
+        if (startWith(rest, d)) {
+          return {pos, d.length()};
+        }
+      }
+    }
+    return {std::string_view::npos, 0};
   }
-  return ret;
+};
+
+/// Lazy splitter yielding non-empty std::string_view tokens, same tokens as `split` but without any allocation.
+/// The viewed string must outlive the view and its iterators.
+template <typename Finder>
+class SplitView {
+  public:
+  class iterator {
+    public:
+    using iterator_category = std::forward_iterator_tag;
+    using value_type = std::string_view;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const std::string_view*;
+    using reference = const std::string_view&;
+
+    iterator() = default;
+
+    iterator(const SplitView* view, size_t pos) : view_(view), next_(pos), done_(false) { advance(); }
+
+    reference operator*() const { return token_; }
+
+    pointer operator->() const { return &token_; }
+
+    iterator& operator++() {
+      advance();
+      return *this;
+    }
+
+    iterator operator++(int) {
+      auto tmp = *this;
+      advance();
+      return tmp;
+    }
+
+    bool operator==(const iterator& o) const { return done_ == o.done_ && (done_ || next_ == o.next_); }
+
+    bool operator!=(const iterator& o) const { return !(*this == o); }
+
+    private:
+    void advance() {
+      auto str = view_->str_;
+      auto len = str.length();
+      while (next_ < len) {
+        auto [pos, dlen] = view_->finder_(str, next_);
+        if (pos == std::string_view::npos) {
+          token_ = str.substr(next_);
+          next_ = len;
+          return;
+        }
+        auto start = next_;
+        next_ = pos + dlen;
+        if (pos > start) {
+          token_ = str.substr(start, pos - start);
+          return;
+        }
+      }
+      done_ = true;
+    }
+
+    const SplitView* view_{nullptr};
+    size_t next_{0};
+    std::string_view token_;
+    bool done_{true};
+  };
+
+  SplitView(std::string_view str, Finder finder) : str_(str), finder_(std::move(finder)) {}
+
+  iterator begin() const { return iterator(this, 0); }
+
+  iterator end() const { return iterator(); }
+
+  bool empty() const { return begin() == end(); }
+
+  std::string_view front() const { return *begin(); }
+
+  /// last token, std::string_view{} if there is none
+  std::string_view back() const {
+    std::string_view last;
+    for (auto token : *this) {
+      last = token;
+    }
+    return last;
+  }
+
+  std::vector<std::string> to_vector() const {
+    std::vector<std::string> ret;
+    for (auto token : *this) {
+      ret.emplace_back(token);
+    }
+    return ret;
+  }
+
+  private:
+  std::string_view str_;
+  Finder finder_;
+};
+
+inline SplitView<CharFinder> split_view(std::string_view str, char delim) {
+  return {str, CharFinder{delim}};
+}
+
+inline SplitView<StringFinder> split_view(std::string_view str, std::string_view delim) {
+  return {str, StringFinder{delim}};
+}
+
+inline SplitView<CharSetFinder> split_view(std::string_view str, std::initializer_list<char> delims) {
+  return {str, CharSetFinder(delims)};
+}
+
+inline SplitView<CharSetFinder> split_view(std::string_view str, const std::vector<char>& delims) {
+  return {str, CharSetFinder(delims)};
+}
+
+inline SplitView<StringSetFinder> split_view(std::string_view str, std::initializer_list<std::string_view> delims) {
+  return {str, StringSetFinder(delims)};
+}
+
+inline SplitView<StringSetFinder> split_view(std::string_view str, const std::vector<std::string>& delims) {
+  return {str, StringSetFinder(delims)};
 }
 
+/// MARK: split
+
 inline std::vector<std::string> split(std::string_view str, char delim) {
-  return _split(str, [&delim](std::string_view substr) -> std::pair<bool, decltype(str.length())> {
-    if (substr[0] == delim) {
-      return {true, 1};
-    }
-    return {false, 0};
-  });
+  return split_view(str, delim).to_vector();
 }
 
 inline std::vector<std::string> split(std::string_view str, std::string_view delim) {
-  return _split(str, [&](std::string_view substr) -> std::pair<bool, decltype(str.length())> {
-    if (startWith(substr, delim)) {
-      return {true, delim.length()};
-    }
-    return {false, 0};
-  });
+  return split_view(str, delim).to_vector();
 }
 
-inline std::vector<std::string> split(std::string_view str, std::vector<std::string> delims) {
-  std::sort(delims.begin(), delims.end(), std::greater<>());
-  return _split(str, [&](std::string_view substr) -> std::pair<bool, decltype(str.length())> {
-    for (const auto& delim : delims) {
-      if (startWith(substr, delim)) {
-        return {true, delim.length()};
-      }
-    }
-    return {false, 0};
-  });
+inline std::vector<std::string> split(std::string_view str, const std::vector<std::string>& delims) {
+  return split_view(str, delims).to_vector();
 }
 
-inline std::vector<std::string> split(std::string_view str, std::vector<char> delims) {
-  std::sort(delims.begin(), delims.end(), std::greater<>());
-  return _split(str, [&](std::string_view substr) -> std::pair<bool, decltype(str.length())> {
-    for (char c : delims) {
-      if (substr[0] == c) {
-        return {true, 1};
-      }
+inline std::vector<std::string> split(std::string_view str, const std::vector<char>& delims) {
+  return split_view(str, delims).to_vector();
+}
+
+/// MARK: replace & trim
+
+/// Literal replacement of every non-overlapping `from`, in one pass and one allocation.
+inline std::string replace_all(std::string_view str, std::string_view from, std::string_view to) {
+  if (from.empty()) {
+    return std::string(str);
+  }
+  std::string ret;
+  if (to.length() <= from.length()) {
+    ret.reserve(str.length());
+  } else {
+    ret.reserve(str.length() + count(str, from) * (to.length() - from.length()));
+  }
+  size_t last = 0;
+  for (auto pos = str.find(from); pos != std::string_view::npos; pos = str.find(from, last)) {
+    ret.append(str.data() + last, pos - last).append(to);
+    last = pos + from.length();
+  }
+  ret.append(str.data() + last, str.length() - last);
+  return ret;
+}
+
+/// Compiled patterns are cached per thread, so hot loops only pay std::regex construction once.
+inline const std::regex& cached_regex(const std::string& pattern) {
+  constexpr size_t max_cached_patterns = 64;
+  thread_local std::unordered_map<std::string, std::regex> cache;
+  auto it = cache.find(pattern);
+  if (it == cache.end()) {
+    if (cache.size() >= max_cached_patterns) {
+      cache.clear();
     }
-    return {false, 0};
-  });
+    it = cache.emplace(pattern, std::regex(pattern)).first;
+  }
+  return it->second;
+}
+
+inline std::string replace_regex(const std::string& str, const std::string& pattern, const std::string& replacer) {
+  return std::regex_replace(str, cached_regex(pattern), replacer);
 }
 
+/// `pattern` is a regex, see replace_all for literal replacement
 inline std::string replace(const std::string& str, const std::string& pattern, const std::string& replacer) {
-  std::regex re(pattern);
-  return std::regex_replace(str, re, replacer);
+  return replace_regex(str, pattern, replacer);
 }
 
 inline std::string replace(std::string&& str, std::string&& pattern, std::string&& replacer) {
-  std::regex re(pattern);
-  return std::regex_replace(str, re, replacer);
+  return replace_regex(str, pattern, replacer);
+}
+
+/// trim_* strip any of the chars in `trimer` from the ends only, interior matches are kept.
+inline std::string trim_left(std::string_view str, std::string_view trimer = " ") {
+  auto l = str.find_first_not_of(trimer);
+  return l == std::string_view::npos ? std::string{} : std::string(str.substr(l));
 }
 
-inline std::string trim(const std::string str, const std::string trimer = " ") {
-  return replace(str, trimer, "");
+inline std::string trim_right(std::string_view str, std::string_view trimer = " ") {
+  auto r = str.find_last_not_of(trimer);
+  return r == std::string_view::npos ? std::string{} : std::string(str.substr(0, r + 1));
+}
+
+inline std::string trim(std::string_view str, std::string_view trimer = " ") {
+  auto l = str.find_first_not_of(trimer);
+  if (l == std::string_view::npos) {
+    return {};
+  }
+  auto r = str.find_last_not_of(trimer);
+  return std::string(str.substr(l, r - l + 1));
 }
 
 inline std::string dirname(std::string_view filename) {
@@ -163,7 +390,7 @@ inline std::string dirname(std::string_view filename) {
 }
 
 inline std::string basename(std::string_view filename) {
-  return *(split(filename, std::vector<std::string>{"/", "\\"}).end() - 1);
+  return std::string(split_view(filename, {'/', '\\'}).back());
 }
 
 inline std::string basenameWithoutExt(std::string_view filename) {
@@ -175,14 +402,20 @@ inline std::string expandUser(std::string_view path) {
   if (!startWith(path, "~")) {
     return std::string(path);
   }
-  char* home_dir = nullptr;
+  const char* home_dir = nullptr;
 #if defined(_WIN32)
   home_dir = getenv("USERPROFILE");
 #else
   home_dir = getenv("HOME");
 #endif
+  if (home_dir == nullptr) {
+    return std::string(path);
+  }
 
-  return replace(std::string(path), "~", std::string(home_dir));
+  std::string_view home(home_dir);
+  std::string ret;
+  ret.reserve(home.length() + path.length() - 1);
+  return ret.append(home).append(path.substr(1));
 }
 
 }  // namespace sk::utils::str
@@ -1,11 +1,14 @@
 #include <algorithm>
+#include <cstdint>
 #include <filesystem>
 #include <functional>
 #include <future>
 #include <string>
+#include <system_error>
 #include <vector>
 
 #include "skutils/argparser.h"
+#include "skutils/containers/flat_hash_map.h"
 #include "skutils/containers/topk_queue.h"
 #include "skutils/printer.h"
 #include "skutils/threadpool.h"
@@ -17,19 +20,16 @@ inline bool validate(const fs::path &p) {
   return fs::exists(p);
 }
 
-struct CompFileSize {
-  bool operator()(const fs::path &p1, const fs::path &p2) const {
-    if (!validate(p1)) {
-      return true;
-    }
-    if (!validate(p2)) {
-      return false;
-    }
-    return fs::file_size(p1) < fs::file_size(p2);
+/// stat once per file, the queue compares the cached sizes; a file that vanished counts as empty
+struct FileSize {
+  std::uintmax_t operator()(const fs::path &p) const {
+    std::error_code ec;
+    auto sz = fs::file_size(p, ec);
+    return ec ? 0 : sz;
   }
 };
 
-using QueueType = sk::utils::dts::topbottomk_queue<fs::path, CompFileSize>;
+using QueueType = sk::utils::dts::topbottomk_queue<fs::path, FileSize>;
 
 std::pair<double, std::string> format_size(const size_t sz) {
   if (sz < 1024) {
@@ -44,15 +44,6 @@ std::pair<double, std::string> format_size(const size_t sz) {
   return {((double)sz / (1024.0 * 1024.0 * 1024.0)), "GB"};
 }
 
-std::pair<double, std::string> format_size(const fs::path &path) {
-  try {
-    return format_size(fs::file_size(path));
-  } catch (const fs::filesystem_error &e) {
-    SK_ERROR("Error: {}\n path1:{}\n path2:{}\n", e.what(), e.path1().generic_string(), e.path2().generic_string());
-    return {0.1, "ERROR"};
-  }
-}
-
 void topN(const fs::path &path, QueueType &top, const std::function<bool(const fs::path &)> &filter) {
   if (!validate(path)) {
     return;
@@ -156,14 +147,11 @@ int main(int argc, char **argv) {
       }
     });
 
-    std::function<bool(const fs::path &p)> filter = [&extentions](const fs::path &p) -> bool {
-      if (extentions.empty()) {
-        return true;
-      }
-      if (std::find(extentions.begin(), extentions.end(), p.extension().generic_string()) != extentions.end()) {
-        return true;
-      }
-      return false;
+    // exact match on path::extension(), one hash lookup instead of comparing against each extension in turn
+    su::dts::flat_hash_set<std::string> ext_set;
+    ext_set.insert(extentions.begin(), extentions.end());
+    std::function<bool(const fs::path &p)> filter = [&ext_set](const fs::path &p) -> bool {
+      return ext_set.empty() || ext_set.contains(p.extension().generic_string());
     };
 
     int top_k = std::get<int>(parser.get_value("-t").value_or(0));
@@ -176,25 +164,25 @@ int main(int argc, char **argv) {
     }
 
     if (top_k > 0) {
-      auto top_k_files = heap.pop_top();
+      auto top_k_files = heap.pop_top_with_keys();
       top_k = (top_k <= top_k_files.size() ? top_k : top_k_files.size());
       std::cout << sk::utils::colorful_format("Lagest {} Files in {}\n", top_k, paths);
       for (int i = 0; i < top_k; i++) {
-        auto szp = format_size(top_k_files[i]);
+        auto szp = format_size(static_cast<size_t>(top_k_files[i].first));
         std::cout << sk::utils::colorful_format("[{} {}] <= {}\n", szp.first, szp.second,
-                                                top_k_files[i].generic_string());
+                                                top_k_files[i].second.generic_string());
       }
       std::cout << "\n";
     }
 
     if (bottom_k > 0) {
-      auto bottom_k_files = heap.pop_bottom();
+      auto bottom_k_files = heap.pop_bottom_with_keys();
       bottom_k = (bottom_k <= bottom_k_files.size() ? bottom_k : bottom_k_files.size());
       std::cout << sk::utils::colorful_format("Smallest {} Files in {}\n", bottom_k, paths);
       for (int i = 0; i < bottom_k; i++) {
-        auto szp = format_size(bottom_k_files[i]);
+        auto szp = format_size(static_cast<size_t>(bottom_k_files[i].first));
         std::cout << sk::utils::colorful_format("[{} {}] <= {}\n", szp.first, szp.second,
-                                                bottom_k_files[i].generic_string());
+                                                bottom_k_files[i].second.generic_string());
       }
       std::cout << "\n";
     }
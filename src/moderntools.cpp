@@ -2,6 +2,7 @@
 #include <curl/easy.h>
 
 #include <algorithm>
+#include <chrono>
 #include <exception>
 #include <filesystem>
 #include <fstream>
@@ -22,6 +23,7 @@
 #include "skutils/net_tools.h"
 #include "skutils/noncopyable.h"
 #include "skutils/printer.h"
+#include "skutils/string_search.h"
 #include "skutils/string_utils.h"
 
 using Json = nlohmann::json;
@@ -84,6 +86,8 @@ struct ToolInfo : public NonCopyable {
 
   std::future<std::pair<std::string, std::int64_t>> release_future;
   std::map<std::string, std::future<std::pair<bool, std::int64_t>>> download_links;
+  // "sha256:<hex>" published by GitHub for newer assets, keyed by download link
+  std::map<std::string, std::string> digests;
 
   explicit ToolInfo(const std::string& repo_name)
     : repo(repo_name),
@@ -102,24 +106,31 @@ struct ToolInfo : public NonCopyable {
     }
   }
 
-  static std::string FromRepoToName(const std::string& repo) { return ks::str::split(repo, "/")[1]; }
+  static std::string FromRepoToName(const std::string& repo) {
+    auto tokens = ks::str::split_view(repo, '/');
+    auto it = tokens.begin();
+    if (it == tokens.end() || ++it == tokens.end()) {
+      return repo;
+    }
+    return std::string(*it);
+  }
 
   static std::string GenerateApiAddress(const std::string& repo) {
-    return ks::format("https://api.github.com/repos/{}/releases/latest", ks::str::trim(ks::str::trim(repo, "\"")));
+    return ks::format("https://api.github.com/repos/{}/releases/latest", ks::str::trim(repo, "\" "));
   }
 
   static std::string GenerateBrowserLink(const std::string& repo) {
-    return ks::format("https://github.com/{}/releases", ks::str::trim(ks::str::trim(repo, "\"")));
+    return ks::format("https://github.com/{}/releases", ks::str::trim(repo, "\" "));
   }
 
   static std::string ExtractFullReleaseNameFromUrl(const std::string& url) {
-    return *(ks::str::split(url, "/").end() - 1);
+    return std::string(ks::str::split_view(url, '/').back());
   }
 };
 
 class DownloadTools {
   public:
-  explicit DownloadTools();
+  explicit DownloadTools(HttpDiskCache release_cache = HttpDiskCache(HttpDiskCache::DefaultDirectory("moderntools")));
 
   void DownloadAll(const fs::path& directory);
 
@@ -132,7 +143,7 @@ class DownloadTools {
   void ShowLatestVersion();
 
   private:
-  static void AsyncFetchLatestReleaseInfo(std::vector<std::reference_wrapper<ToolInfo>>& tools);
+  void AsyncFetchLatestReleaseInfo(std::vector<std::reference_wrapper<ToolInfo>>& tools);
 
   static void AsyncDownloadToDirectory(std::vector<std::reference_wrapper<ToolInfo>>& tools, const fs::path& dir);
 
@@ -144,6 +155,9 @@ class DownloadTools {
     return !ks::str::contains(github_release_name, "musl");
   }
 
+  // Release JSON keyed by repo, so repeated runs skip (or only revalidate) the GitHub API calls
+  HttpDiskCache release_cache_;
+
   std::vector<ToolInfo> tools_;
 
   // Just for a uniform api. Use tools_ cannot perform some filter on tool.name
@@ -152,7 +166,7 @@ class DownloadTools {
 
 /// MARK: Implementations
 
-DownloadTools::DownloadTools() {
+DownloadTools::DownloadTools(HttpDiskCache release_cache) : release_cache_(std::move(release_cache)) {
   /** NOTE:
       The reason why the release information is not obtained asynchronously in the constructor
       is to prevent the information of all tools from being obtained
@@ -168,8 +182,9 @@ DownloadTools::DownloadTools() {
 
 void DownloadTools::AsyncFetchLatestReleaseInfo(std::vector<std::reference_wrapper<ToolInfo>>& tools) {
   // (1) Async Get Release Information
-  std::for_each(tools.begin(), tools.end(),
-                [](ToolInfo& tool) { tool.release_future = AsyncDownloader::FetchAsString(tool.api_address); });
+  std::for_each(tools.begin(), tools.end(), [this](ToolInfo& tool) {
+    tool.release_future = release_cache_.Fetch(tool.repo, tool.api_address);
+  });
 
   // (2) Sync Extract Download Link From Release Information
   std::for_each(tools.begin(), tools.end(), [](ToolInfo& tool) { SyncAndExtractLinkFromRelease(tool); });
@@ -180,7 +195,9 @@ void DownloadTools::AsyncDownloadToDirectory(std::vector<std::reference_wrapper<
   // (3) Async Start Download Task
   std::for_each(tools.begin(), tools.end(), [&directory](ToolInfo& tool) {
     for (auto& it : tool.download_links) {
-      it.second = AsyncDownloader::DownloadToFile(it.first, directory);
+      auto digest = tool.digests.find(it.first);
+      it.second = AsyncDownloader::DownloadSegmented(
+        it.first, directory, {.sha256 = digest == tool.digests.end() ? std::string{} : digest->second});
     }
   });
 
@@ -191,14 +208,22 @@ void DownloadTools::AsyncDownloadToDirectory(std::vector<std::reference_wrapper<
 
 void DownloadTools::SyncAndExtractLinkFromRelease(ToolInfo& tool) {
   auto [content, response_code] = tool.release_future.get();
+  if (response_code == AsyncDownloader::OFFLINE_MISS_CODE) {
+    ks::println("{}:{}", WITH_RED("[OFFLINE]"),
+                ks::format("{} {}.", WITH_BLUE("No cached release info of"), WITH_PURPLE(tool.name)));
+    return;
+  }
   switch (AsyncDownloader::CheckHttpStatusCode(response_code)) {
     case AsyncDownloader::STATUS::HTTP_SUCCESS: {
       auto json = Json::parse(content);
+      // one pass over each asset name for all suffixes
+      ks::str::AhoCorasick suffix_matcher(tool.suffixes);
       for (const auto& asset : json["assets"]) {
-        for (const auto& suffix : tool.suffixes) {
-          auto release_name = asset.at("name").get<std::string>();
-          if (ks::str::endWith(release_name, suffix) && ExtraFileNameFilter(release_name)) {
-            tool.download_links.emplace(asset.at("browser_download_url"), std::future<std::pair<bool, std::int64_t>>{});
+        auto release_name = asset.at("name").get<std::string>();
+        if (suffix_matcher.endsWithAny(release_name) && ExtraFileNameFilter(release_name)) {
+          tool.download_links.emplace(asset.at("browser_download_url"), std::future<std::pair<bool, std::int64_t>>{});
+          if (asset.contains("digest") && asset["digest"].is_string()) {
+            tool.digests.emplace(asset.at("browser_download_url"), asset["digest"]);
           }
         }
       }
@@ -236,7 +261,7 @@ void DownloadTools::SyncAndCheckDownloadTask(ToolInfo& tool, const fs::path& dir
 
 void DownloadTools::RegisterNewRepo(const std::string& repo) {
   ToolInfo new_tool(repo);
-  new_tool.release_future = AsyncDownloader::FetchAsString(new_tool.api_address);
+  new_tool.release_future = release_cache_.Fetch(new_tool.repo, new_tool.api_address);
   SyncAndExtractLinkFromRelease(new_tool);
   tools_.emplace_back(std::move(new_tool));
 }
@@ -282,6 +307,11 @@ int main(int argc, char** argv) {
     .add_arg({"-l", ks::arg::ArgType::BOOL, "List Supported Tools"})
     .add_arg({"--output", ks::arg::ArgType::STR, "OutPut Filename / Directory"})
     .add_arg({"-o", ks::arg::ArgType::STR, "OutPut Filename / Directory"})
+    .add_arg({"--offline", ks::arg::ArgType::BOOL, "Only Use Cached Release Info, Never Query GitHub"})
+    .add_arg({"--refresh", ks::arg::ArgType::BOOL, "Revalidate Cached Release Info Regardless Of Its Age"})
+    .add_arg({"--cache-ttl", ks::arg::ArgType::INT, "Seconds Cached Release Info Stays Fresh, Default 3600"})
+    .add_arg({"--jobs", ks::arg::ArgType::INT, "Max Concurrent Transfers, Default 8"})
+    .add_arg({"-j", ks::arg::ArgType::INT, "Max Concurrent Transfers, Default 8"})
     .add_arg({"--tool", ks::arg::ArgType::LIST,
               R""([default] tools to dowload. `moderntools <fd>` or `moderntools <sharkdp/bat>`)""});
 
@@ -292,13 +322,27 @@ int main(int argc, char** argv) {
     return 0;
   }
 
+  if (auto jobs = parser.get_value("-j").has_value() ? parser.get_value("-j") : parser.get_value("--jobs");
+      jobs.has_value()) {
+    AsyncDownloader::SetMaxConcurrency(std::get<int>(jobs.value()));  // NOLINT
+  }
+
+  HttpDiskCache release_cache(HttpDiskCache::DefaultDirectory("moderntools"));
+  if (auto ttl = parser.get_value("--cache-ttl"); ttl.has_value()) {
+    release_cache.SetTtl(std::chrono::seconds(std::get<int>(ttl.value())));  // NOLINT
+  }
+  if (parser.get_value("--refresh").has_value()) {
+    release_cache.SetTtl(std::chrono::seconds(0));
+  }
+  release_cache.SetOffline(parser.get_value("--offline").has_value());
+
   if (parser.get_value("-l").has_value() || parser.get_value("--list").has_value()) {
-    DownloadTools().ShowSupportedTools();
+    DownloadTools(release_cache).ShowSupportedTools();
     return 0;
   }
 
   if (parser.get_value("-c").has_value() || parser.get_value("--check-update").has_value()) {
-    DownloadTools().ShowLatestVersion();
+    DownloadTools(release_cache).ShowLatestVersion();
     return 0;
   }
 
@@ -309,7 +353,7 @@ int main(int argc, char** argv) {
     output_path = std::get<std::string>(parser.get_value("--output").value_or(fs::current_path().string()));
   }
 
-  auto downloader = DownloadTools();
+  auto downloader = DownloadTools(release_cache);
   auto tools = parser.get_value_with_default("--tool").value_or(std::vector<std::string>{});
   if (tools.empty()) {
     downloader.DownloadAll(output_path);